@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/CoM.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/velocity/VelocityLimits.h>
+#include <XBotInterface/ModelInterface.h>
+#include "BenchmarkStacks.h"
+
+/**
+ * Representative velocity stacks on the robot models of tests/robots:
+ *
+ *      (l_sole + r_sole) / com / (l_wrist + r_wrist) / postural << joint_limits << velocity_limits
+ *
+ * The model configurations of tests/configs are used, hence ROBOTOLOGY_ROOT has to be set as for the tests.
+ */
+
+namespace {
+
+const double DT = 0.001;
+
+struct RobotStack
+{
+    RobotStack(const std::string& robot)
+    {
+        model = XBot::ModelInterface::getModel(OpenSoT::benchmarks::getConfigPath(robot));
+
+        q.setZero(model->getJointNum());
+        model->setJointPosition(q);
+        model->update();
+
+        using namespace OpenSoT::tasks::velocity;
+        Cartesian::Ptr l_sole(new Cartesian("cartesian::l_sole", q, *model, "l_sole", "world"));
+        Cartesian::Ptr r_sole(new Cartesian("cartesian::r_sole", q, *model, "r_sole", "world"));
+        Cartesian::Ptr l_wrist(new Cartesian("cartesian::l_wrist", q, *model, "l_wrist", "Waist"));
+        Cartesian::Ptr r_wrist(new Cartesian("cartesian::r_wrist", q, *model, "r_wrist", "Waist"));
+        CoM::Ptr com(new CoM(q, *model));
+        Postural::Ptr postural(new Postural(q));
+
+        //the hands go up and down, so that the solution changes at each tick
+        Eigen::Affine3d T;
+        model->getPose("l_wrist", "Waist", T);
+        l_wrist_reference = T.matrix();
+        this->l_wrist = l_wrist;
+
+        Eigen::VectorXd q_min, q_max;
+        model->getJointLimits(q_min, q_max);
+        OpenSoT::constraints::velocity::JointLimits::Ptr joint_limits(
+                    new OpenSoT::constraints::velocity::JointLimits(q, q_max, q_min));
+        OpenSoT::constraints::velocity::VelocityLimits::Ptr velocity_limits(
+                    new OpenSoT::constraints::velocity::VelocityLimits(M_PI, DT, q.size()));
+
+        stack = ((l_sole + r_sole) / com / (l_wrist + r_wrist) / postural) << joint_limits << velocity_limits;
+        stack->update(q);
+
+        tick = 0;
+    }
+
+    /**
+     * @brief step integrates the solution and updates the model, it is not part of the measures
+     */
+    void step(const Eigen::VectorXd& dq)
+    {
+        Eigen::MatrixXd reference = l_wrist_reference;
+        reference(2,3) += 0.05*std::sin(2.*M_PI*DT*tick++);
+        l_wrist->setReference(reference);
+
+        q += dq;
+        model->setJointPosition(q);
+        model->update();
+    }
+
+    XBot::ModelInterface::Ptr model;
+    Eigen::VectorXd q;
+    OpenSoT::AutoStack::Ptr stack;
+    OpenSoT::tasks::velocity::Cartesian::Ptr l_wrist;
+    Eigen::MatrixXd l_wrist_reference;
+    unsigned long tick;
+};
+
+bool makeRobotStack(benchmark::State& state, const std::string& robot, boost::shared_ptr<RobotStack>& robot_stack)
+{
+    if(OpenSoT::benchmarks::getConfigPath(robot).empty())
+    {
+        state.SkipWithError("ROBOTOLOGY_ROOT is not set");
+        return false;
+    }
+
+    try{
+        robot_stack.reset(new RobotStack(robot));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return false;
+    }
+    state.counters["dofs"] = robot_stack->q.size();
+    return true;
+}
+
+void BM_AutoStack_update(benchmark::State& state, const std::string& robot)
+{
+    boost::shared_ptr<RobotStack> robot_stack;
+    if(!makeRobotStack(state, robot, robot_stack))
+        return;
+
+    Eigen::VectorXd dq = Eigen::VectorXd::Constant(robot_stack->q.size(), 1e-4);
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        robot_stack->step(dq);
+        state.ResumeTiming();
+
+        robot_stack->stack->update(robot_stack->q);
+    }
+}
+BENCHMARK_CAPTURE(BM_AutoStack_update, coman, std::string("coman"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AutoStack_update, bigman, std::string("bigman"))->Unit(benchmark::kMicrosecond);
+
+void BM_iHQP_solve(benchmark::State& state, const std::string& robot,
+                   const OpenSoT::solvers::solver_back_ends back_end)
+{
+    boost::shared_ptr<RobotStack> robot_stack;
+    if(!makeRobotStack(state, robot, robot_stack))
+        return;
+
+    OpenSoT::solvers::iHQP::Ptr solver;
+    try{
+        solver.reset(new OpenSoT::solvers::iHQP(robot_stack->stack->getStack(), robot_stack->stack->getBounds(),
+                                                DEFAULT_EPS_REGULARISATION, back_end));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    Eigen::VectorXd dq(robot_stack->q.size());
+    dq.setZero(dq.size());
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        robot_stack->step(dq);
+        robot_stack->stack->update(robot_stack->q);
+        state.ResumeTiming();
+
+        if(!solver->solve(dq))
+        {
+            state.SkipWithError("iHQP::solve failed");
+            break;
+        }
+    }
+}
+BENCHMARK_CAPTURE(BM_iHQP_solve, coman/qpOASES, std::string("coman"),
+                  OpenSoT::solvers::solver_back_ends::qpOASES)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_iHQP_solve, coman/OSQP, std::string("coman"),
+                  OpenSoT::solvers::solver_back_ends::OSQP)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_iHQP_solve, bigman/qpOASES, std::string("bigman"),
+                  OpenSoT::solvers::solver_back_ends::qpOASES)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_iHQP_solve, bigman/OSQP, std::string("bigman"),
+                  OpenSoT::solvers::solver_back_ends::OSQP)->Unit(benchmark::kMicrosecond);
+
+void BM_eHQP_solve(benchmark::State& state, const std::string& robot,
+                   const OpenSoT::solvers::eHQP::Decomposition decomposition)
+{
+    boost::shared_ptr<RobotStack> robot_stack;
+    if(!makeRobotStack(state, robot, robot_stack))
+        return;
+
+    //eHQP does not handle constraints
+    OpenSoT::solvers::eHQP solver(robot_stack->stack->getStack());
+    solver.setDecomposition(decomposition);
+
+    Eigen::VectorXd dq(robot_stack->q.size());
+    dq.setZero(dq.size());
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        robot_stack->step(dq);
+        robot_stack->stack->update(robot_stack->q);
+        state.ResumeTiming();
+
+        solver.solve(dq);
+    }
+}
+BENCHMARK_CAPTURE(BM_eHQP_solve, coman/SVD, std::string("coman"),
+                  OpenSoT::solvers::eHQP::SVD)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_eHQP_solve, coman/NullSpaceBasis, std::string("coman"),
+                  OpenSoT::solvers::eHQP::NULL_SPACE_BASIS)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_eHQP_solve, bigman/SVD, std::string("bigman"),
+                  OpenSoT::solvers::eHQP::SVD)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_eHQP_solve, bigman/NullSpaceBasis, std::string("bigman"),
+                  OpenSoT::solvers::eHQP::NULL_SPACE_BASIS)->Unit(benchmark::kMicrosecond);
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include <OpenSoT/constraints/velocity/SelfCollisionAvoidance.h>
+#include <OpenSoT/utils/collision_utils.h>
+#include <fcl/distance.h>
+#include <fcl/shape/geometric_shapes.h>
+#include <XBotInterface/ModelInterface.h>
+#include "BenchmarkStacks.h"
+
+/**
+ * SelfCollisionAvoidance::update on bigman (the capsule model of tests/robots is used), the
+ * arms move at each tick so that the distances are recomputed.
+ *
+ * ComputeLinksDistance::getLinkDistances on the bigman capsule model and on coman (meshes only, all
+ * the pairs are computed by fcl), and the capsule pairs distance computed in closed form or by fcl.
+ */
+
+namespace {
+
+const double DT = 0.001;
+
+void BM_SelfCollisionAvoidance_update(benchmark::State& state)
+{
+    std::string path_to_cfg = OpenSoT::benchmarks::getConfigPath("bigman", "config_bigman.yaml");
+    if(path_to_cfg.empty())
+    {
+        state.SkipWithError("ROBOTOLOGY_ROOT is not set");
+        return;
+    }
+
+    XBot::ModelInterface::Ptr model;
+    OpenSoT::constraints::velocity::SelfCollisionAvoidance::Ptr self_collision;
+    Eigen::VectorXd q;
+    try{
+        model = XBot::ModelInterface::getModel(path_to_cfg);
+
+        q.setZero(model->getJointNum());
+        model->setJointPosition(q);
+        model->update();
+
+        std::string base_link = "Waist";
+        self_collision.reset(new OpenSoT::constraints::velocity::SelfCollisionAvoidance(q, *model, base_link,
+                                 std::numeric_limits<double>::infinity(), 0.005));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.counters["dofs"] = q.size();
+
+    const int l_elbow = model->getDofIndex("LElbj");
+    const int r_elbow = model->getDofIndex("RElbj");
+    unsigned long tick = 0;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        q[l_elbow] = q[r_elbow] = -0.5 + 0.3*std::sin(2.*M_PI*DT*tick++);
+        model->setJointPosition(q);
+        model->update();
+        state.ResumeTiming();
+
+        self_collision->update(q);
+        benchmark::DoNotOptimize(self_collision->getAineq().data());
+    }
+}
+BENCHMARK(BM_SelfCollisionAvoidance_update)->Unit(benchmark::kMicrosecond);
+
+/**
+ * range(0): 0 bigman, 1 coman; range(1): 1 if the detection threshold is DETECTION_THRESHOLD, 0 if infinite
+ */
+const double DETECTION_THRESHOLD = 0.05;
+
+void BM_ComputeLinksDistance_getLinkDistances(benchmark::State& state)
+{
+    const std::string robot = state.range(0) == 0 ? "bigman" : "coman";
+    std::string path_to_cfg = OpenSoT::benchmarks::getConfigPath(robot, "config_" + robot + ".yaml");
+    if(path_to_cfg.empty())
+    {
+        state.SkipWithError("ROBOTOLOGY_ROOT is not set");
+        return;
+    }
+
+    XBot::ModelInterface::Ptr model;
+    boost::shared_ptr<ComputeLinksDistance> compute_distance;
+    Eigen::VectorXd q;
+    try{
+        model = XBot::ModelInterface::getModel(path_to_cfg);
+
+        q.setZero(model->getJointNum());
+        model->setJointPosition(q);
+        model->update();
+
+        compute_distance.reset(new ComputeLinksDistance(*model));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return;
+    }
+    const double detection_threshold = state.range(1) ? DETECTION_THRESHOLD :
+                                                        std::numeric_limits<double>::infinity();
+    state.counters["pairs"] = compute_distance->getLinkDistances().size();
+
+    const int l_elbow = model->getDofIndex("LElbj");
+    const int r_elbow = model->getDofIndex("RElbj");
+    unsigned long tick = 0;
+    std::list<LinkPairDistance> distances;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        q[l_elbow] = q[r_elbow] = -0.5 + 0.3*std::sin(2.*M_PI*DT*tick++);
+        model->setJointPosition(q);
+        model->update();
+        state.ResumeTiming();
+
+        distances = compute_distance->getLinkDistances(detection_threshold);
+        benchmark::DoNotOptimize(distances.size());
+    }
+    state.counters["distances"] = distances.size();
+}
+BENCHMARK(BM_ComputeLinksDistance_getLinkDistances)
+    ->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1})->Unit(benchmark::kMicrosecond);
+
+/**
+ * random capsule pairs with the size of the bigman links, range(0) of the benchmarks is the number of pairs
+ */
+void randomCapsulePairs(const unsigned int pairs, ComputeLinksDistance::CapsulePairs& capsule_pairs)
+{
+    std::srand(0);
+    capsule_pairs.resize(pairs);
+    capsule_pairs.ep1A.setRandom();
+    capsule_pairs.axisA.setRandom();
+    capsule_pairs.axisA *= 0.2;
+    capsule_pairs.ep1B.setRandom();
+    capsule_pairs.axisB.setRandom();
+    capsule_pairs.axisB *= 0.2;
+    capsule_pairs.radiusA.setConstant(0.05);
+    capsule_pairs.radiusB.setConstant(0.05);
+}
+
+void BM_CapsulePairs_computeDistances(benchmark::State& state)
+{
+    ComputeLinksDistance::CapsulePairs capsule_pairs;
+    randomCapsulePairs(state.range(0), capsule_pairs);
+
+    for(auto _ : state)
+    {
+        capsule_pairs.computeDistances();
+        benchmark::DoNotOptimize(capsule_pairs.distance.data());
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+BENCHMARK(BM_CapsulePairs_computeDistances)->Arg(64)->Arg(512);
+
+void BM_fcl_capsule_distance(benchmark::State& state)
+{
+    ComputeLinksDistance::CapsulePairs capsule_pairs;
+    randomCapsulePairs(state.range(0), capsule_pairs);
+
+    // fcl capsules are centered in their frame, with the axis along z
+    std::vector<boost::shared_ptr<fcl::CollisionObject> > objectsA, objectsB;
+    for(unsigned int k = 0; k < capsule_pairs.size(); ++k)
+    {
+        for(unsigned int i = 0; i < 2; ++i)
+        {
+            const Eigen::Vector3d ep1 = i == 0 ? capsule_pairs.ep1A.row(k) : capsule_pairs.ep1B.row(k);
+            const Eigen::Vector3d axis = i == 0 ? capsule_pairs.axisA.row(k) : capsule_pairs.axisB.row(k);
+            const Eigen::Vector3d center = ep1 + 0.5*axis;
+            const Eigen::Quaterniond q = Eigen::Quaterniond::FromTwoVectors(Eigen::Vector3d::UnitZ(), axis);
+
+            shared_ptr<fcl::CollisionGeometry> capsule(new fcl::Capsule(0.05, axis.norm()));
+            boost::shared_ptr<fcl::CollisionObject> object(new fcl::CollisionObject(capsule,
+                fcl::Transform3f(fcl::Quaternion3f(q.w(), q.x(), q.y(), q.z()),
+                                 fcl::Vec3f(center[0], center[1], center[2]))));
+            (i == 0 ? objectsA : objectsB).push_back(object);
+        }
+    }
+
+    fcl::DistanceRequest request;
+#if FCL_MINOR_VERSION > 2
+    request.gjk_solver_type = fcl::GST_INDEP;
+#endif
+    request.enable_nearest_points = true;
+    for(auto _ : state)
+    {
+        for(unsigned int k = 0; k < objectsA.size(); ++k)
+        {
+            fcl::DistanceResult result;
+            fcl::distance(objectsA[k].get(), objectsB[k].get(), request, result);
+            benchmark::DoNotOptimize(result.min_distance);
+        }
+    }
+    state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+BENCHMARK(BM_fcl_capsule_distance)->Arg(64)->Arg(512);
+
+}
+
+BENCHMARK_MAIN();
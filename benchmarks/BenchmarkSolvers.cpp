@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/constraints/Aggregated.h>
+#include "BenchmarkStacks.h"
+
+/**
+ * Scaling sweeps on stacks of random tasks (no robot model is needed): the variable has the size of
+ * a floating base humanoid, each task has 6 rows as a Cartesian task.
+ *
+ * Arguments: number of levels (the last one is a postural), number of tasks per level
+ */
+
+namespace {
+
+const unsigned int X_SIZE = 35;
+const unsigned int TASK_ROWS = 6;
+
+void scalingArguments(benchmark::internal::Benchmark* b)
+{
+    for(int levels : {2, 3, 4, 6})
+        for(int tasks : {1, 2, 4})
+            b->Args({levels, tasks});
+    b->ArgNames({"levels", "tasks"});
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void iHQPSolve(benchmark::State& state, const OpenSoT::solvers::solver_back_ends back_end)
+{
+    OpenSoT::benchmarks::RandomStack random_stack(state.range(0), state.range(1), TASK_ROWS, X_SIZE);
+
+    OpenSoT::solvers::iHQP::Ptr solver;
+    try{
+        solver.reset(new OpenSoT::solvers::iHQP(random_stack.stack, random_stack.bounds, DEFAULT_EPS_REGULARISATION, back_end));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    Eigen::VectorXd x(X_SIZE);
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        random_stack.perturb();
+        state.ResumeTiming();
+
+        if(!solver->solve(x))
+        {
+            state.SkipWithError("iHQP::solve failed");
+            break;
+        }
+    }
+}
+
+void BM_iHQP_solve_qpOASES(benchmark::State& state)
+{
+    iHQPSolve(state, OpenSoT::solvers::solver_back_ends::qpOASES);
+}
+BENCHMARK(BM_iHQP_solve_qpOASES)->Apply(scalingArguments);
+
+void BM_iHQP_solve_OSQP(benchmark::State& state)
+{
+    iHQPSolve(state, OpenSoT::solvers::solver_back_ends::OSQP);
+}
+BENCHMARK(BM_iHQP_solve_OSQP)->Apply(scalingArguments);
+
+void eHQPSolve(benchmark::State& state, const OpenSoT::solvers::eHQP::Decomposition decomposition,
+               const OpenSoT::solvers::eHQP::PinvStrategy pinv_strategy)
+{
+    OpenSoT::benchmarks::RandomStack random_stack(state.range(0), state.range(1), TASK_ROWS, X_SIZE);
+
+    OpenSoT::solvers::eHQP solver(random_stack.stack);
+    solver.setDecomposition(decomposition);
+    solver.setPinvStrategy(pinv_strategy);
+
+    Eigen::VectorXd x(X_SIZE);
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        random_stack.perturb();
+        state.ResumeTiming();
+
+        solver.solve(x);
+        benchmark::DoNotOptimize(x.data());
+    }
+}
+
+void BM_eHQP_solve_SVD(benchmark::State& state)
+{
+    eHQPSolve(state, OpenSoT::solvers::eHQP::SVD, OpenSoT::solvers::eHQP::PINV_SVD);
+}
+BENCHMARK(BM_eHQP_solve_SVD)->Apply(scalingArguments);
+
+void BM_eHQP_solve_SVD_LDLT(benchmark::State& state)
+{
+    eHQPSolve(state, OpenSoT::solvers::eHQP::SVD, OpenSoT::solvers::eHQP::PINV_LDLT);
+}
+BENCHMARK(BM_eHQP_solve_SVD_LDLT)->Apply(scalingArguments);
+
+void BM_eHQP_solve_NullSpaceBasis(benchmark::State& state)
+{
+    eHQPSolve(state, OpenSoT::solvers::eHQP::NULL_SPACE_BASIS, OpenSoT::solvers::eHQP::PINV_SVD);
+}
+BENCHMARK(BM_eHQP_solve_NullSpaceBasis)->Apply(scalingArguments);
+
+/**
+ * Arguments: number of aggregated constraints (half bounds, half TASK_ROWS rows constraints)
+ */
+void BM_Aggregated_generateAll(benchmark::State& state)
+{
+    std::srand(0);
+    std::list<OpenSoT::constraints::Aggregated::ConstraintPtr> constraints;
+    for(int i = 0; i < state.range(0); ++i)
+    {
+        if(i % 2 == 0)
+        {
+            Eigen::VectorXd ub(X_SIZE);
+            ub.setConstant(X_SIZE, 1. + i);
+            constraints.push_back(OpenSoT::constraints::GenericConstraint::Ptr(
+                new OpenSoT::constraints::GenericConstraint("bounds_"+std::to_string(i), ub, -ub, X_SIZE)));
+        }
+        else
+        {
+            Eigen::VectorXd uc(TASK_ROWS);
+            uc.setConstant(TASK_ROWS, 1.);
+            constraints.push_back(OpenSoT::constraints::GenericConstraint::Ptr(
+                new OpenSoT::constraints::GenericConstraint("constraint_"+std::to_string(i),
+                    OpenSoT::AffineHelper(Eigen::MatrixXd::Random(TASK_ROWS, X_SIZE), Eigen::VectorXd::Zero(TASK_ROWS)),
+                    uc, -uc, OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT)));
+        }
+    }
+
+    OpenSoT::constraints::Aggregated aggregated(constraints, X_SIZE);
+    for(auto _ : state)
+    {
+        aggregated.generateAll();
+        benchmark::DoNotOptimize(aggregated.getAineq().data());
+    }
+}
+BENCHMARK(BM_Aggregated_generateAll)->RangeMultiplier(2)->Range(2, 32)->ArgName("constraints");
+
+/**
+ * iHQP with a global constraint of TASK_ROWS bilateral rows and TASK_ROWS/2 equality rows (lA = uA),
+ * aggregated without doubling rows (NATIVE_BILATERAL) or as unilateral constraints (EQUALITIES_TO_INEQUALITIES).
+ * Deeper stacks are not used: the optimality constraints and the equalities would leave almost no freedom
+ * to the last level.
+ *
+ * Arguments: number of levels, 1 for NATIVE_BILATERAL and 0 for EQUALITIES_TO_INEQUALITIES
+ */
+void aggregationPolicyArguments(benchmark::internal::Benchmark* b)
+{
+    for(int levels : {2, 3, 4})
+        for(int native : {0, 1})
+            b->Args({levels, native});
+    b->ArgNames({"levels", "native"});
+    b->Unit(benchmark::kMicrosecond);
+}
+
+void BM_iHQP_aggregation_policy(benchmark::State& state)
+{
+    OpenSoT::benchmarks::RandomStack random_stack(state.range(0), 1, TASK_ROWS, X_SIZE);
+
+    std::list<OpenSoT::constraints::Aggregated::ConstraintPtr> constraints;
+    Eigen::VectorXd uc(TASK_ROWS);
+    uc.setConstant(TASK_ROWS, 0.1);
+    constraints.push_back(OpenSoT::constraints::GenericConstraint::Ptr(
+        new OpenSoT::constraints::GenericConstraint("bilateral",
+            OpenSoT::AffineHelper(Eigen::MatrixXd::Random(TASK_ROWS, X_SIZE), Eigen::VectorXd::Zero(TASK_ROWS)),
+            uc, -uc, OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT)));
+    uc.setZero(TASK_ROWS/2);
+    constraints.push_back(OpenSoT::constraints::GenericConstraint::Ptr(
+        new OpenSoT::constraints::GenericConstraint("equality",
+            OpenSoT::AffineHelper(Eigen::MatrixXd::Random(TASK_ROWS/2, X_SIZE), Eigen::VectorXd::Zero(TASK_ROWS/2)),
+            uc, uc, OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT)));
+
+    OpenSoT::constraints::Aggregated::Ptr global_constraints(new OpenSoT::constraints::Aggregated(constraints, X_SIZE,
+        state.range(1) ? OpenSoT::constraints::Aggregated::NATIVE_BILATERAL :
+                         OpenSoT::constraints::Aggregated::EQUALITIES_TO_INEQUALITIES));
+
+    OpenSoT::solvers::iHQP::Ptr solver;
+    try{
+        solver.reset(new OpenSoT::solvers::iHQP(random_stack.stack, random_stack.bounds, global_constraints));
+    }
+    catch(std::exception& e){
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    Eigen::VectorXd x(X_SIZE);
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        random_stack.perturb();
+        global_constraints->generateAll();
+        state.ResumeTiming();
+
+        if(!solver->solve(x))
+        {
+            state.SkipWithError("iHQP::solve failed");
+            break;
+        }
+    }
+
+    OpenSoT::solvers::BackEnd::Ptr back_end;
+    if(solver->getBackEnd(0, back_end))
+        state.counters["constraints_rows"] = back_end->getNumConstraints();
+}
+BENCHMARK(BM_iHQP_aggregation_policy)->Apply(aggregationPolicyArguments);
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _OPENSOT_BENCHMARKS_BENCHMARK_STACKS_H_
+#define _OPENSOT_BENCHMARKS_BENCHMARK_STACKS_H_
+
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+
+namespace OpenSoT { namespace benchmarks {
+
+    /**
+     * @brief getConfigPath returns the XBot configuration of one of the robots in tests/configs,
+     * the same convention of the tests is used (the repository is in $ROBOTOLOGY_ROOT/external/OpenSoT)
+     * @param robot "coman" or "bigman"
+     * @param config name of the configuration file, config_<robot>_RBDL.yaml if empty
+     * @return the path, empty if ROBOTOLOGY_ROOT is not set
+     */
+    inline std::string getConfigPath(const std::string& robot, const std::string& config = "")
+    {
+        const char* robotology_root = std::getenv("ROBOTOLOGY_ROOT");
+        if(!robotology_root)
+            return "";
+        return std::string(robotology_root) + "/external/OpenSoT/tests/configs/" + robot + "/configs/" +
+                (config.empty() ? "config_" + robot + "_RBDL.yaml" : config);
+    }
+
+    /**
+     * @brief The RandomStack struct is a stack of GenericTask with random matrices: each level
+     * aggregates tasks_per_level tasks of task_rows rows (see OpenSoT::tasks::Aggregated), the
+     * last level is a regularization on the whole variable. The variable is bounded by bounds.
+     */
+    struct RandomStack
+    {
+        RandomStack(const unsigned int levels, const unsigned int tasks_per_level,
+                    const unsigned int task_rows, const unsigned int x_size):
+            x_size(x_size)
+        {
+            std::srand(0);
+            for(unsigned int i = 0; i + 1 < levels; ++i)
+            {
+                std::list<OpenSoT::tasks::Aggregated::TaskPtr> level;
+                for(unsigned int j = 0; j < tasks_per_level; ++j)
+                {
+                    OpenSoT::tasks::GenericTask::Ptr task(
+                                new OpenSoT::tasks::GenericTask("task_"+std::to_string(i)+"_"+std::to_string(j),
+                                    Eigen::MatrixXd::Random(task_rows, x_size), Eigen::VectorXd::Random(task_rows)));
+                    tasks.push_back(task);
+                    level.push_back(task);
+                }
+                stack.push_back(OpenSoT::tasks::Aggregated::Ptr(
+                                    new OpenSoT::tasks::Aggregated(level, Eigen::VectorXd::Zero(x_size))));
+            }
+
+            OpenSoT::tasks::GenericTask::Ptr postural(
+                        new OpenSoT::tasks::GenericTask("postural", Eigen::MatrixXd::Identity(x_size, x_size),
+                                                        Eigen::VectorXd::Zero(x_size)));
+            postural->update(Eigen::VectorXd::Zero(x_size));
+            stack.push_back(postural);
+
+            Eigen::VectorXd ub(x_size);
+            ub.setConstant(x_size, 0.3);
+            bounds.reset(new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+        }
+
+        /**
+         * @brief perturb changes the references of the tasks and updates the stack, as a control loop does
+         */
+        void perturb()
+        {
+            for(unsigned int i = 0; i < tasks.size(); ++i)
+            {
+                Eigen::VectorXd b = tasks[i]->getb();
+                b.array() += 1e-3;
+                tasks[i]->setb(b);
+            }
+            for(unsigned int i = 0; i < stack.size(); ++i)
+                stack[i]->update(Eigen::VectorXd::Zero(x_size));
+        }
+
+        unsigned int x_size;
+        std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+        OpenSoT::solvers::iHQP::Stack stack;
+        OpenSoT::constraints::GenericConstraint::Ptr bounds;
+    };
+
+} }
+
+#endif
@@ -467,17 +467,25 @@ class SymDenseMat : public DenseMatrix, public SymmetricMatrix
 {
 	public:
 		/** Default constructor. */
-		SymDenseMat() : DenseMatrix() { };
+		SymDenseMat() : DenseMatrix(), bilinearWorkspace(0), sizeBilinearWorkspace(0) { };
 
 		/** Constructor from vector of values. */
 		SymDenseMat(	int m,			/**< Number of rows. */
 						int n,			/**< Number of columns. */
 						int lD,			/**< Leading dimension. */
 						real_t *v		/**< Values. */
-						) : DenseMatrix(m, n, lD, v) { };
+						) : DenseMatrix(m, n, lD, v), bilinearWorkspace(0), sizeBilinearWorkspace(0) { };
+
+		/** Copy constructor, the temporary of bilinear is not shared. */
+		SymDenseMat(	const SymDenseMat& rhs	/**< Rhs object. */
+						) : DenseMatrix(rhs), bilinearWorkspace(0), sizeBilinearWorkspace(0) { };
+
+		/** Assignment operator, the temporary of bilinear is not shared. */
+		SymDenseMat& operator=(	const SymDenseMat& rhs	/**< Rhs object. */
+								) { DenseMatrix::operator=(rhs); return *this; };
 
 		/** Destructor. */
-		virtual ~SymDenseMat() { };
+		virtual ~SymDenseMat() { delete[] bilinearWorkspace; };
 
 		/** Returns a deep-copy of the Matrix object.
 		 *	\return Deep-copy of Matrix object */
@@ -497,6 +505,11 @@ class SymDenseMat : public DenseMatrix, public SymmetricMatrix
 										real_t *y,						/**< Output vector of results (compressed). */
 										int yLD							/**< Leading dimension of output y. */
 										) const;
+
+	protected:
+		mutable real_t *bilinearWorkspace;		/**< Temporary of bilinear, kept between the calls so that the \n
+												 *	 projected Hessian is computed without allocating memory. */
+		mutable int sizeBilinearWorkspace;		/**< Number of elements of the temporary of bilinear. */
 };
 
 
@@ -423,6 +423,17 @@ class QProblem : public QProblemB
 		returnValue copy(	const QProblem& rhs	/**< Rhs object. */
 							);
 
+		/** Takes an array from the scratch memory, as from a stack. The array is
+		 *  allocated only if the scratch memory is exhausted.
+		 *  \return Pointer to the array. */
+		real_t* getTemporary(	int n		/**< Number of elements. */
+								);
+
+		/** Releases an array returned by getTemporary( ), the arrays taken
+		 *  from the scratch memory after it are released too. */
+		void releaseTemporary(	real_t* const p		/**< Array to be released. */
+								);
+
 		/** Solves a QProblem whose QP data is assumed to be stored in the member variables.
 		 *  A guess for its primal/dual optimal solution vectors and the corresponding
 		 *  working sets of bounds and constraints can be provided.
@@ -1048,6 +1059,11 @@ class QProblem : public QProblemB
 		real_t* delta_xFRy;						/**< Temporary for determineStepDirection. */
 		real_t* delta_xFRz;						/**< Temporary for determineStepDirection. */
 		real_t* delta_yAC_TMP;					/**< Temporary for determineStepDirection. */
+
+		real_t* workspace;						/**< Scratch memory of the temporaries of the homotopy, it is allocated once \n
+												 *	 so that hotstart does not allocate memory (see getTemporary( )). */
+		int sizeWorkspace;						/**< Number of elements of the scratch memory. */
+		int usedWorkspace;						/**< Number of elements of the scratch memory in use. */
 };
 
 
@@ -342,7 +342,10 @@ class SQProblem : public QProblem
 	 *	PROTECTED MEMBER VARIABLES
 	 */
 	protected:
-
+		Bounds oldBounds;						/**< Copy of the working set of the bounds made by setupNewAuxiliaryQP \n
+												 *	 (a member so that its memory is allocated only once). */
+		Constraints oldConstraints;				/**< Copy of the working set of the constraints made by setupNewAuxiliaryQP \n
+												 *	 (a member so that its memory is allocated only once). */
 };
 
 
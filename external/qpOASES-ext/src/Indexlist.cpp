@@ -91,10 +91,24 @@ Indexlist::~Indexlist( )
  */
 Indexlist& Indexlist::operator=( const Indexlist& rhs )
 {
+	int i;
+
 	if ( this != &rhs )
 	{
-		clear( );
-		copy( rhs );
+		/* lists of the same size are copied without allocating memory */
+		if ( ( number != 0 ) && ( rhs.number != 0 ) && ( physicallength == rhs.physicallength ) )
+		{
+			length = rhs.length;
+			for( i=0; i<physicallength; ++i )
+				number[i] = rhs.number[i];
+			for( i=0; i<physicallength; ++i )
+				iSort[i] = rhs.iSort[i];
+		}
+		else
+		{
+			clear( );
+			copy( rhs );
+		}
 	}
 
 	return *this;
@@ -111,9 +125,14 @@ returnValue Indexlist::init(	int n
 	if ( n < 0 )
 		return THROWERROR( RET_INVALID_ARGUMENTS );
 
+	length = 0;
+
+	/* the memory of a list of the same size is kept */
+	if ( ( number != 0 ) && ( physicallength == n ) )
+		return SUCCESSFUL_RETURN;
+
 	clear( );
 
-	length = 0;
 	physicallength = n;
 
 	if ( n > 0 )
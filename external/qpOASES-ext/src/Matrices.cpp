@@ -490,7 +490,15 @@ returnValue SymDenseMat::bilinear(	const Indexlist* const icols,
 		for (jj = 0; jj < xN; jj++)
 			y[ii*yLD+jj] = 0.0;
 
-	real_t *Ax = new real_t[icols->length * xN];
+	/* the temporary is allocated with the largest size it can take (free
+	 * variables times null space dimension) and it is kept for the next calls */
+	if ( icols->length * xN > sizeBilinearWorkspace )
+	{
+		delete[] bilinearWorkspace;
+		sizeBilinearWorkspace = getMax( icols->length * xN, nRows*nCols );
+		bilinearWorkspace = new real_t[sizeBilinearWorkspace];
+	}
+	real_t *Ax = bilinearWorkspace;
 
 	for (i=0;i<icols->length * xN;++i)
 		Ax[i]=0.0;
@@ -514,7 +522,6 @@ returnValue SymDenseMat::bilinear(	const Indexlist* const icols,
 			}
 		}
 	}
-	delete[] Ax;
 
 	return SUCCESSFUL_RETURN;
 }
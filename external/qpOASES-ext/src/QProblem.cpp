@@ -71,6 +71,10 @@ QProblem::QProblem( ) : QProblemB( )
 	delta_xFRz = 0;
 	tempB = 0;
 	delta_yAC_TMP = 0;
+
+	workspace = 0;
+	sizeWorkspace = 0;
+	usedWorkspace = 0;
 }
 
 
@@ -158,6 +162,12 @@ QProblem::QProblem( int _nV, int _nC, HessianType _hessianType ) : QProblemB( _n
 		delta_yAC_TMP = 0;
 	}
 
+	/* the nested temporaries of hotstart, solveQP, performStep and of the
+	 * working set changes take less than 16 arrays of size nV+nC */
+	sizeWorkspace = 16*(_nV+_nC) + 16;
+	workspace = new real_t[sizeWorkspace];
+	usedWorkspace = 0;
+
 	flipper.init( (unsigned int)_nV,(unsigned int)_nC );
 }
 
@@ -505,10 +515,10 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 	}
 	else
 	{
-		real_t *ub_new_far = new real_t[nV];
-		real_t *lb_new_far = new real_t[nV];
-		real_t *ubA_new_far = new real_t[nC];
-		real_t *lbA_new_far = new real_t[nC];
+		real_t *ub_new_far = getTemporary( nV );
+		real_t *lb_new_far = getTemporary( nV );
+		real_t *ubA_new_far = getTemporary( nC );
+		real_t *lbA_new_far = getTemporary( nC );
 
 		/* possibly extend initial far bounds to largest bound/constraint data */
 		if (ub_new)
@@ -617,8 +627,8 @@ returnValue QProblem::hotstart(	const real_t* const g_new,
 			/* add time to setup auxiliary QP */
 			if ( cputime != 0 )
 				*cputime = cputime_needed + auxTime;
-			delete[] lbA_new_far; delete[] ubA_new_far;
-			delete[] lb_new_far; delete[] ub_new_far;
+			releaseTemporary( lbA_new_far ); releaseTemporary( ubA_new_far );
+			releaseTemporary( lb_new_far ); releaseTemporary( ub_new_far );
 	}
 
 	return ( returnvalue != SUCCESSFUL_RETURN ) ? THROWERROR( returnvalue ) : returnvalue;
@@ -1134,6 +1144,14 @@ returnValue QProblem::clear( )
 		delta_yAC_TMP = 0;
 	}
 
+	if ( workspace != 0 )
+	{
+		delete[] workspace;
+		workspace = 0;
+	}
+	sizeWorkspace = 0;
+	usedWorkspace = 0;
+
 	return SUCCESSFUL_RETURN;
 }
 
@@ -1251,10 +1269,51 @@ returnValue QProblem::copy(	const QProblem& rhs
 		delta_yAC_TMP = 0;
 	}
 
+	sizeWorkspace = rhs.sizeWorkspace;
+	workspace = ( sizeWorkspace > 0 ) ? new real_t[sizeWorkspace] : 0;
+	usedWorkspace = 0;
+
 	return SUCCESSFUL_RETURN;
 }
 
 
+/*
+ *	g e t T e m p o r a r y
+ */
+real_t* QProblem::getTemporary(	int n
+								)
+{
+	if ( n < 0 )
+		n = 0;
+
+	if ( ( workspace != 0 ) && ( usedWorkspace + n <= sizeWorkspace ) )
+	{
+		real_t* p = &( workspace[usedWorkspace] );
+		usedWorkspace += n;
+		return p;
+	}
+
+	return new real_t[n];
+}
+
+
+/*
+ *	r e l e a s e T e m p o r a r y
+ */
+void QProblem::releaseTemporary(	real_t* const p
+									)
+{
+	if ( ( workspace != 0 ) && ( p >= workspace ) && ( p <= &( workspace[sizeWorkspace] ) ) )
+	{
+		/* the arrays are released as from a stack, whatever the order of the calls */
+		if ( (int)( p - workspace ) < usedWorkspace )
+			usedWorkspace = (int)( p - workspace );
+	}
+	else
+		delete[] p;
+}
+
+
 
 /*
  *	s o l v e I n i t i a l Q P
@@ -1465,16 +1524,16 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 	/* I) PREPARATIONS */
 	/* 1) Allocate delta vectors of gradient and (constraints') bounds,
 	 *    index arrays and step direction arrays. */
-	real_t* delta_xFR = new real_t[nV];
-	real_t* delta_xFX = new real_t[nV];
-	real_t* delta_yAC = new real_t[nC];
-	real_t* delta_yFX = new real_t[nV];
+	real_t* delta_xFR = getTemporary( nV );
+	real_t* delta_xFX = getTemporary( nV );
+	real_t* delta_yAC = getTemporary( nC );
+	real_t* delta_yFX = getTemporary( nV );
 
-	real_t* delta_g   = new real_t[nV];
-	real_t* delta_lb  = new real_t[nV];
-	real_t* delta_ub  = new real_t[nV];
-	real_t* delta_lbA = new real_t[nC];
-	real_t* delta_ubA = new real_t[nC];
+	real_t* delta_g   = getTemporary( nV );
+	real_t* delta_lb  = getTemporary( nV );
+	real_t* delta_ub  = getTemporary( nV );
+	real_t* delta_lbA = getTemporary( nC );
+	real_t* delta_ubA = getTemporary( nC );
 
 	BooleanType Delta_bC_isZero, Delta_bB_isZero;
 
@@ -1535,8 +1594,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 											);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+			releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+			releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
@@ -1554,8 +1613,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 												);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+			releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+			releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
@@ -1574,8 +1633,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 									);
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+			releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+			releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
@@ -1604,8 +1663,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 			if ( cputime != 0 )
 				*cputime = getCPUtime( ) - starttime;
 
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+			releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+			releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 			return SUCCESSFUL_RETURN;
 		}
@@ -1614,8 +1673,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 		returnvalue = changeActiveSet( BC_idx,BC_status,BC_isBound );
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-			delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+			releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+			releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 			/* Assign number of working set recalculations and stop runtime measurement. */
 			nWSR = iter;
@@ -1644,8 +1703,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 			returnvalue = computeProjectedCholesky( );
 			if (returnvalue != SUCCESSFUL_RETURN)
 			{
-				delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-				delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+				releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+				releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 				return returnvalue;
 			}
 		}
@@ -1667,8 +1726,8 @@ returnValue QProblem::solveQP(	const real_t* const g_new,
 		}
 	}
 
-	delete[] delta_yAC; delete[] delta_yFX; delete[] delta_xFX; delete[] delta_xFR;
-	delete[] delta_ub; delete[] delta_lb; delete[] delta_ubA; delete[] delta_lbA; delete[] delta_g;
+	releaseTemporary( delta_yAC ); releaseTemporary( delta_yFX ); releaseTemporary( delta_xFX ); releaseTemporary( delta_xFR );
+	releaseTemporary( delta_ub ); releaseTemporary( delta_lb ); releaseTemporary( delta_ubA ); releaseTemporary( delta_lbA ); releaseTemporary( delta_g );
 
 	/* stop runtime measurement */
 	if ( cputime != 0 )
@@ -1748,7 +1807,7 @@ returnValue QProblem::solveRegularisedQP(	const real_t* const g_new,
 
 
 	/* II) PERFORM SUCCESSIVE REGULARISATION STEPS */
-	real_t* gMod = new real_t[nV];
+	real_t* gMod = getTemporary( nV );
 
 	for( step=0; step<options.numRegularisationSteps; ++step )
 	{
@@ -1778,7 +1837,7 @@ returnValue QProblem::solveRegularisedQP(	const real_t* const g_new,
 		/* Only continue if QP solution has been successful. */
 		if ( returnvalue != SUCCESSFUL_RETURN )
 		{
-			delete[] gMod;
+			releaseTemporary( gMod );
 
 			if ( cputime != 0 )
 				*cputime = cputime_total;
@@ -1793,7 +1852,7 @@ returnValue QProblem::solveRegularisedQP(	const real_t* const g_new,
 	for( i=0; i<nV; ++i )
 		g[i] = g_new[i];
 
-	delete[] gMod;
+	releaseTemporary( gMod );
 
 	if ( cputime != 0 )
 		*cputime = cputime_total;
@@ -2745,8 +2804,8 @@ returnValue QProblem::addConstraint(	int number, SubjectToStatus C_status,
 	int* FR_idx;
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
-	real_t* aFR = new real_t[nFR];
-	real_t* wZ = new real_t[nZ];
+	real_t* aFR = getTemporary( nFR );
+	real_t* wZ = getTemporary( nZ );
 	for( i=0; i<nZ; ++i )
 		wZ[i] = 0.0;
 
@@ -2776,7 +2835,7 @@ returnValue QProblem::addConstraint(	int number, SubjectToStatus C_status,
 		}
 	}
 
-	delete[] aFR;
+	releaseTemporary( aFR );
 
 
 	real_t c, s, nu;
@@ -2827,7 +2886,7 @@ returnValue QProblem::addConstraint(	int number, SubjectToStatus C_status,
 		}
 	}
 
-	delete[] wZ;
+	releaseTemporary( wZ );
 
 
 	/* IV) UPDATE INDICES */
@@ -2870,18 +2929,18 @@ returnValue QProblem::addConstraint_checkLI( int number )
 
 		int *FX_idx, *AC_idx, *IAC_idx;
 
-		real_t *delta_g   = new real_t[nV];
-		real_t *delta_xFX = new real_t[nFX];
-		real_t *delta_xFR = new real_t[nFR];
-		real_t *delta_yAC = new real_t[nAC];
-		real_t *delta_yFX = new real_t[nFX];
+		real_t *delta_g   = getTemporary( nV );
+		real_t *delta_xFX = getTemporary( nFX );
+		real_t *delta_xFR = getTemporary( nFR );
+		real_t *delta_yAC = getTemporary( nAC );
+		real_t *delta_yFX = getTemporary( nFX );
 
 		bounds.getFixed( )->getNumberArray( &FX_idx );
 		constraints.getActive( )->getNumberArray( &AC_idx );
 		constraints.getInactive( )->getNumberArray( &IAC_idx );
 
 		int dim = (nC>nV)?nC:nV;
-		real_t *nul = new real_t[dim];
+		real_t *nul = getTemporary( dim );
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 
@@ -2891,7 +2950,7 @@ returnValue QProblem::addConstraint_checkLI( int number )
 											  nul, nul, nul, nul,
 											  BT_FALSE, BT_FALSE,
 											  delta_xFX, delta_xFR, delta_yAC, delta_yFX);
-		delete[] nul;
+		releaseTemporary( nul );
 
 		/* compute the weight in inf-norm */
 		real_t weight = 0.0;
@@ -2923,11 +2982,11 @@ returnValue QProblem::addConstraint_checkLI( int number )
 		if (zero > options.epsLITests * weight)
 			returnvalue = RET_LINEARLY_INDEPENDENT;
 
-		delete[] delta_yFX;
-		delete[] delta_yAC;
-		delete[] delta_xFR;
-		delete[] delta_xFX;
-		delete[] delta_g;
+		releaseTemporary( delta_yFX );
+		releaseTemporary( delta_yAC );
+		releaseTemporary( delta_xFR );
+		releaseTemporary( delta_xFX );
+		releaseTemporary( delta_g );
 
 	}
 	else
@@ -2938,7 +2997,7 @@ returnValue QProblem::addConstraint_checkLI( int number )
 		 * space of Afr).
 		 */
 
-		real_t *Arow = new real_t[nFR];
+		real_t *Arow = getTemporary( nFR );
 		A->getRow(number, bounds.getFree(), 1.0, Arow);
 
 		real_t sum, l2;
@@ -2964,7 +3023,7 @@ returnValue QProblem::addConstraint_checkLI( int number )
 			}
 		}
 
-		delete[] Arow;
+		releaseTemporary( Arow );
 	}
 
 	return THROWINFO( returnvalue );
@@ -3005,11 +3064,11 @@ returnValue QProblem::addConstraint_ensureLI( int number, SubjectToStatus C_stat
 	int* FX_idx;
 	bounds.getFixed( )->getNumberArray( &FX_idx );
 
-	real_t* xiC = new real_t[nAC];
-	real_t* xiC_TMP = new real_t[nAC];
-	real_t* xiB = new real_t[nFX];
-	real_t* Arow = new real_t[nFR];
-	real_t* num = new real_t[nV];
+	real_t* xiC = getTemporary( nAC );
+	real_t* xiC_TMP = getTemporary( nAC );
+	real_t* xiB = getTemporary( nFX );
+	real_t* Arow = getTemporary( nFR );
+	real_t* num = getTemporary( nV );
 
 	returnValue returnvalue = SUCCESSFUL_RETURN;
 
@@ -3148,11 +3207,11 @@ returnValue QProblem::addConstraint_ensureLI( int number, SubjectToStatus C_stat
 	}
 
 farewell:
-	delete[] num;
-	delete[] Arow;
-	delete[] xiB;
-	delete[] xiC_TMP;
-	delete[] xiC;
+	releaseTemporary( num );
+	releaseTemporary( Arow );
+	releaseTemporary( xiB );
+	releaseTemporary( xiC_TMP );
+	releaseTemporary( xiC );
 
 	getGlobalMessageHandler( )->throwInfo( RET_LI_RESOLVED,0,__FUNCTION__,__FILE__,__LINE__,VS_VISIBLE );
 
@@ -3237,7 +3296,7 @@ returnValue QProblem::addBound(	int number, SubjectToStatus B_status,
 	int* FR_idx;
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
-	real_t* w = new real_t[nFR];
+	real_t* w = getTemporary( nFR );
 
 
 	/* III) ADD NEW ACTIVE BOUND TO TOP OF MATRIX T: */
@@ -3273,7 +3332,7 @@ returnValue QProblem::addBound(	int number, SubjectToStatus B_status,
 	if ( nAC > 0 )	  /* ( nAC == 0 ) <=> ( nZ == nFR ) <=> Y and T are empty => nothing to do */
 	{
 		/* store new column a in a temporary vector instead of shifting T one column to the left */
-		real_t* tmp = new real_t[nAC];
+		real_t* tmp = getTemporary( nAC );
 		for( i=0; i<nAC; ++i )
 			tmp[i] = 0.0;
 
@@ -3307,10 +3366,10 @@ returnValue QProblem::addBound(	int number, SubjectToStatus B_status,
 				applyGivens( c,s,nu,TT(i,1+tcol-nZ+j),tmp[i], tmp[i],TT(i,1+tcol-nZ+j) );
 		}
 
-		delete[] tmp;
+		releaseTemporary( tmp );
 	}
 
-	delete[] w;
+	releaseTemporary( w );
 
 
 	if ( ( updateCholesky == BT_TRUE ) &&
@@ -3368,18 +3427,18 @@ returnValue QProblem::addBound_checkLI( int number )
 		 * "zero". We then check linear independence relative to this estimate.
 		 */
 
-		real_t *delta_g   = new real_t[nV];
-		real_t *delta_xFX = new real_t[nFX];
-		real_t *delta_xFR = new real_t[nFR];
-		real_t *delta_yAC = new real_t[nAC];
-		real_t *delta_yFX = new real_t[nFX];
+		real_t *delta_g   = getTemporary( nV );
+		real_t *delta_xFX = getTemporary( nFX );
+		real_t *delta_xFR = getTemporary( nFR );
+		real_t *delta_yAC = getTemporary( nAC );
+		real_t *delta_yFX = getTemporary( nFX );
 
 		for (ii = 0; ii < nV; ++ii)
 			delta_g[ii] = 0.0;
 		delta_g[number] = 1.0;	/* sign doesn't matter here */
 
 		int dim = (nC>nV)?nC:nV;
-		real_t *nul = new real_t[dim];
+		real_t *nul = getTemporary( dim );
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 
@@ -3419,12 +3478,12 @@ returnValue QProblem::addBound_checkLI( int number )
 		if (zero > options.epsLITests * weight)
 			returnvalue = RET_LINEARLY_INDEPENDENT;
 
-		delete[] nul;
-		delete[] delta_yFX;
-		delete[] delta_yAC;
-		delete[] delta_xFR;
-		delete[] delta_xFX;
-		delete[] delta_g;
+		releaseTemporary( nul );
+		releaseTemporary( delta_yFX );
+		releaseTemporary( delta_yAC );
+		releaseTemporary( delta_xFR );
+		releaseTemporary( delta_xFX );
+		releaseTemporary( delta_g );
 
 	}
 	else
@@ -3486,10 +3545,10 @@ returnValue QProblem::addBound_ensureLI( int number, SubjectToStatus B_status )
 	int* AC_idx;
 	constraints.getActive( )->getNumberArray( &AC_idx );
 
-	real_t* xiC = new real_t[nAC];
-	real_t* xiC_TMP = new real_t[nAC];
-	real_t* xiB = new real_t[nFX];
-	real_t* num = new real_t[nV];
+	real_t* xiC = getTemporary( nAC );
+	real_t* xiC_TMP = getTemporary( nAC );
+	real_t* xiB = getTemporary( nFX );
+	real_t* num = getTemporary( nV );
 
 	real_t y_min = options.maxDualJump;
 	int y_min_number = -1;
@@ -3624,10 +3683,10 @@ returnValue QProblem::addBound_ensureLI( int number, SubjectToStatus B_status )
 	}
 
 farewell:
-	delete[] num;
-	delete[] xiB;
-	delete[] xiC_TMP;
-	delete[] xiC;
+	releaseTemporary( num );
+	releaseTemporary( xiB );
+	releaseTemporary( xiC_TMP );
+	releaseTemporary( xiC );
 
 	getGlobalMessageHandler( )->throwInfo( RET_LI_RESOLVED,0,__FUNCTION__,__FILE__,__LINE__,VS_VISIBLE );
 
@@ -3744,8 +3803,8 @@ returnValue QProblem::removeConstraint(	int number,
 		/* III) UPDATE CHOLESKY DECOMPOSITION,
 		 *      calculate new additional column (i.e. [r sqrt(rho2)]')
 		 *      of the Cholesky factor R. */
-		real_t* Hz = new real_t[nFR];
-		real_t* z = new real_t[nFR];
+		real_t* Hz = getTemporary( nFR );
+		real_t* z = getTemporary( nFR );
 		real_t rho2 = 0.0;
 
 		/* 1) Calculate Hz = H*z, where z is the new rightmost column of Z
@@ -3753,14 +3812,14 @@ returnValue QProblem::removeConstraint(	int number,
 		for( j=0; j<nFR; ++j )
 			z[j] = QQ(FR_idx[j],nZ);
 		H->times(bounds.getFree(), bounds.getFree(), 1, 1.0, z, nFR, 0.0, Hz, nFR);
-		delete[] z;
+		releaseTemporary( z );
 
 		if ( nZ > 0 )
 		{
-			real_t* ZHz = new real_t[nZ];
+			real_t* ZHz = getTemporary( nZ );
 			for ( i=0; i<nZ; ++i )
 				ZHz[i] = 0.0;
-			real_t* r = new real_t[nZ];
+			real_t* r = getTemporary( nZ );
 
 			/* 2) Calculate ZHz = Z'*Hz (old Z). */
 			for( j=0; j<nFR; ++j )
@@ -3774,7 +3833,7 @@ returnValue QProblem::removeConstraint(	int number,
 			/* 3) Calculate r = R^-T * ZHz. */
 			if ( backsolveR( ZHz,BT_TRUE,r ) != SUCCESSFUL_RETURN )
 			{
-				delete[] Hz; delete[] r; delete[] ZHz;
+				releaseTemporary( Hz ); releaseTemporary( r ); releaseTemporary( ZHz );
 				return THROWERROR( RET_REMOVECONSTRAINT_FAILED );
 			}
 
@@ -3786,14 +3845,14 @@ returnValue QProblem::removeConstraint(	int number,
 				RR(i,nZ) = r[i];
 			}
 
-			delete[] r; delete[] ZHz;
+			releaseTemporary( r ); releaseTemporary( ZHz );
 		}
 
 		/* 5) Store rho into R. */
 		for( j=0; j<nFR; ++j )
 			rho2 += QQ(FR_idx[j],nZ) * Hz[j];
 
-		delete[] Hz;
+		releaseTemporary( Hz );
 
 		if ( ( options.enableFlippingBounds == BT_TRUE ) && ( allowFlipping == BT_TRUE ) && ( exchangeHappened == BT_FALSE ) )
 		{
@@ -3946,7 +4005,7 @@ returnValue QProblem::removeBound(	int number,
 		int* AC_idx;
 		constraints.getActive( )->getNumberArray( &AC_idx );
 
-		real_t* tmp = new real_t[nAC];
+		real_t* tmp = getTemporary( nAC );
 		A->getCol(number, constraints.getActive(), 1.0, tmp);
 
 
@@ -3971,7 +4030,7 @@ returnValue QProblem::removeBound(	int number,
 			}
 		}
 
-		delete[] tmp;
+		releaseTemporary( tmp );
 	}
 
 
@@ -3987,8 +4046,8 @@ returnValue QProblem::removeBound(	int number,
 		if ( nFR > 0 )
 		{
 			/* Attention: Index list of free variables has already grown by one! */
-			real_t* Hz = new real_t[nFR+1];
-			real_t* z = new real_t[nFR+1];
+			real_t* Hz = getTemporary( nFR+1 );
+			real_t* z = getTemporary( nFR+1 );
 			/* 1) Calculate R'*r = Zfr'*Hfr*z1 + z2*Zfr'*h1 =: Zfr'*Hz + z2*Zfr'*h1 =: rhs and
 			 *    rho2 = z1'*Hfr*z1 + 2*z2*h1'*z1 + h2*z2^2 - r'*r =: z1'*Hz + 2*z2*h1'*z1 + h2*z2^2 - r'r */
 			for( j=0; j<nFR; ++j )
@@ -4000,8 +4059,8 @@ returnValue QProblem::removeBound(	int number,
 			
 			if ( nZ > 0 )
 			{
-				real_t* r = new real_t[nZ];
-				real_t* rhs = new real_t[nZ];
+				real_t* r = getTemporary( nZ );
+				real_t* rhs = getTemporary( nZ );
 				for( i=0; i<nZ; ++i )
 					rhs[i] = 0.0;
 
@@ -4017,8 +4076,8 @@ returnValue QProblem::removeBound(	int number,
 				/* 3) Calculate r = R^-T * rhs. */
 				if ( backsolveR( rhs,BT_TRUE,BT_TRUE,r ) != SUCCESSFUL_RETURN )
 				{
-					delete[] z;
-					delete[] Hz; delete[] r; delete[] rhs;
+					releaseTemporary( z );
+					releaseTemporary( Hz ); releaseTemporary( r ); releaseTemporary( rhs );
 					return THROWERROR( RET_REMOVEBOUND_FAILED );
 				}
 
@@ -4031,7 +4090,7 @@ returnValue QProblem::removeBound(	int number,
 					RR(i,nZ) = r[i];
 				}
 
-				delete[] rhs; delete[] r;
+				releaseTemporary( rhs ); releaseTemporary( r );
 			}
 
 			for( j=0; j<nFR; ++j )
@@ -4041,8 +4100,8 @@ returnValue QProblem::removeBound(	int number,
 				rho2 += QQ(jj,nZ) * ( Hz[j] + 2.0*z2*z[j] );
 			}
 
-			delete[] z;
-			delete[] Hz;
+			releaseTemporary( z );
+			releaseTemporary( Hz );
 		}
 
 		/* 5) Store rho into R. */
@@ -4159,10 +4218,10 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 	bounds.getFree( )->getNumberArray( &FR_idx );
 
 // 	real_t *delta_g   = new real_t[nV];
-	real_t *delta_xFX = new real_t[nFX];
-	real_t *delta_xFR = new real_t[nFR];
-	real_t *delta_yAC = new real_t[nAC];
-	real_t *delta_yFX = new real_t[nFX];
+	real_t *delta_xFX = getTemporary( nFX );
+	real_t *delta_xFR = getTemporary( nFR );
+	real_t *delta_yAC = getTemporary( nAC );
+	real_t *delta_yFX = getTemporary( nFX );
 
 	bounds.getFixed( )->getNumberArray( &FX_idx );
 	constraints.getActive( )->getNumberArray( &AC_idx );
@@ -4175,8 +4234,8 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 	if (removeBoundNotConstraint)
 	{
 		int dim = nV < nC ? nC : nV;
-		real_t *nul = new real_t[dim];
-		real_t *ek = new real_t[nV]; /* minus e_k (bound k is removed) */
+		real_t *nul = getTemporary( dim );
+		real_t *ek = getTemporary( nV ); /* minus e_k (bound k is removed) */
 		for (ii = 0; ii < dim; ++ii)
 			nul[ii]=0.0;
 		for (ii = 0; ii < nV; ++ii)
@@ -4186,13 +4245,13 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		returnvalue = determineStepDirection (nul, nul, nul, ek, ek,
 											  BT_FALSE, BT_FALSE,
 											  delta_xFX, delta_xFR, delta_yAC, delta_yFX);
-		delete[] ek;
-		delete[] nul;
+		releaseTemporary( ek );
+		releaseTemporary( nul );
 	}
 	else
 	{
-		real_t *nul = new real_t[nV];
-		real_t *ek = new real_t[nC]; /* minus e_k (constraint k is removed) */
+		real_t *nul = getTemporary( nV );
+		real_t *ek = getTemporary( nC ); /* minus e_k (constraint k is removed) */
 		for (ii = 0; ii < nV; ++ii)
 			nul[ii]=0.0;
 		for (ii = 0; ii < nC; ++ii)
@@ -4203,8 +4262,8 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 											  ek, ek, nul, nul,
 											  BT_FALSE, BT_TRUE,
 											  delta_xFX, delta_xFR, delta_yAC, delta_yFX);
-		delete[] ek;
-		delete[] nul;
+		releaseTemporary( ek );
+		releaseTemporary( nul );
 	}
 
 	/* compute the weight in inf-norm */
@@ -4242,7 +4301,7 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		/* bounds */
 
 		/* compress x-u */
-		real_t *x_W = new real_t[getMax(1,nFR)];
+		real_t *x_W = getTemporary( getMax(1,nFR) );
 		for (i = 0; i < nFR; i++)
 		{
 			ii = FR_idx[i];
@@ -4282,17 +4341,17 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 		for (i = 0; i < nFR; i++)
 			delta_xFR[i] = -delta_xFR[i];
 
-		delete[] x_W;
+		releaseTemporary( x_W );
 
 		/* constraints */
 
 		/* compute As (compressed to inactive constraints) */
-		real_t *As = new real_t[nIAC];
+		real_t *As = getTemporary( nIAC );
 		A->times(constraints.getInactive(), bounds.getFixed(), 1, 1.0, delta_xFX, nFX, 0.0, As, nIAC);
 		A->times(constraints.getInactive(), bounds.getFree(), 1, 1.0, delta_xFR, nFR, 1.0, As, nIAC);
 
 		/* compress Ax_u */
-		real_t *Ax_W = new real_t[nIAC];
+		real_t *Ax_W = getTemporary( nIAC );
 		for (i = 0; i < nIAC; i++)
 		{
 			ii = IAC_idx[i];
@@ -4357,14 +4416,14 @@ returnValue QProblem::ensureNonzeroCurvature(	BooleanType removeBoundNotConstrai
 			exchangeHappened = BT_TRUE;
 		}
 
-		delete[] Ax_W;
-		delete[] As;
+		releaseTemporary( Ax_W );
+		releaseTemporary( As );
 	}
 
-	delete[] delta_yFX;
-	delete[] delta_yAC;
-	delete[] delta_xFR;
-	delete[] delta_xFX;
+	releaseTemporary( delta_yFX );
+	releaseTemporary( delta_yAC );
+	releaseTemporary( delta_xFR );
+	releaseTemporary( delta_xFX );
 // 	delete[] delta_g;
 
 	return returnvalue;
@@ -4871,14 +4930,14 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 
 	int BC_idx_tmp = -1;
 
-	real_t* num = new real_t[ getMax( nV,nC ) ];
-	real_t* den = new real_t[ getMax( nV,nC ) ];
+	real_t* num = getTemporary( getMax( nV,nC ) );
+	real_t* den = getTemporary( getMax( nV,nC ) );
 
-	real_t* delta_Ax_l = new real_t[nC];
-	real_t* delta_Ax_u = new real_t[nC];
-	real_t* delta_Ax   = new real_t[nC];
+	real_t* delta_Ax_l = getTemporary( nC );
+	real_t* delta_Ax_u = getTemporary( nC );
+	real_t* delta_Ax   = getTemporary( nC );
 
-	real_t* delta_x = new real_t[nV];
+	real_t* delta_x = getTemporary( nV );
 	for( j=0; j<nFR; ++j )
 	{
 		jj = FR_idx[j];
@@ -4950,8 +5009,8 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 			{
 				if ( (*constraintProduct)( ii,delta_x, &(delta_Ax[ii]) ) != 0 )
 				{
-					delete[] den; delete[] num;
-					delete[] delta_Ax; delete[] delta_Ax_u; delete[] delta_Ax_l; delete[] delta_x;
+					releaseTemporary( den ); releaseTemporary( num );
+					releaseTemporary( delta_Ax ); releaseTemporary( delta_Ax_u ); releaseTemporary( delta_Ax_l ); releaseTemporary( delta_x );
 					return THROWERROR( RET_ERROR_IN_CONSTRAINTPRODUCT );
 				}
 			}
@@ -5051,9 +5110,9 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 		}
 	}
 
-	delete[] den;
-	delete[] num;
-	delete[] delta_x;
+	releaseTemporary( den );
+	releaseTemporary( num );
+	releaseTemporary( delta_x );
 
 
 	#ifndef __XPCTARGET__
@@ -5132,7 +5191,7 @@ returnValue QProblem::performStep(	const real_t* const delta_g,
 		#endif
 	}
 
-	delete[] delta_Ax; delete[] delta_Ax_u; delete[] delta_Ax_l;
+	releaseTemporary( delta_Ax ); releaseTemporary( delta_Ax_u ); releaseTemporary( delta_Ax_l );
 
 	return SUCCESSFUL_RETURN;
 }
@@ -91,10 +91,26 @@ SubjectTo::~SubjectTo( )
  */
 SubjectTo& SubjectTo::operator=( const SubjectTo& rhs )
 {
+	int i;
+
 	if ( this != &rhs )
 	{
-		clear( );
-		copy( rhs );
+		/* objects of the same size are copied without allocating memory */
+		if ( ( type != 0 ) && ( rhs.type != 0 ) && ( n == rhs.n ) )
+		{
+			noLower = rhs.noLower;
+			noUpper = rhs.noUpper;
+			for( i=0; i<n; ++i )
+			{
+				type[i]   = rhs.type[i];
+				status[i] = rhs.status[i];
+			}
+		}
+		else
+		{
+			clear( );
+			copy( rhs );
+		}
 	}
 
 	return *this;
@@ -112,17 +128,24 @@ returnValue SubjectTo::init(	int _n
 	if ( _n < 0 )
 		return THROWERROR( RET_INVALID_ARGUMENTS );
 
-	clear( );
+	/* the memory of an object of the same size is kept */
+	if ( ( type == 0 ) || ( n != _n ) )
+	{
+		clear( );
+
+		n = _n;
+		if ( n > 0 )
+		{
+			type   = new SubjectToType[n];
+			status = new SubjectToStatus[n];
+		}
+	}
 
-	n = _n;
 	noLower = BT_TRUE;
 	noUpper = BT_TRUE;
 
 	if ( n > 0 )
 	{
-		type   = new SubjectToType[n];
-		status = new SubjectToStatus[n];
-
 		for( i=0; i<n; ++i )
 		{
 			type[i]   = ST_UNKNOWN;
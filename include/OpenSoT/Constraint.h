@@ -22,8 +22,26 @@
 #include <string>
 #include <XBotInterface/Logger.hpp>
 
+#define PADDING_ROWS_BOUND 1e20 //bound of the rows added by Constraint::padInequalities(), qpOASES::INFTY
+
  namespace OpenSoT {
 
+ /**
+  * @brief updateCopy keeps copy equal to value, it is used to detect the changes of the matrices of
+  * Tasks and Constraints (see Task::getVersion() and Constraint::getVersion())
+  * @param value a matrix, a vector or an expression
+  * @param copy of value, it allocates only if the size of value changed
+  * @return true if copy has been changed
+  */
+ template <class Value, class Copy>
+ inline bool updateCopy(const Value& value, Copy& copy)
+ {
+     if(value.rows() == copy.rows() && value.cols() == copy.cols() && value == copy)
+         return false;
+     copy = value;
+     return true;
+ }
+
  /**
   * @brief The Constraint class describes all the different types of constraints:
   * 1. bounds & bilateral
@@ -105,12 +123,134 @@
 
         }
 
+        /**
+         * @brief _version and _matrix_version, see getVersion() and getMatrixVersion()
+         */
+        unsigned long _version;
+        unsigned long _matrix_version;
+
+        /**
+         * @brief copies of the matrices and vectors at the last call of trackChanges()
+         */
+        Matrix_type _Aeq_copy, _Aineq_copy;
+        Vector_type _beq_copy, _bLowerBound_copy, _bUpperBound_copy, _lowerBound_copy, _upperBound_copy;
+
+        /**
+         * @brief _inequality_capacity see setInequalityCapacity(), _active_inequalities number of rows of
+         * Aineq before padInequalities() is called
+         */
+        unsigned int _inequality_capacity;
+        unsigned int _active_inequalities;
+
+        /**
+         * @brief padInequalities has to be called at the end of update() by the constraints whose number of
+         * inequalities changes: it adds to Aineq zero rows, with bounds -PADDING_ROWS_BOUND and
+         * PADDING_ROWS_BOUND, up to the capacity set by setInequalityCapacity(). The rows are never removed,
+         * if the constraint has more inequalities than its capacity its size changes as usual.
+         */
+        void padInequalities()
+        {
+            const int rows = _Aineq.rows();
+            const int capacity = _inequality_capacity;
+            _active_inequalities = rows;
+            if(rows >= capacity)
+                return;
+
+            _Aineq.conservativeResize(capacity, _x_size);
+            _Aineq.bottomRows(capacity - rows).setZero();
+            if(_bUpperBound.size() == rows)
+            {
+                _bUpperBound.conservativeResize(capacity);
+                _bUpperBound.tail(capacity - rows).setConstant(PADDING_ROWS_BOUND);
+            }
+            //with no rows the constraint can not tell if it is bilateral: only the upper bound is padded
+            if(rows > 0 && _bLowerBound.size() == rows)
+            {
+                _bLowerBound.conservativeResize(capacity);
+                _bLowerBound.tail(capacity - rows).setConstant(-PADDING_ROWS_BOUND);
+            }
+        }
+
+        /**
+         * @brief trackChanges compares the matrices and the vectors of the constraint with the ones of the
+         * last call and increases the versions if they changed
+         */
+        void trackChanges()
+        {
+            bool matrix_changed = updateCopy(_Aeq, _Aeq_copy);
+            matrix_changed = updateCopy(_Aineq, _Aineq_copy) || matrix_changed;
+
+            bool changed = updateCopy(_beq, _beq_copy);
+            changed = updateCopy(_bLowerBound, _bLowerBound_copy) || changed;
+            changed = updateCopy(_bUpperBound, _bUpperBound_copy) || changed;
+            changed = updateCopy(_lowerBound, _lowerBound_copy) || changed;
+            changed = updateCopy(_upperBound, _upperBound_copy) || changed;
+
+            if(matrix_changed)
+                _matrix_version++;
+            if(matrix_changed || changed)
+                _version++;
+        }
+
     public:
         Constraint(const std::string constraint_id,
                    const unsigned int x_size) :
-            _constraint_id(constraint_id), _x_size(x_size) {}
+            _constraint_id(constraint_id), _x_size(x_size), _version(0), _matrix_version(0),
+            _inequality_capacity(0), _active_inequalities(0) {}
         virtual ~Constraint() {}
 
+        /**
+         * @brief setInequalityCapacity sets the minimum number of rows of Aineq of a constraint whose number of
+         * inequalities changes (e.g. SelfCollisionAvoidance): the missing rows are filled with inequalities
+         * which are always satisfied (see padInequalities()), so that the size of the QP does not change and
+         * the back-ends are not initialized again. It has effect from the next update().
+         * @param capacity number of rows, 0 (default) to not add rows
+         * @return false if the constraint does not support it
+         */
+        virtual bool setInequalityCapacity(const unsigned int capacity){return false;}
+
+        /**
+         * @brief getInequalityCapacity
+         * @return the minimum number of rows of Aineq, see setInequalityCapacity()
+         */
+        unsigned int getInequalityCapacity(){return _inequality_capacity;}
+
+        /**
+         * @brief getActiveInequalities
+         * @return number of rows of Aineq which are not padding rows, see setInequalityCapacity()
+         */
+        unsigned int getActiveInequalities()
+        {
+            if(_inequality_capacity == 0 || static_cast<int>(_active_inequalities) > _Aineq.rows())
+                return _Aineq.rows();
+            return _active_inequalities;
+        }
+
+        /**
+         * @brief getVersion is increased every time the matrices or the vectors of the constraint change
+         * (Aeq, beq, Aineq, bLowerBound, bUpperBound, lowerBound or upperBound), solvers use it to skip the
+         * parts of the problem which did not change since the last solve.
+         * NOTE: changes are detected comparing the data with a copy taken at the previous call, the version
+         * does not change if the constraint is updated with the same values
+         * @return version of the constraint
+         */
+        unsigned long getVersion()
+        {
+            trackChanges();
+            return _version;
+        }
+
+        /**
+         * @brief getMatrixVersion is increased every time Aeq or Aineq change, a constraint whose matrix
+         * version did not change has only moved its bounds
+         * @return version of the constraint matrices
+         */
+        unsigned long getMatrixVersion()
+        {
+            trackChanges();
+            return _matrix_version;
+        }
+
         const unsigned int getXSize() { return _x_size; }
         virtual const Vector_type& getLowerBound() { return _lowerBound; }
         virtual const Vector_type& getUpperBound() { return _upperBound; }
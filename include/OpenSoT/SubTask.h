@@ -57,6 +57,12 @@
 
         void generateHessianAtype();
 
+        /**
+         * @brief generateJacobianStructure the rows of an identity or selection Jacobian are a selection,
+         * the rows of a block sparse Jacobian have the same block
+         */
+        void generateJacobianStructure();
+
         void generateb();
 
         void generateWeight();
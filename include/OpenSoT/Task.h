@@ -18,6 +18,7 @@
 #ifndef __TASK_H__
 #define __TASK_H__
 
+ #include <algorithm>
  #include <list>
  #include <string>
  #include <vector>
@@ -40,6 +41,18 @@
         HST_UNKNOWN                 /**< Hessian type is unknown. */
     };
 
+    /**
+     * @brief The JacobianStructure enum describes the non zero elements of the task Jacobian A, solvers use it
+     * to compute A'WA and A'Wb without dense products (see iHQP::computeCostFunction())
+     */
+    enum JacobianStructure
+    {
+        JS_GENERAL,                 /**< A is dense. */
+        JS_IDENTITY,                /**< A is the identity matrix. */
+        JS_DIAGONAL_SELECTION,      /**< each row of A has at most one non zero element (A = DS, D diagonal and S selection matrix). */
+        JS_BLOCK_SPARSE             /**< the non zero elements of A are in a block of consecutive columns. */
+    };
+
     /**
      * @brief Task represents a task in the form \f$T(A,b,c)\f$ where \f$A\f$ is the task error jacobian, \f$b\f$ is the task error
      * and \f$c\f$ is used for LP
@@ -69,6 +82,14 @@
          */
         HessianType _hessianType;
 
+        /**
+         * @brief _jacobian_structure of _A, the non zero columns of a JS_BLOCK_SPARSE Jacobian are
+         * _jacobian_block_size columns starting from _jacobian_block_start
+         */
+        JacobianStructure _jacobian_structure;
+        unsigned int _jacobian_block_start;
+        unsigned int _jacobian_block_size;
+
         /**
          * @brief _A Jacobian of the Task
          */
@@ -148,6 +169,43 @@
 
         }
 
+        /**
+         * @brief detectJacobianStructure sets the structure of the task looking at the non zero elements of
+         * the current A, it can be used by tasks whose Jacobian has a constant sparsity pattern
+         */
+        void detectJacobianStructure()
+        {
+            if(_A.rows() == _A.cols() && _A.isIdentity(0.))
+            {
+                setJacobianStructure(JS_IDENTITY);
+                return;
+            }
+
+            bool selection = true;
+            int first_column = _A.cols(), last_column = -1;
+            for(unsigned int i = 0; i < _A.rows(); ++i)
+            {
+                int non_zeros = 0;
+                for(unsigned int j = 0; j < _A.cols(); ++j)
+                {
+                    if(_A(i,j) != 0.)
+                    {
+                        non_zeros++;
+                        first_column = std::min<int>(first_column, j);
+                        last_column = std::max<int>(last_column, j);
+                    }
+                }
+                selection = selection && non_zeros <= 1;
+            }
+
+            if(selection)
+                setJacobianStructure(JS_DIAGONAL_SELECTION);
+            else if(last_column - first_column + 1 < int(_A.cols()))
+                setJacobianBlock(first_column, last_column - first_column + 1);
+            else
+                setJacobianStructure(JS_GENERAL);
+        }
+
     private:
 
         /**
@@ -177,6 +235,36 @@
          */
         Matrix_type _A_last_active;
 
+        /**
+         * @brief _version and _matrix_version, see getVersion() and getMatrixVersion()
+         */
+        unsigned long _version;
+        unsigned long _matrix_version;
+
+        /**
+         * @brief copies of A, b, c and W at the last call of trackChanges()
+         */
+        Matrix_type _A_copy, _W_copy;
+        Vector_type _b_copy, _c_copy;
+
+        /**
+         * @brief trackChanges compares A, b, c and W with the ones of the last call and increases
+         * the versions if they changed
+         */
+        void trackChanges()
+        {
+            bool matrix_changed = updateCopy(_A, _A_copy);
+            matrix_changed = updateCopy(_W, _W_copy) || matrix_changed;
+
+            bool changed = updateCopy(_b, _b_copy);
+            changed = updateCopy(_c, _c_copy) || changed;
+
+            if(matrix_changed)
+                _matrix_version++;
+            if(matrix_changed || changed)
+                _version++;
+        }
+
     public:
         /**
          * @brief Task define a task in terms of Ax = b
@@ -185,7 +273,8 @@
          */
         Task(const std::string task_id,
              const unsigned int x_size) :
-            _task_id(task_id), _x_size(x_size), _active_joints_mask(x_size), _is_active(true), _weight_is_diagonal(false)
+            _task_id(task_id), _x_size(x_size), _active_joints_mask(x_size), _is_active(true), _weight_is_diagonal(false),
+            _version(0), _matrix_version(0)
         {
             //Eigen:
             _A.setZero(0,x_size);
@@ -195,6 +284,9 @@
 
             _lambda = 1.0;
             _hessianType = HST_UNKNOWN;
+            _jacobian_structure = JS_GENERAL;
+            _jacobian_block_start = 0;
+            _jacobian_block_size = x_size;
             for(unsigned int i = 0; i < x_size; ++i)
                 _active_joints_mask[i] = true;
         }
@@ -244,12 +336,91 @@
             return _A;
         }
 
+        /**
+         * @brief getVersion is increased every time A, b, c or the weight W change, solvers use it to skip
+         * the parts of the problem which did not change since the last solve.
+         * NOTE: changes are detected comparing the data with a copy taken at the previous call, the version
+         * does not change if the task is updated with the same values
+         * @return version of the task
+         */
+        unsigned long getVersion()
+        {
+            trackChanges();
+            return _version;
+        }
+
+        /**
+         * @brief getMatrixVersion is increased every time A or the weight W change, i.e. when the Hessian
+         * of the task changes
+         * @return version of A and W
+         */
+        unsigned long getMatrixVersion()
+        {
+            trackChanges();
+            return _matrix_version;
+        }
+
         /**
          * @brief getHessianAtype
          * @return the Hessian type
          */
         const HessianType getHessianAtype() { return _hessianType; }
 
+        /**
+         * @brief getJacobianStructure
+         * @return the structure of A, an identity Jacobian is reported as JS_DIAGONAL_SELECTION when the
+         * task is not active or some joints are not active (see setActiveJointsMask())
+         */
+        JacobianStructure getJacobianStructure() const
+        {
+            if(_jacobian_structure == JS_IDENTITY)
+            {
+                if(!_is_active)
+                    return JS_DIAGONAL_SELECTION;
+                for(unsigned int i = 0; i < _active_joints_mask.size(); ++i)
+                    if(!_active_joints_mask[i])
+                        return JS_DIAGONAL_SELECTION;
+            }
+            return _jacobian_structure;
+        }
+
+        /**
+         * @brief setJacobianStructure set the structure of A (NOTE that no check on A is performed, we trust you),
+         * use setJacobianBlock() for JS_BLOCK_SPARSE
+         * @param structure of A
+         */
+        void setJacobianStructure(const JacobianStructure structure)
+        {
+            _jacobian_structure = structure;
+            _jacobian_block_start = 0;
+            _jacobian_block_size = _x_size;
+        }
+
+        /**
+         * @brief setJacobianBlock set the structure of A to JS_BLOCK_SPARSE (NOTE that no check on A is performed, we trust you)
+         * @param start first non zero column of A
+         * @param size number of non zero columns of A
+         */
+        void setJacobianBlock(const unsigned int start, const unsigned int size)
+        {
+            assert(start + size <= _x_size);
+            _jacobian_structure = JS_BLOCK_SPARSE;
+            _jacobian_block_start = start;
+            _jacobian_block_size = size;
+        }
+
+        /**
+         * @brief getJacobianBlockStart
+         * @return the first non zero column of A (0 if A is not JS_BLOCK_SPARSE)
+         */
+        unsigned int getJacobianBlockStart() const { return _jacobian_block_start; }
+
+        /**
+         * @brief getJacobianBlockSize
+         * @return the number of non zero columns of A (getXSize() if A is not JS_BLOCK_SPARSE)
+         */
+        unsigned int getJacobianBlockSize() const { return _jacobian_block_size; }
+
         /**
          * @brief getb
          * @return the b matrix of the task
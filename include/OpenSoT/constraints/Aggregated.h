@@ -23,6 +23,7 @@
 #include <boost/shared_ptr.hpp>
 #include <OpenSoT/utils/Piler.h>
 #include <list>
+#include <vector>
 
 using namespace OpenSoT::utils;
 
@@ -55,19 +56,34 @@ using namespace OpenSoT::utils;
                  *  if not enabled, bilateral bounds will be converted to unilateral:
                  *      l <= x <= u becomes x <= u && -x <= -l
                  */
-                UNILATERAL_TO_BILATERAL = 0x100
+                UNILATERAL_TO_BILATERAL = 0x100,
+                /** equalities and bilateral constraints are passed as single rows lA <= Ax <= uA (lA = uA
+                 *  for equalities), unilateral constraints are padded with infinite bounds: no row is
+                 *  doubled, as the back-ends handle bilateral rows natively. It is the default policy
+                 *  and the one used by the solvers
+                 */
+                NATIVE_BILATERAL = EQUALITIES_TO_INEQUALITIES | UNILATERAL_TO_BILATERAL
             };
 
         protected:
-            VectorPiler _tmpupperBound;
-            VectorPiler _tmplowerBound;
-
-            MatrixPiler _tmpAeq;
-            VectorPiler _tmpbeq;
+            /**
+             * @brief The RowsBlock struct is the slice of the aggregated matrices written by a constraint:
+             * eq_rows rows of Aeq starting from eq_offset and ineq_rows rows of Aineq starting from
+             * ineq_offset (flipped rows included)
+             */
+            struct RowsBlock
+            {
+                int eq_offset;
+                int eq_rows;
+                int ineq_offset;
+                int ineq_rows;
+            };
 
-            MatrixPiler _tmpAineq;
-            VectorPiler _tmpbUpperBound;
-            VectorPiler _tmpbLowerBound;
+            /**
+             * @brief _layout one block for each constraint, computed by computeLayout() before
+             * the constraints are copied in their slices of _Aeq and _Aineq
+             */
+            std::vector<RowsBlock> _layout;
 
             std::list< ConstraintPtr > _bounds;
             unsigned int _number_of_bounds;
@@ -75,6 +91,13 @@ using namespace OpenSoT::utils;
 
             void checkSizes();
 
+            /**
+             * @brief computeLayout computes the slices of the aggregated matrices written by each
+             * constraint and resizes them (no memory is allocated if the sizes did not change)
+             */
+            void computeLayout();
+
+
             static const std::string concatenateConstraintsIds(const std::list<ConstraintPtr> constraints);
 
 
@@ -103,9 +126,7 @@ using namespace OpenSoT::utils;
              */
             Aggregated(const std::list< ConstraintPtr > constraints,
                        const Eigen::VectorXd &q,
-                       const unsigned int aggregationPolicy =
-                            EQUALITIES_TO_INEQUALITIES |
-                            UNILATERAL_TO_BILATERAL);
+                       const unsigned int aggregationPolicy = NATIVE_BILATERAL);
 
             /**
              * @brief Aggregated
@@ -115,9 +136,7 @@ using namespace OpenSoT::utils;
              */
             Aggregated(const std::list<ConstraintPtr> constraints,
                        const unsigned int x_size,
-                       const unsigned int aggregationPolicy =
-                            EQUALITIES_TO_INEQUALITIES |
-                            UNILATERAL_TO_BILATERAL);
+                       const unsigned int aggregationPolicy = NATIVE_BILATERAL);
 
             /**
              * @brief Aggregated
@@ -129,14 +148,19 @@ using namespace OpenSoT::utils;
             Aggregated(ConstraintPtr bound1,
                        ConstraintPtr bound2,
                        const unsigned int &x_size,
-                       const unsigned int aggregationPolicy =
-                            EQUALITIES_TO_INEQUALITIES |
-                            UNILATERAL_TO_BILATERAL);
+                       const unsigned int aggregationPolicy = NATIVE_BILATERAL);
 
             void update(const Eigen::VectorXd &x);
 
             std::list< ConstraintPtr >& getConstraintsList() { return _bounds; }
 
+            /**
+             * @brief getAggregationPolicy
+             * @return the AggregationPolicy flags used to pile the constraints
+             */
+            unsigned int getAggregationPolicy() const { return _aggregationPolicy; }
+
+
             void generateAll();
         };
     }
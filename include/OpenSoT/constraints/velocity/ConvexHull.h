@@ -93,6 +93,15 @@
 
                 void update(const Eigen::VectorXd &x);
 
+                /**
+                 * @brief setInequalityCapacity keeps at least capacity rows in Aineq, so that a change in the
+                 * number of edges of the convex hull does not change the size of the QP
+                 * (see Constraint::setInequalityCapacity())
+                 * @param capacity e.g. the maximum number of edges of the convex hull
+                 * @return true
+                 */
+                bool setInequalityCapacity(const unsigned int capacity);
+
                 std::list<std::string> getLinksInContact()
                 {
                     return _links_in_contact;
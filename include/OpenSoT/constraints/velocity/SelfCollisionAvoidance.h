@@ -71,6 +71,12 @@
                 std::string base_name;
 
                 Eigen::MatrixXd _J_transform;
+
+                /**
+                 * @brief _Link1_Jaco, _Link2_Jaco Jacobians of the link pair being processed by
+                 * calculate_Aineq_bUpperB(), allocated once in the constructor
+                 */
+                Eigen::MatrixXd _Link1_Jaco, _Link2_Jaco;
             public:               
                 /**
                  * @brief Skew_symmetric_operator is used to get the transformation matrix which is used to transform
@@ -83,7 +89,8 @@
 
                 /**
                  * @brief calculate_Aineq_bUpperB the core function which is used to update the variables Aineq and
-                 * bUpperBound for this constraint
+                 * bUpperBound for this constraint. It pads them up to the inequality capacity by itself and it
+                 * allocates only when their size changes
                  * @param Aineq_fc Aineq matrix of this constraint
                  * @param bUpperB_fc bUpperBound of this constraint
                  */
@@ -170,6 +177,15 @@
                  *         collision with the capsule by slowing down)
                  */
                 void setBoundScaling(const double boundScaling);
+
+                /**
+                 * @brief setInequalityCapacity keeps at least capacity rows in Aineq, one for each link pair closer
+                 * than the detection threshold followed by rows which are always satisfied: link pairs crossing the
+                 * detection threshold do not change the size of the QP (see Constraint::setInequalityCapacity())
+                 * @param capacity e.g. the number of link pairs which can be closer than the detection threshold
+                 * @return true
+                 */
+                bool setInequalityCapacity(const unsigned int capacity);
             };
         }
     }
@@ -16,6 +16,49 @@ namespace OpenSoT{
 
         typedef boost::shared_ptr<BackEnd> Ptr;
 
+        /**
+         * @brief The SolvePath enum tells which procedure was used by the last call of solve()
+         */
+        enum SolvePath
+        {
+            /**
+             * @brief SOLVE_HOTSTART the data of the previous solve (working set, factorizations,
+             * primal and dual solutions) has been reused
+             */
+            SOLVE_HOTSTART,
+            /**
+             * @brief SOLVE_WARMSTART the hotstart failed and the problem has been initialized again
+             * from a guess based on the previous solution
+             */
+            SOLVE_WARMSTART,
+            /**
+             * @brief SOLVE_COLDSTART the problem has been initialized from scratch
+             */
+            SOLVE_COLDSTART
+        };
+
+        /**
+         * @brief The SolveInfo struct reports how the last call of solve() went
+         */
+        struct SolveInfo
+        {
+            SolvePath path;
+            /**
+             * @brief iterations working set changes (active set back-ends) or iterations (ADMM, simplex)
+             * performed by the last solve() in all the attempts, -1 if not available
+             */
+            int iterations;
+            /**
+             * @brief status back-end specific return code of the last attempt
+             */
+            int status;
+            /**
+             * @brief time_limit_reached true if the last solve() stopped because the time budget
+             * (see setTimeBudget()) was over
+             */
+            bool time_limit_reached;
+        };
+
         /**
          * @brief getSolution return the actual solution of the QP problem
          * @return solution
@@ -27,7 +70,7 @@ namespace OpenSoT{
          */
         const Eigen::MatrixXd& getH(){return _H;}
         const Eigen::VectorXd& getg(){return _g;}
-        const Eigen::MatrixXd& getA(){return _A;}
+        virtual const Eigen::MatrixXd& getA(){return _A;}
         const Eigen::VectorXd& getlA(){return _lA;}
         const Eigen::VectorXd& getuA(){return _uA;}
         const Eigen::VectorXd& getl(){return _l;}
@@ -36,6 +79,25 @@ namespace OpenSoT{
         int getNumVariables() const;
         int getNumConstraints() const;
 
+        /**
+         * @brief MatrixView is a writable view of a matrix with arbitrary storage order
+         */
+        typedef Eigen::Map<Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > MatrixView;
+
+        /**
+         * Writable views of the storage used by the back-end: a solver can assemble the problem directly
+         * in the back-end and then call commitTask(), commitConstraints() or commitBounds() instead of
+         * updateTask(), updateConstraints() or updateBounds(), avoiding the copy of the matrices.
+         * NOTE: views can not change the size of the problem, use the update methods in that case.
+         */
+        Eigen::Ref<Eigen::MatrixXd> getHView(){return _H;}
+        Eigen::Ref<Eigen::VectorXd> getgView(){return _g;}
+        virtual MatrixView getAView();
+        Eigen::Ref<Eigen::VectorXd> getlAView(){return _lA;}
+        Eigen::Ref<Eigen::VectorXd> getuAView(){return _uA;}
+        Eigen::Ref<Eigen::VectorXd> getlView(){return _l;}
+        Eigen::Ref<Eigen::VectorXd> getuView(){return _u;}
+
         /**
          * @brief log Tasks, Constraints and Bounds matrices
          * @param logger a pointer to a MatLogger
@@ -101,6 +163,98 @@ namespace OpenSoT{
          */
         virtual bool updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd& u);
 
+        /**
+         * @brief commitTask has to be called after H and g are written through getHView() and getgView()
+         * @return true if task is correctly updated
+         */
+        virtual bool commitTask(){return true;}
+
+        /**
+         * @brief commitConstraints has to be called after A, lA and uA are written through getAView(),
+         * getlAView() and getuAView()
+         * @return true if constraints are correctly updated
+         */
+        virtual bool commitConstraints(){return true;}
+
+        /**
+         * @brief commitBounds has to be called after l and u are written through getlView() and getuView()
+         * @return true if bounds are correctly updated
+         */
+        virtual bool commitBounds(){return true;}
+
+        /**
+         * @brief commitGradient can be called instead of commitTask() when only g has been written through
+         * getgView() and H is the same of the last solve: the back-end can keep the factorizations which
+         * depend on H
+         * @return true if task is correctly updated
+         */
+        virtual bool commitGradient(){return commitTask();}
+
+        /**
+         * @brief commitConstraintsBounds can be called instead of commitConstraints() when only lA and uA
+         * have been written through getlAView() and getuAView() and A is the same of the last solve: the
+         * back-end can keep the factorizations which depend on A
+         * @return true if constraints are correctly updated
+         */
+        virtual bool commitConstraintsBounds(){return commitConstraints();}
+
+        /**
+         * @brief getWorkingSet writes the state of bounds and constraints at the last solution:
+         * -1 active at the lower bound, 1 active at the upper bound, 0 inactive
+         * @param bounds state of the bounds, resized to the number of variables
+         * @param constraints state of the constraints, resized to the number of constraints
+         * @return false if the back-end does not use a working set
+         */
+        virtual bool getWorkingSet(Eigen::VectorXd& bounds, Eigen::VectorXd& constraints){return false;}
+
+        /**
+         * @brief setWorkingSetGuess sets the working set (same format of getWorkingSet()) the next
+         * initialization of the problem starts from, instead of the empty one. It is used once, by
+         * initProblem() or by an update which changes the size of the problem, and it has to have the
+         * size of the problem after the update.
+         * @param bounds guessed state of the bounds
+         * @param constraints guessed state of the constraints
+         * @return false if the back-end does not use a working set
+         */
+        virtual bool setWorkingSetGuess(const Eigen::VectorXd& bounds, const Eigen::VectorXd& constraints){return false;}
+
+        /**
+         * @brief setTimeBudget set the maximum time the next calls of solve() can take. When a time
+         * budget is set the back-end has to return false, instead of trying to recover the solution
+         * with procedures whose duration is not bounded, as soon as the budget is over.
+         * @param time budget in seconds, a non positive value removes the limit
+         * @return false if the back-end does not support time limits
+         */
+        virtual bool setTimeBudget(const double time){_time_budget = time; return false;}
+
+        /**
+         * @brief getTimeBudget
+         * @return the time budget (in seconds) of solve(), a non positive value means no limit
+         */
+        double getTimeBudget(){return _time_budget;}
+
+        /**
+         * @brief getSolveInfo
+         * @return information about the last call of solve()
+         */
+        const SolveInfo& getSolveInfo() const {return _solve_info;}
+
+        /**
+         * @brief writeOptions serializes the options of the back-end (see getOptions()), it is used
+         * to record the problems (see QPRecorder) and it must not allocate memory
+         * @param buffer where the options are written
+         * @param size of the buffer in bytes
+         * @return number of bytes written, 0 if the options can not be serialized or do not fit
+         */
+        virtual std::size_t writeOptions(char* buffer, const std::size_t size){return 0;}
+
+        /**
+         * @brief readOptions sets the options serialized by writeOptions()
+         * @param buffer with the options
+         * @param size of the buffer in bytes
+         * @return false if the options can not be read
+         */
+        virtual bool readOptions(const char* buffer, const std::size_t size){return false;}
 
 
         ///PURE VIRTUAL METHODS:
@@ -192,6 +346,16 @@ namespace OpenSoT{
          * @brief _number_of_variables which remain constant during BE existence
          */
         int _number_of_variables;
+
+        /**
+         * @brief _time_budget maximum time of solve() in seconds (non positive: no limit)
+         */
+        double _time_budget;
+
+        /**
+         * @brief _solve_info has to be filled by solve()
+         */
+        SolveInfo _solve_info;
     };
 
     }
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _WB_SOT_SOLVERS_BATCH_SOLVER_H_
+#define _WB_SOT_SOLVERS_BATCH_SOLVER_H_
+
+#include <functional>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Dense>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/utils/WorkerPool.h>
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The BatchSolver class solves many independent problems with the same structure (e.g. the
+     * same stack for different robots or for different states of a dataset) in parallel.
+     *
+     * Each problem owns its own tasks, constraints, model and iHQP solver, built once by a user
+     * factory, so that the back-ends (and their workspaces) are reused between calls of solve().
+     * The problems are distributed to the threads dynamically (see OpenSoT::utils::WorkerPool),
+     * hence a thread which finishes early takes the next problem.
+     *
+     * Usage:
+     *
+     *      BatchSolver::ProblemFactory factory = [&](const unsigned int i){
+     *          BatchSolver::Problem::Ptr problem(new BatchSolver::Problem());
+     *          XBot::ModelInterface::Ptr model = XBot::ModelInterface::getModel(path_to_config);
+     *          auto stack = (...) << ...;
+     *          problem->solver.reset(new iHQP(stack->getStack(), stack->getBounds(), 1e9));
+     *          problem->update = [model, stack](const Eigen::VectorXd& q){
+     *              model->setJointPosition(q);
+     *              model->update();
+     *              stack->update(q);};
+     *          return problem;};
+     *
+     *      BatchSolver batch(N, factory, std::thread::hardware_concurrency());
+     *      batch.solve(Q, DQ); //Q and DQ have one column per problem
+     */
+    class BatchSolver
+    {
+    public:
+        typedef boost::shared_ptr<BatchSolver> Ptr;
+
+        /**
+         * @brief The Problem struct is one of the independent problems of the batch
+         */
+        struct Problem
+        {
+            typedef boost::shared_ptr<Problem> Ptr;
+
+            /**
+             * @brief update is called with the state of the problem before solving it
+             * (e.g. updates the model and the stack of the problem)
+             */
+            std::function<void(const Eigen::VectorXd&)> update;
+
+            /**
+             * @brief solver of the problem
+             */
+            iHQP::Ptr solver;
+        };
+
+        typedef std::function<Problem::Ptr(const unsigned int)> ProblemFactory;
+
+        /**
+         * @brief BatchSolver constructor
+         * @param number_of_problems number of independent problems
+         * @param factory called once for each problem (from the calling thread), each problem must not
+         * share tasks, constraints or models with the other ones
+         * @param number_of_threads total number of threads used by solve(), including the calling one
+         * @throw exception if the factory does not return a solver or the solver has no back-end
+         */
+        BatchSolver(const unsigned int number_of_problems, const ProblemFactory& factory,
+                    const unsigned int number_of_threads);
+
+        /**
+         * @brief solve updates and solves all the problems
+         * @param states matrix with the state of the i-th problem in the i-th column
+         * @param solutions matrix with the solution of the i-th problem in the i-th column
+         * @return true if all the problems are solved (see isSolved())
+         */
+        bool solve(const Eigen::MatrixXd& states, Eigen::MatrixXd& solutions);
+
+        /**
+         * @brief isSolved
+         * @param i problem
+         * @return true if the i-th problem has been solved in the last call of solve()
+         */
+        bool isSolved(const unsigned int i) const;
+
+        /**
+         * @brief getProblem retrieve the i-th problem (e.g. to change its references)
+         * NOTE: the problems must not be changed while solve() is running
+         * @param i problem
+         * @return the problem, an empty pointer if i is out of range
+         */
+        Problem::Ptr getProblem(const unsigned int i);
+
+        /**
+         * @brief getNumberOfProblems
+         * @return number of problems of the batch
+         */
+        unsigned int getNumberOfProblems() const {return _problems.size();}
+
+        /**
+         * @brief getNumberOfThreads
+         * @return number of threads used by solve(), including the calling one
+         */
+        unsigned int getNumberOfThreads() const {return _pool.getNumberOfThreads();}
+
+    private:
+        void solveProblem(const unsigned int i);
+
+        std::vector<Problem::Ptr> _problems;
+        OpenSoT::utils::WorkerPool _pool;
+        OpenSoT::utils::WorkerPool::Job _job;
+
+        /**
+         * @brief _states, _solutions and _solved are written by the job of each problem
+         * (_solved is not a std::vector<bool> since its elements are written concurrently)
+         */
+        std::vector<Eigen::VectorXd> _states;
+        std::vector<Eigen::VectorXd> _solutions;
+        std::vector<char> _solved;
+    };
+
+    }
+}
+
+#endif
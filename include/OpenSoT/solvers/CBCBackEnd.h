@@ -37,6 +37,17 @@ namespace solvers{
              */
             virtual void setOptions(const boost::any& options);
             boost::any getOptions();
+
+            /**
+             * @brief writeOptions copies the indices of the integer variables, see BackEnd::writeOptions()
+             */
+            virtual std::size_t writeOptions(char* buffer, const std::size_t size);
+
+            /**
+             * @brief readOptions sets the indices of the integer variables, see BackEnd::readOptions()
+             * NOTE: THIS IS NOT RT SAFE!
+             */
+            virtual bool readOptions(const char* buffer, const std::size_t size);
             bool solve();
             
             double getObjective();
@@ -44,6 +55,8 @@ namespace solvers{
             bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A, 
                                 const Eigen::Ref<const Eigen::VectorXd>& lA, 
                                 const Eigen::Ref<const Eigen::VectorXd>& uA);
+
+            bool commitConstraints();
             
             struct CBCBackEndOptions
             {
@@ -19,6 +19,16 @@ namespace solvers{
  * @brief The OSQPBackEnd class handle variables, options and execution of a
  * single osqp problem. Is implemented using Eigen.
  * This represent the Back-End.
+ *
+ * The sparsity pattern of P (upper triangular part of H plus the diagonal) and A (constraints plus
+ * an identity block for the bounds) is computed from the nonzero entries of the matrices at initialization.
+ * At each solve only the values in the pattern are passed to osqp; if a new nonzero appears outside the
+ * pattern, the pattern is enlarged and the osqp workspace is set up again.
+ *
+ * The workspace is reused as long as the dimensions of the problem do not change (also by initProblem):
+ * data are updated in place and the KKT system is factorized again only if the values of P or A changed.
+ * Each solve is warm-started with the previous primal and dual solutions and, when the workspace has to be
+ * set up again, the last (adapted) rho and the previous solutions are passed to the new one.
  */
 class OSQPBackEnd:  public BackEnd{
     
@@ -69,6 +79,14 @@ public:
      */
     virtual bool solve();
 
+    /**
+     * @brief setTimeBudget set the time limit of osqp (setting time_limit)
+     * NOTE: the time limit is available only if osqp (>= 0.6) is compiled with PROFILING
+     * @param time budget in seconds, a non positive value removes the limit
+     * @return false if osqp does not support time limits
+     */
+    virtual bool setTimeBudget(const double time);
+
     /**
      * @brief getOptions return the options of the QP problem
      * @return options
@@ -77,10 +95,24 @@ public:
 
     /**
      * @brief setOptions of the QP problem.
+     * If a workspace exists, the runtime settings are applied through the osqp_update_* functions
+     * (a new rho refactorizes the KKT system, otherwise the adapted rho is kept), while a change of
+     * the settings used only by osqp_setup (sigma, scaling, adaptive rho, linear system solver)
+     * sets up the workspace again at the next solve().
      * @param options
      */
     virtual void setOptions(const boost::any& options);
 
+    /**
+     * @brief writeOptions copies the OSQPSettings, see BackEnd::writeOptions()
+     */
+    virtual std::size_t writeOptions(char* buffer, const std::size_t size);
+
+    /**
+     * @brief readOptions sets the OSQPSettings, see BackEnd::readOptions()
+     */
+    virtual bool readOptions(const char* buffer, const std::size_t size);
+
     /**
      * @brief updateTask update internal H and g:
      * _H = H
@@ -117,25 +149,92 @@ public:
      */
     virtual bool updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd& u);
 
+    /**
+     * @brief commitTask copies H in the values of the sparse P
+     * @return true
+     */
+    virtual bool commitTask();
+
+    /**
+     * @brief commitConstraints copies A in the values of the sparse constraint matrix and lA, uA
+     * in the osqp constraint bounds
+     * @return true
+     */
+    virtual bool commitConstraints();
+
+    /**
+     * @brief commitBounds copies l and u in the osqp constraint bounds
+     * @return true
+     */
+    virtual bool commitBounds();
+
+    /**
+     * @brief commitGradient sets g only, H is not scanned and P is not updated in the workspace
+     * @return true
+     */
+    virtual bool commitGradient();
+
+    /**
+     * @brief commitConstraintsBounds copies lA, uA in the osqp constraint bounds, A is not scanned
+     * and it is not updated in the workspace
+     * @return true
+     */
+    virtual bool commitConstraintsBounds();
+
     /**
      * @brief getObjective to retrieve the value of the objective function
      * @return the value of the objective function at the optimum
      */
     virtual double getObjective();
 
+    /**
+     * @brief getNumberOfSetups
+     * @return number of times the osqp workspace has been set up
+     */
+    unsigned int getNumberOfSetups() const {return _number_of_setups;}
+
+    /**
+     * @brief getNumberOfRefactorizations
+     * @return number of times the KKT system has been factorized again because of new values in P or A
+     * (the factorizations done by the setups are not counted)
+     */
+    unsigned int getNumberOfRefactorizations() const {return _number_of_refactorizations;}
+
 private:
     
     typedef Eigen::SparseMatrix<double> SparseMatrix;
     typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseMatrixRowMajor;
     
     /**
-     * @brief __generate_data_struct creates DENSE Hessian and Constraints matrices using a SPARSE representation.
+     * @brief __generate_data_struct creates SPARSE Hessian and Constraints matrices using the nonzero entries
+     * of _H and _A. If the matrices were already created, their sparsity pattern is kept (the new pattern is the
+     * union of the old one and of the actual nonzeros).
      * Note that bounds are treated as constraints.
      * @param number_of_variables of the QP
      * @param number_of_constraints of the QP
      * @param number_of_bounds of the QP
      */
     void __generate_data_struct(const int number_of_variables, const int number_of_constraints, const int number_of_bounds);
+
+    /**
+     * @brief __update_P_values copies _H in the values of the sparse P, _P_changed is set if some value changed
+     * @return false if _H has nonzero entries outside the sparsity pattern of P
+     */
+    bool __update_P_values();
+
+    /**
+     * @brief __update_A_values copies _A in the values of the sparse A, _A_changed is set if some value changed
+     * @return false if _A has nonzero entries outside the sparsity pattern of A
+     */
+    bool __update_A_values();
+
+    /**
+     * @brief __setup_workspace creates the osqp workspace from _data, if a workspace already exists
+     * its rho is kept (unless a new one was set by setOptions()) and the new one is warm-started with
+     * the previous solution
+     * @return true if the workspace is created
+     */
+    bool __setup_workspace();
     void update_data_struct();
     
     void upper_triangular_sparse_update();
@@ -161,8 +260,37 @@ private:
     SparseMatrix _Asparse, _Asparse_upper;
     SparseMatrixRowMajor _Asparse_rowmaj;
     SparseMatrix _Psparse;
-    Eigen::MatrixXd _Adense;
-    Eigen::VectorXd _P_values;
+
+    /**
+     * @brief _pattern_changed is true when H or A have nonzero entries outside the actual sparsity pattern
+     */
+    bool _pattern_changed;
+
+    /**
+     * @brief _setup_settings_changed is true when setOptions() changed settings used only by osqp_setup,
+     * the next solve() sets up the workspace again
+     */
+    bool _setup_settings_changed;
+
+    /**
+     * @brief _keep_adapted_rho is false when setOptions() requested a new rho which has not been
+     * passed to the workspace yet: the next setup uses it instead of the adapted one
+     */
+    bool _keep_adapted_rho;
+
+    /**
+     * @brief _P_changed and _A_changed are true when the values of P and A changed since the last solve
+     */
+    bool _P_changed;
+    bool _A_changed;
+
+    unsigned int _number_of_setups;
+    unsigned int _number_of_refactorizations;
+
+    /**
+     * @brief _dual_solution of the last solve, used for warm-start
+     */
+    Eigen::VectorXd _dual_solution;
 
     Eigen::MatrixXd _eye;
 
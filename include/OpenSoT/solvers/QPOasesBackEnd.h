@@ -11,6 +11,8 @@ namespace qpOASES {
     class Options;
     class Bounds;
     class Constraints;
+    class DenseMatrix;
+    class SymDenseMat;
 }
 
 namespace OpenSoT{
@@ -74,6 +76,18 @@ namespace OpenSoT{
          */
         virtual void setOptions(const boost::any& options);
 
+        /**
+         * @brief writeOptions serializes the fields of qpOASES::Options one by one, after a version of the
+         * format, see BackEnd::writeOptions()
+         */
+        virtual std::size_t writeOptions(char* buffer, const std::size_t size);
+
+        /**
+         * @brief readOptions sets the qpOASES::Options serialized by writeOptions(), it fails if the size or the
+         * version of the format do not match, see BackEnd::readOptions()
+         */
+        virtual bool readOptions(const char* buffer, const std::size_t size);
+
         /**
          * @brief initProblem initialize the QP problem and get the solution, the dual solution,
          * bounds and constraints.
@@ -127,13 +141,66 @@ namespace OpenSoT{
                                const Eigen::Ref<const Eigen::VectorXd> &lA, 
                                const Eigen::Ref<const Eigen::VectorXd> &uA);
 
+        /**
+         * @brief commitTask, commitConstraints: H or A have been written through the views, the next
+         * solve() passes them to qpOASES, which factorizes the problem again
+         */
+        virtual bool commitTask(){_H_changed = true; return true;}
+        virtual bool commitConstraints(){_A_changed = true; return true;}
+
+        /**
+         * @brief commitGradient, commitConstraintsBounds: if neither H nor A changed since the last
+         * solve, the next solve() hotstarts qpOASES with the new vectors only, keeping its factorization
+         */
+        virtual bool commitGradient(){return true;}
+        virtual bool commitConstraintsBounds(){return true;}
+
+        /**
+         * @brief getWorkingSet see BackEnd::getWorkingSet(), it does not allocate if the vectors
+         * have already the right size
+         */
+        virtual bool getWorkingSet(Eigen::VectorXd& bounds, Eigen::VectorXd& constraints);
+
+        /**
+         * @brief setWorkingSetGuess see BackEnd::setWorkingSetGuess(), a guess with more active rows
+         * (equalities included) than variables is ignored; if qpOASES can not be initialized from the
+         * guessed working set within nV + nC working set changes, the problem is initialized again from
+         * the empty one
+         */
+        virtual bool setWorkingSetGuess(const Eigen::VectorXd& bounds, const Eigen::VectorXd& constraints);
+
+        /**
+         * @brief getA return the constraint matrix in column-major format
+         * NOTE: the constraint matrix is stored in row-major format, this method copies it
+         * @return constraint matrix
+         */
+        virtual const Eigen::MatrixXd& getA();
+
+        /**
+         * @brief getAView return a writable view of the row-major constraint matrix
+         * @return view of the constraint matrix
+         */
+        virtual MatrixView getAView();
+
 
         /**
          * @brief solve the QP problem
+         * NOTE: if a time budget is set, hotstart, the initialization with the previous solution and the
+         * cold initialization share the budget (cputime argument of qpOASES) together with an initialization
+         * done by updateTask() or updateConstraints() since the last solve(): when it is over solve() returns
+         * false and SolveInfo::time_limit_reached is set.
          * @return true if the QP problem is solved
          */
         virtual bool solve();
 
+        /**
+         * @brief setTimeBudget set the maximum time of solve() and of the updates which initialize the
+         * problem again before it
+         * @param time budget in seconds, a non positive value removes the limit
+         * @return true
+         */
+        virtual bool setTimeBudget(const double time);
+
 
         /**
          * @brief getHessianType return the hessian type f the problem
@@ -162,14 +229,16 @@ namespace OpenSoT{
         /**
          * @brief getActiveBounds return the active bounds of the solved QP problem
          * @return active bounds
+         * NOTE: the working set is copied from qpOASES, this is NOT RT-SAFE!
          */
-        const qpOASES::Bounds& getActiveBounds(){return *_bounds;}
+        const qpOASES::Bounds& getActiveBounds();
 
         /**
          * @brief getActiveConstraints return the active constraints of the solved QP problem
          * @return active constraints
+         * NOTE: the working set is copied from qpOASES, this is NOT RT-SAFE!
          */
-        const qpOASES::Constraints& getActiveConstraints(){return *_constraints;}
+        const qpOASES::Constraints& getActiveConstraints();
 
 
         /**
@@ -202,6 +271,75 @@ namespace OpenSoT{
          */
         void checkINFTY();
 
+        /**
+         * @brief initQP initialize the QP problem using the internal matrices
+         * @param cputime if not NULL, maximum time of the initialization on input and time spent on output
+         * (as in qpOASES)
+         * @return true if the problem can be solved
+         */
+        bool initQP(double* cputime = NULL);
+
+        /**
+         * @brief reinitQP initialize the QP problem after an update changed its size, within the time budget
+         * left for the next solve()
+         * @return true if the problem can be solved
+         */
+        bool reinitQP();
+
+        /**
+         * @brief RowMajorMatrix is the layout of the matrices used by qpOASES
+         */
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrix;
+
+        /**
+         * @brief _A_row_major is the constraint matrix passed to qpOASES, it is written directly by
+         * initProblem and updateConstraints so that no temporary is needed when solving.
+         * _A is kept with the same size and it is filled only when getA() is called.
+         */
+        RowMajorMatrix _A_row_major;
+
+        /**
+         * @brief _H_matrix and _A_matrix wrap (without copying) _H_solver and _A_row_major, they are passed to
+         * hotstart so that qpOASES does not allocate its own wrappers at every solve.
+         * They are created again in initQP() since the data may have been reallocated.
+         */
+        boost::shared_ptr<qpOASES::SymDenseMat> _H_matrix;
+        boost::shared_ptr<qpOASES::DenseMatrix> _A_matrix;
+
+        /**
+         * @brief _H_solver is the Hessian passed to qpOASES, which regularises it in place: it is copied
+         * from _H before each hotstart with a new Hessian, so that _H is never regularised twice when
+         * the solver does not write it again
+         */
+        Eigen::MatrixXd _H_solver;
+
+        /**
+         * @brief _H_changed and _A_changed are true if H or A changed since the last solve(), otherwise
+         * qpOASES is hotstarted without passing the matrices
+         */
+        bool _H_changed;
+        bool _A_changed;
+
+        /**
+         * @brief _bounds_guess and _constraints_guess are the working set used by the next initQP()
+         * if _working_set_guess is true
+         */
+        Eigen::VectorXd _bounds_guess;
+        Eigen::VectorXd _constraints_guess;
+        bool _working_set_guess;
+
+        /**
+         * @brief _reinitialized is true if the problem has been initialized again by an update which changed
+         * its size: the next solve() reports the initialization in its SolveInfo
+         */
+        bool _reinitialized;
+
+        /**
+         * @brief _time_spent is the part of the time budget spent by the initializations done by the updates
+         * since the last solve()
+         */
+        double _time_spent;
+
         /**
          * @brief _problem is the internal SQProblem
          */
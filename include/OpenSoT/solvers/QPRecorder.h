@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _WB_SOT_SOLVERS_QP_RECORDER_H_
+#define _WB_SOT_SOLVERS_QP_RECORDER_H_
+
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <string>
+#include <vector>
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The QPRecorder class is a flight recorder for the QPs solved by the back-ends: each
+     * call of record() appends H, g, A, lA, uA, l, u, the options and the solution of a BackEnd
+     * to a binary file.
+     *
+     * The file is preallocated and memory-mapped in the constructor, record() only copies the
+     * data in the mapped memory (no allocations, no system calls) and can be used in the control
+     * loop. When the file is full the new problems are dropped. The file is shrunk to the recorded
+     * data when the QPRecorder is destroyed, the recorded problems can be read with QPRecording.
+     *
+     * Usage:
+     *
+     *      QPRecorder::Ptr recorder(new QPRecorder("/tmp/robot.qpr", 512*1024*1024));
+     *      solver.setRecorder(recorder);
+     *
+     * see iHQP::setRecorder() and the opensot_replay_qp tool.
+     */
+    class QPRecorder {
+    public:
+        typedef boost::shared_ptr<QPRecorder> Ptr;
+
+        /**
+         * @brief The LevelInfo struct describes the level of the stack the recorded problem comes from,
+         * it is used to create the same back-end when the problem is replayed
+         */
+        struct LevelInfo
+        {
+            unsigned int level;
+            solver_back_ends back_end;
+            OpenSoT::HessianType hessian_type;
+            double eps_regularisation;
+        };
+
+        /**
+         * @brief QPRecorder constructor, creates (or truncates) the file and maps it in memory
+         * @param file_name of the recording
+         * @param capacity size of the file in bytes
+         */
+        QPRecorder(const std::string& file_name, const std::size_t capacity);
+
+        ~QPRecorder();
+
+        /**
+         * @brief record appends the problem currently stored in a back-end and its solution
+         * @param tick index of the control loop iteration
+         * @param level_info where the problem comes from
+         * @param back_end which solved the problem
+         * @param solved return value of BackEnd::solve()
+         * @param solve_time duration of BackEnd::solve() in seconds
+         * @return false if the file is full (the problem is dropped)
+         */
+        bool record(const unsigned long tick, const LevelInfo& level_info, BackEnd& back_end,
+                    const bool solved, const double solve_time);
+
+        /**
+         * @brief getNumberOfRecords
+         * @return number of problems recorded
+         */
+        unsigned long getNumberOfRecords() const;
+
+        /**
+         * @brief getNumberOfDroppedRecords
+         * @return number of problems which did not fit in the file
+         */
+        unsigned long getNumberOfDroppedRecords() const;
+
+        /**
+         * @brief getSize
+         * @return bytes used in the file
+         */
+        std::size_t getSize() const;
+
+        /**
+         * @brief getCapacity
+         * @return size of the file in bytes
+         */
+        std::size_t getCapacity() const {return _capacity;}
+
+    private:
+        QPRecorder(const QPRecorder&);
+        QPRecorder& operator=(const QPRecorder&);
+
+        std::string _file_name;
+        std::size_t _capacity;
+        int _fd;
+        char* _data;
+    };
+
+    /**
+     * @brief The QPRecording class reads the problems written by a QPRecorder
+     */
+    class QPRecording {
+    public:
+        typedef boost::shared_ptr<QPRecording> Ptr;
+
+        /**
+         * @brief The Problem struct is a recorded problem:
+         *
+         *      min = ||Hx - g||
+         *  st.     lA <= Ax <= uA
+         *           l <=  x <= u
+         */
+        struct Problem
+        {
+            unsigned long tick;
+            QPRecorder::LevelInfo level_info;
+            bool solved;
+            BackEnd::SolveInfo solve_info;
+            double solve_time;
+
+            Eigen::MatrixXd H;
+            Eigen::VectorXd g;
+            Eigen::MatrixXd A;
+            Eigen::VectorXd lA;
+            Eigen::VectorXd uA;
+            Eigen::VectorXd l;
+            Eigen::VectorXd u;
+            Eigen::VectorXd solution;
+
+            /**
+             * @brief options of the back-end, see BackEnd::writeOptions()
+             */
+            std::vector<char> options;
+        };
+
+        /**
+         * @brief QPRecording constructor, opens a file written by a QPRecorder
+         * @param file_name of the recording
+         */
+        QPRecording(const std::string& file_name);
+
+        /**
+         * @brief getNumberOfProblems
+         * @return number of recorded problems
+         */
+        unsigned long getNumberOfProblems() const {return _offsets.size();}
+
+        /**
+         * @brief read the index-th recorded problem
+         * @param index of the problem
+         * @param problem
+         * @return false if index is out of range
+         */
+        bool read(const unsigned long index, Problem& problem) const;
+
+    private:
+        std::vector<char> _data;
+        std::vector<std::size_t> _offsets;
+    };
+
+    }
+}
+
+#endif
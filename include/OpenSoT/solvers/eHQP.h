@@ -10,6 +10,8 @@
 #include <Eigen/LU>
 #endif
 
+#define PINV_LDLT_CONDITIONING 1E-8 //minimum ratio between the smallest and the largest pivot of JPJP' for PINV_LDLT
+
 namespace OpenSoT{
     namespace solvers{
     struct stack_level
@@ -26,6 +28,36 @@ namespace OpenSoT{
          * We compute W = LL' and then we multiply L'A and L'b
          */
         Eigen::LLT<Eigen::MatrixXd> _WChol;
+        /**
+         * @brief _JPJPt and _JPJPtLDLT are used by the PINV_LDLT strategy: JP^+ = JP'(JPJP')^-1
+         */
+        Eigen::MatrixXd _JPJPt;
+        Eigen::LDLT<Eigen::MatrixXd> _JPJPtLDLT;
+        /**
+         * @brief _W is the weight used to compute _WChol: the decomposition is computed again
+         * only when the weight of the task changes, and it is not used at all when the weight
+         * is the identity (_W_identity).
+         * _LA = L'A and _Lb = L'b are the weighted task matrices
+         */
+        Eigen::MatrixXd _W;
+        bool _W_identity;
+        Eigen::MatrixXd _LA;
+        Eigen::VectorXd _Lb;
+
+        /**
+         * @brief _Z is an orthonormal basis of the null-space of the levels up to this one
+         * (i.e. _P = _Z_Z'), used by the NULL_SPACE_BASIS decomposition together with the
+         * column pivoting QR _JZqr of (JZ)' and the temporaries below
+         */
+        Eigen::MatrixXd _Z;
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> _JZqr;
+        Eigen::LLT<Eigen::MatrixXd> _RRtChol;
+        Eigen::MatrixXd _R;
+        Eigen::MatrixXd _RRt;
+        Eigen::MatrixXd _ZQ;
+        Eigen::VectorXd _residual;
+        Eigen::VectorXd _w;
+        Eigen::VectorXd _y;
     };
     /**
      * @brief The eHQP class implements an equality Hierarchical QP solver as the one used in:
@@ -33,6 +65,25 @@ namespace OpenSoT{
      * by Fabrizio Flacco, Alessandro De Luca and Oussama Khatib
      *
      * NOTE: Here we do not take into account the c paramter in Task.h for Linear Programming!
+     *
+     * Two decompositions are available (see setDecomposition()):
+     *  - SVD (default): each level computes the damped pseudoinverse of JP through a JacobiSVD
+     *    and the n x n projector P of the levels solved so far,
+     *  - NULL_SPACE_BASIS: each level keeps an orthonormal basis Z of the null-space of the
+     *    previous levels and solves the k x m problem (JZ)'; (JZ)' is decomposed by a rank revealing
+     *    QR with column pivoting, which also gives the basis of the next level. The cost of each level
+     *    scales with the dimension of the remaining null-space instead of the number of variables
+     *    and no n x n matrix is formed. Singular directions (relative pivot below sigma_min) are
+     *    truncated instead of damped.
+     *
+     * With the SVD decomposition the pseudoinverse of JP can be computed (see setPinvStrategy()):
+     *  - PINV_SVD (default): by getDampedPinv(),
+     *  - PINV_LDLT: by the LDLT decomposition of the m x m matrix JPJP', i.e. JP^+ = JP'(JPJP')^-1.
+     *    This is much cheaper for the usual short and wide task Jacobians (e.g. 6 x 30) and gives the
+     *    same result of PINV_SVD when JP is well conditioned, since in that case no damping is
+     *    applied. When JP has more rows than columns or JPJP' is close to singular (the ratio
+     *    between the smallest and the largest pivot of the LDLT is below PINV_LDLT_CONDITIONING)
+     *    the level falls back to PINV_SVD.
      */
     class eHQP : public OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>
     {
@@ -81,6 +132,26 @@ namespace OpenSoT{
 
     public:
         typedef boost::shared_ptr<eHQP> Ptr;
+
+        /**
+         * @brief The Decomposition enum selects how each level is solved (see eHQP)
+         */
+        enum Decomposition
+        {
+            SVD,
+            NULL_SPACE_BASIS
+        };
+
+        /**
+         * @brief The PinvStrategy enum selects how the pseudoinverse of JP is computed by the
+         * SVD decomposition (see eHQP)
+         */
+        enum PinvStrategy
+        {
+            PINV_SVD,
+            PINV_LDLT
+        };
+
         /**
          * @brief creates a pseudoinverse solver for the current Stack
          */
@@ -96,7 +167,43 @@ namespace OpenSoT{
         
         double getSigmaMin() const;
         
-        void setSigmaMin(const double& sigma_min);        
+        void setSigmaMin(const double& sigma_min);
+
+        /**
+         * @brief setDecomposition select the decomposition used by the solver
+         * @param decomposition SVD or NULL_SPACE_BASIS
+         */
+        void setDecomposition(const Decomposition decomposition);
+
+        Decomposition getDecomposition() const;
+
+        /**
+         * @brief setPinvStrategy select how the pseudoinverse is computed by the SVD decomposition
+         * @param strategy PINV_SVD or PINV_LDLT
+         */
+        void setPinvStrategy(const PinvStrategy strategy);
+
+        PinvStrategy getPinvStrategy() const;
+
+    private:
+        Decomposition _decomposition;
+        PinvStrategy _pinv_strategy;
+
+        /**
+         * @brief computeLDLTPinv computes the pseudoinverse of JP of the i-th level through the LDLT
+         * decomposition of JPJP'
+         * @return false if JP is not suited for it (the pseudoinverse is not computed)
+         */
+        bool computeLDLTPinv(const unsigned int i);
+
+        /**
+         * @brief updateWeight computes L'A and L'b of the i-th level, the Cholesky decomposition
+         * of the weight is computed only if the weight changed since the last call
+         */
+        void updateWeight(const unsigned int i);
+
+        bool solveSVD(Eigen::VectorXd& solution);
+        bool solveNullSpaceBasis(Eigen::VectorXd& solution);
     };
 }
 }
@@ -25,7 +25,10 @@
 #include <OpenSoT/Solver.h>
 #include <OpenSoT/constraints/Aggregated.h>
 #include <OpenSoT/solvers/BackEndFactory.h>
+#include <OpenSoT/solvers/QPRecorder.h>
 #include <OpenSoT/utils/Piler.h>
+#include <OpenSoT/utils/WorkerPool.h>
+#include <OpenSoT/utils/RingBuffer.h>
 
 using namespace OpenSoT::utils;
 
@@ -42,6 +45,44 @@ namespace OpenSoT{
     public:
     typedef boost::shared_ptr<iHQP> Ptr;
     typedef MatrixPiler VectorPiler;
+
+        /**
+         * @brief The LevelTelemetry struct reports how a level has been solved in a call of solve()
+         */
+        struct LevelTelemetry
+        {
+            bool active;
+            bool solved;
+            /**
+             * @brief assembly_time time in seconds to compute the cost function and the constraints
+             * of the level and to pass them to the back-end
+             */
+            double assembly_time;
+            /**
+             * @brief solve_time time in seconds spent in BackEnd::solve()
+             */
+            double solve_time;
+            BackEnd::SolveInfo solve_info;
+            int number_of_variables;
+            int number_of_constraints;
+        };
+
+        /**
+         * @brief The Telemetry struct reports a call of solve()
+         */
+        struct Telemetry
+        {
+            /**
+             * @brief tick number of calls of solve() since the telemetry has been enabled
+             */
+            unsigned long tick;
+            double solve_time;
+            bool solved;
+            bool deadline_missed;
+            std::vector<LevelTelemetry> levels;
+        };
+
+        typedef RingBuffer<Telemetry> TelemetryBuffer;
         /**
          * @brief iHQP constructor of the problem
          * @param stack_of_tasks a vector of tasks
@@ -157,10 +198,150 @@ namespace OpenSoT{
          */
         bool getBackEnd(const unsigned int i, BackEnd::Ptr& back_end);
 
+        /**
+         * @brief setParallelAssembly enables the computation of the cost functions (H and g) and of the
+         * constraints of all the levels in parallel, before the cascade of QPs is solved.
+         * Each level is assembled in its own buffers so the result does not depend on the number of threads.
+         * NOTE: tasks and constraints which are shared among levels are only read during the assembly,
+         * the same task should not be used in two different levels.
+         * @param number_of_threads total number of threads used for the assembly (including the calling one),
+         * 0 or 1 disables the parallel assembly (default)
+         */
+        void setParallelAssembly(const unsigned int number_of_threads);
+
+        /**
+         * @brief getParallelAssembly
+         * @return number of threads used to assemble the levels, 1 if the parallel assembly is disabled
+         */
+        unsigned int getParallelAssembly();
+
+        /**
+         * @brief setTimeBudget set the time available for each call of solve(). Before solving a level the
+         * time left is shared equally among the active levels which still have to be solved and it is passed
+         * to the back-end (see BackEnd::setTimeBudget()). If a level can not be solved within its budget,
+         * solve() stops and returns the solution of the last solved level (see deadlineMissed()).
+         * The levels whose back-end does not support time limits are solved anyway but they are not bounded
+         * in time (see isTimeBounded()).
+         * @param time budget in seconds, a non positive value disables the deadline (default)
+         * @return false if some back-end does not support time limits
+         */
+        bool setTimeBudget(const double time);
+
+        /**
+         * @brief isTimeBounded
+         * @param i level
+         * @return true if the back-end of the i-th level enforces the time budget (see setTimeBudget())
+         */
+        bool isTimeBounded(const unsigned int i){return i < _time_bounded.size() && _time_bounded[i];}
+
+        /**
+         * @brief getTimeBudget
+         * @return time budget of solve() in seconds, non positive if disabled
+         */
+        double getTimeBudget(){return _time_budget;}
+
+        /**
+         * @brief deadlineMissed
+         * @return true if the last solve() stopped before the lowest priority level because the time
+         * budget was over, in this case the solution is the one of getLastSolvedLevel()
+         */
+        bool deadlineMissed(){return _deadline_missed;}
+
+        /**
+         * @brief getLastSolvedLevel
+         * @return the last level solved in the last solve(), -1 if none
+         */
+        int getLastSolvedLevel(){return _last_solved_level;}
+
+        /**
+         * @brief enableTelemetry makes solve() record a Telemetry for each call in a buffer which can be
+         * read from another thread (see getTelemetry() and OpenSoT::utils::RingBuffer). The buffer is
+         * allocated here, recording does not allocate.
+         * @param capacity number of calls of solve() kept in the buffer, 0 disables the telemetry
+         */
+        void enableTelemetry(const unsigned int capacity);
+
+        /**
+         * @brief getTelemetry
+         * @return the buffer with the telemetry of the last calls of solve(), empty if disabled
+         */
+        TelemetryBuffer::Ptr getTelemetry(){return _telemetry;}
+
+        /**
+         * @brief setRecorder makes solve() record the problem solved by each active level in a
+         * QPRecorder, the problems can be replayed offline with any back-end (see QPRecording)
+         * @param recorder an empty pointer disables the recording
+         */
+        void setRecorder(QPRecorder::Ptr recorder){_recorder = recorder;}
+
+        /**
+         * @brief getRecorder
+         * @return the recorder used by solve(), empty if the recording is disabled
+         */
+        QPRecorder::Ptr getRecorder(){return _recorder;}
+
+        /**
+         * @brief setWorkingSetTransfer when enabled, a level whose back-end is initialized again because
+         * its number of constraints changed does not start from an empty working set (see
+         * BackEnd::setWorkingSetGuess()): the bounds and the constraints it shares with the previous level
+         * (same constraint with the same number of rows) take the state found by the previous level in the
+         * current solve, the optimality constraints whose number of rows did not change keep the state of
+         * the last solution of the level.
+         * NOTE: it has effect only with back-ends using a working set (qpOASES)
+         * @param enable true to enable the transfer, disabled by default
+         */
+        void setWorkingSetTransfer(const bool enable){_working_set_transfer = enable;}
+
+        /**
+         * @brief getWorkingSetTransfer
+         * @return true if the working set is transferred when a back-end is initialized again
+         */
+        bool getWorkingSetTransfer(){return _working_set_transfer;}
+
     protected:
         virtual void _log(XBot::MatLogger::Ptr logger, const std::string& prefix);
 
+        /**
+         * @brief constraints_task the constraints of the tasks of each level
+         */
         vector <OpenSoT::constraints::Aggregated> constraints_task;
+
+        /**
+         * @brief _shared_constraints aggregates the global constraints and the bounds, which are the same for all
+         * the levels: they are generated once per solve by generateSharedConstraints() and their rows are written
+         * by each level after the ones of constraints_task
+         */
+        OpenSoT::constraints::Aggregated::Ptr _shared_constraints;
+        unsigned long _shared_version;
+        unsigned long _shared_matrix_version;
+
+        /**
+         * @brief generateSharedConstraints generates _shared_constraints and reads its versions, it has to be
+         * called before the levels are assembled
+         */
+        void generateSharedConstraints();
+
+        /**
+         * @brief _levels_lower_bound, _levels_upper_bound bounds of the levels whose tasks have bounds too,
+         * see getLevelLowerBound()
+         */
+        std::vector<Eigen::VectorXd> _levels_lower_bound;
+        std::vector<Eigen::VectorXd> _levels_upper_bound;
+
+        /**
+         * @brief mergeLevelBounds merges the bounds of the tasks of the i-th level with the shared ones
+         * @param i level
+         */
+        void mergeLevelBounds(const unsigned int i);
+
+        /**
+         * @brief hasLevelBounds, getLevelLowerBound, getLevelUpperBound: bounds of the i-th level, the shared ones
+         * if the tasks of the level have no bounds
+         * @param i level
+         */
+        bool hasLevelBounds(const unsigned int i);
+        const Eigen::VectorXd& getLevelLowerBound(const unsigned int i);
+        const Eigen::VectorXd& getLevelUpperBound(const unsigned int i);
         
         /**
          * @brief _qp_stack_of_tasks vector of QPOases Problem
@@ -184,10 +365,18 @@ namespace OpenSoT{
          * @brief computeCostFunction compute a cost function for velocity control:
          *          F = ||Jdq - v||
          * @param task to get Jacobian and reference
-         * @param H Hessian matrix computed as J'J
-         * @param g reference vector computed as J'v
+         * @param H Hessian matrix computed as J'J, it has to be already of the right size
+         * @param g reference vector computed as J'v, it has to be already of the right size
+         */
+        void computeCostFunction(const TaskPtr& task, Eigen::Ref<Eigen::MatrixXd> H, Eigen::Ref<Eigen::VectorXd> g);
+
+        /**
+         * @brief computeGradient compute only the reference vector of the cost function (see computeCostFunction()),
+         * it is used when the Hessian of the task did not change
+         * @param task to get Jacobian and reference
+         * @param g reference vector computed as J'v, it has to be already of the right size
          */
-        void computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::VectorXd& g);
+        void computeGradient(const TaskPtr& task, Eigen::Ref<Eigen::VectorXd> g);
 
         /**
          * @brief computeOptimalityConstraint compute optimality constraint for velocity control:
@@ -202,6 +391,92 @@ namespace OpenSoT{
                                          Eigen::MatrixXd& A,
                                          Eigen::VectorXd& lA, Eigen::VectorXd& uA);
 
+        /**
+         * @brief updateOptimalityConstraint computes and stores the optimality constraint of the i-th level,
+         * it is called once per solve right after the i-th level is solved (or skipped if not active) so that
+         * all the lower priority levels just pile the stored tmp_A[i], tmp_lA[i] and tmp_uA[i]
+         * @param i level
+         */
+        void updateOptimalityConstraint(const unsigned int i);
+
+        /**
+         * @brief assembleLevel computes the cost function of the i-th level directly in its back-end
+         * (see BackEnd::getHView()) and generates its constraints, it does not depend on the solution
+         * of the other levels
+         * @param i level
+         */
+        void assembleLevel(const unsigned int i);
+
+        /**
+         * @brief updateConstraints writes the constraints of the i-th level (task constraints, shared constraints
+         * and optimality constraints of the previous levels) in its back-end. If the number of constraints did not change
+         * they are written in place, otherwise they are piled and passed with BackEnd::updateConstraints().
+         * When written in place, the constraint matrix is written only if it changed since the last solve
+         * (see LevelVersions)
+         * @param i level
+         * @return true if the constraints are correctly updated
+         */
+        bool updateConstraints(const unsigned int i);
+
+        /**
+         * @brief commitLevel passes the data assembled by assembleLevel() to the back-end of the i-th level,
+         * the parts which did not change since the last solve are not passed again
+         * @param i level
+         * @return true if the back-end is correctly updated
+         */
+        bool commitLevel(const unsigned int i);
+
+        /**
+         * @brief The RowsBlock struct describes a block of consecutive rows of the constraints of a level:
+         * owner is the constraint which generates them or, for the optimality constraints, the task
+         */
+        struct RowsBlock
+        {
+            const void* owner;
+            unsigned int rows;
+        };
+
+        /**
+         * @brief computeRowsLayout computes the blocks of rows of the constraints of the i-th level,
+         * in the same order used by updateConstraints()
+         * @param i level
+         * @param layout blocks of rows
+         */
+        void computeRowsLayout(const unsigned int i, std::vector<RowsBlock>& layout);
+
+        /**
+         * @brief transferWorkingSet sets the working set guess of the back-end of the i-th level before it
+         * is initialized again, see setWorkingSetTransfer()
+         * @param i level
+         */
+        void transferWorkingSet(const unsigned int i);
+
+        /**
+         * @brief stopAtDeadline stops the solve when the time budget is over at the i-th level
+         * @param i level
+         * @return true if at least one level has been solved
+         */
+        bool stopAtDeadline(const unsigned int i);
+
+        /**
+         * @brief outOfTime checks if the failure of the i-th level is due to its time budget
+         * @param i level
+         * @param level_time time spent by the level since its budget was set
+         * @param level_budget time budget of the level
+         * @return true if the back-end stopped at its time limit or the level used the whole budget
+         */
+        bool outOfTime(const unsigned int i, const double level_time, const double level_budget);
+
+        /**
+         * @brief solveLevels solves the levels, see solve()
+         */
+        bool solveLevels(Eigen::VectorXd& solution);
+
+        /**
+         * @brief _assembly_pool used to assemble the levels in parallel, empty if parallel assembly is disabled
+         */
+        WorkerPool::Ptr _assembly_pool;
+        WorkerPool::Job _assembly_job;
 
 
         Eigen::MatrixXd H;
@@ -214,13 +489,86 @@ namespace OpenSoT{
         Eigen::VectorXd l;
         Eigen::VectorXd u;
         
+        /**
+         * @brief tmp_A, tmp_lA and tmp_uA store the optimality constraints of each level (except the last one)
+         * computed in the current solve, _optimality_versions[i] is increased when tmp_A[i] changes
+         */
         std::vector<Eigen::MatrixXd> tmp_A;
         std::vector<Eigen::VectorXd> tmp_lA;
         std::vector<Eigen::VectorXd> tmp_uA;
+        std::vector<unsigned long> _optimality_versions;
+
+        /**
+         * @brief The LevelVersions struct stores the versions (see Task::getVersion() and
+         * Constraint::getVersion()) of the data of a level: the parts of the problem which did not
+         * change since they were passed to the back-end are neither computed nor passed again
+         */
+        struct LevelVersions
+        {
+            /**
+             * @brief valid false if the data of the level has to be passed to the back-end anyway
+             */
+            bool valid;
+            unsigned long task;
+            unsigned long task_matrix;
+            unsigned long constraints;
+            unsigned long constraints_matrix;
+            /**
+             * @brief shared, shared_matrix versions of the shared constraints (see _shared_constraints)
+             */
+            unsigned long shared;
+            unsigned long shared_matrix;
+            /**
+             * @brief optimality_matrix versions of the optimality constraints of the previous levels
+             */
+            std::vector<unsigned long> optimality_matrix;
+        };
+
+        /**
+         * @brief _committed_versions are the versions of the data passed to the back-ends,
+         * _assembled_versions the ones of the data assembled in the current solve
+         */
+        std::vector<LevelVersions> _committed_versions;
+        std::vector<LevelVersions> _assembled_versions;
 
 
         std::vector<solver_back_ends> _be_solver;
 
+        /**
+         * @brief _time_budget time available for solve() in seconds (non positive: no deadline)
+         */
+        double _time_budget;
+        /**
+         * @brief _time_bounded true for the levels whose back-end enforces the time budget
+         */
+        std::vector<bool> _time_bounded;
+        int _last_solved_level;
+        bool _deadline_missed;
+
+        /**
+         * @brief _telemetry buffer, empty if the telemetry is disabled. _tick_telemetry is the
+         * element written by the current solve(), NULL outside of it.
+         * _assembly_time stores the time spent by assembleLevel() for each level
+         */
+        TelemetryBuffer::Ptr _telemetry;
+        Telemetry* _tick_telemetry;
+        unsigned long _telemetry_ticks;
+        std::vector<double> _assembly_time;
+
+        /**
+         * @brief _recorder of the problems, empty if the recording is disabled.
+         * _recorder_ticks counts the calls of solve() while recording
+         */
+        QPRecorder::Ptr _recorder;
+        unsigned long _recorder_ticks;
+
+        /**
+         * @brief _working_set_transfer see setWorkingSetTransfer(), _rows_layout stores the blocks of rows
+         * of the constraints last passed to each back-end
+         */
+        bool _working_set_transfer;
+        std::vector<std::vector<RowsBlock> > _rows_layout;
+
 
     };
 
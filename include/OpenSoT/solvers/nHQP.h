@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _WB_SOT_SOLVERS_NHQP_H_
+#define _WB_SOT_SOLVERS_NHQP_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Dense>
+#include <OpenSoT/Task.h>
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/constraints/Aggregated.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/utils/Piler.h>
+
+using namespace OpenSoT::utils;
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The nHQP class implements a hierarchical solver in which each level is solved in the null-space
+     * of the higher priority tasks. After the i-th level is solved, an orthonormal basis N_i of the null-space
+     * of the stacked task matrices A_0..A_i is computed and the next level is solved in the reduced variables z:
+     *
+     *      x = x_i + N_i z
+     *
+     * so that A_j x = A_j x_i for all j <= i holds by construction. Differently from iHQP, the optimality
+     * constraints are not appended to the following levels: each QP has fewer variables and the number of
+     * constraints does not grow with the level.
+     *
+     * Bounds and constraints (task, global and bounds) are mapped in the reduced variables:
+     *
+     *      lA - A x_i <= A N_i z <= uA - A x_i
+     *      l - x_i <= N_i z <= u - x_i
+     *
+     * NOTE: when N_i is not the identity, bounds are passed to the back-end as generic constraints.
+     * NOTE: when the dimension of the null-space changes (e.g. a task becomes singular) the back-end
+     * of the level is created and initialized again.
+     */
+    class nHQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
+    {
+    public:
+    typedef boost::shared_ptr<nHQP> Ptr;
+    typedef MatrixPiler VectorPiler;
+
+        /**
+         * @brief nHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized
+         */
+        nHQP(Stack& stack_of_tasks, const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        /**
+         * @brief nHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param bounds a vector of bounds passed to all the stacks
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized
+         */
+        nHQP(Stack& stack_of_tasks,
+             ConstraintPtr bounds,
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        /**
+         * @brief nHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param bounds a vector of bounds passed to all the stacks
+         * @param globalConstraints a vector of constraints passed to all the stacks
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized
+         */
+        nHQP(Stack& stack_of_tasks,
+             ConstraintPtr bounds,
+             ConstraintPtr globalConstraints,
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        ~nHQP(){}
+
+        /**
+         * @brief solve a stack of tasks
+         * @param solution vector
+         * @return true if all the stack is solved
+         */
+        bool solve(Eigen::VectorXd& solution);
+
+        /**
+         * @brief getNumberOfTasks
+         * @return lenght of the stack
+         */
+        unsigned int getNumberOfTasks(){return _tasks.size();}
+
+        /**
+         * @brief setOptions set option to a particular task
+         * @param i number of stack to set the option
+         * @param opt options for task i
+         * @return false if i-th problem does not exists
+         */
+        bool setOptions(const unsigned int i, const boost::any &opt);
+
+        /**
+         * @brief getOptions return the options of the i-th qp problem
+         * @param i number of stack to get the option
+         * @param opt a data structure which has to be converted to particular structure used by the BackEnd implementation
+         * @return false if i-th problem does not exists
+         */
+        bool getOptions(const unsigned int i, boost::any& opt);
+
+        /**
+         * @brief getObjective return the value of the objective function at the optimum for the i-th qp problem
+         * @param i number of stack to get the value of the objective function
+         * @param val value of the objective function at the optimum
+         * @return false if i-th problem does not exists
+         */
+        bool getObjective(const unsigned int i, double& val);
+
+        /**
+         * @brief setActiveStack select a stack to do not solve
+         * @param i stack index
+         * @param flag true or flase
+         */
+        void setActiveStack(const unsigned int i, const bool flag);
+
+        /**
+         * @brief activateAllStacks activate all stacks
+         */
+        void activateAllStacks();
+
+        /**
+         * @brief getBackEndName retrieve the name of the solver
+         * @param i priority level
+         * @return a string with the name of the solver
+         */
+        std::string getBackEndName(const unsigned int i);
+
+        /**
+         * @brief getBackEnd retrieve the back-end associated to the i-th qp problem
+         * @param i priority level
+         * @param back_end
+         * @return false if the level does not exists
+         */
+        bool getBackEnd(const unsigned int i, BackEnd::Ptr& back_end);
+
+        /**
+         * @brief getNullSpaceBasis return the basis N_i used to solve the i-th level
+         * (N_0 is the identity)
+         * @param i priority level
+         * @param N basis of the null-space of the tasks 0..i-1
+         * @return false if the level does not exists
+         */
+        bool getNullSpaceBasis(const unsigned int i, Eigen::MatrixXd& N);
+
+        /**
+         * @brief setNullSpaceThreshold set the threshold used to compute the rank of the projected task matrices
+         * (see Eigen::ColPivHouseholderQR::setThreshold())
+         * @param threshold a positive number
+         */
+        void setNullSpaceThreshold(const double threshold);
+
+        /**
+         * @brief getNullSpaceThreshold
+         * @return the threshold used to compute the rank of the projected task matrices
+         */
+        double getNullSpaceThreshold(){return _null_space_threshold;}
+
+    protected:
+        virtual void _log(XBot::MatLogger::Ptr logger, const std::string& prefix);
+
+        vector <OpenSoT::constraints::Aggregated> constraints_task;
+
+        /**
+         * @brief _qp_stack_of_tasks vector of back-ends, one for each level
+         */
+        vector <BackEnd::Ptr> _qp_stack_of_tasks;
+
+        vector<bool> _active_stacks;
+
+        std::vector<solver_back_ends> _be_solver;
+
+        /**
+         * @brief _epsRegularisation regularisation factor for dumped least squares
+         */
+        double _epsRegularisation;
+
+        /**
+         * @brief _null_space_threshold threshold used to compute the rank of the projected tasks
+         */
+        double _null_space_threshold;
+
+        /**
+         * @brief prepareSoT initialize the complete stack
+         * @return true if stack is correctly initialized
+         */
+        bool prepareSoT();
+
+        /**
+         * @brief solveLevel solve the i-th level in the null-space of the previous levels
+         * @param i level
+         * @param x solution of the previous levels, updated with the solution of the i-th level
+         * @return true if the level is solved
+         */
+        bool solveLevel(const unsigned int i, Eigen::VectorXd& x);
+
+        /**
+         * @brief computeCostFunction compute the cost function in the reduced variables:
+         *          F = ||A(x + Nz) - b||_W
+         * @param task to get Jacobian and reference
+         * @param N basis of the null-space
+         * @param x solution of the previous levels
+         * @param H Hessian matrix computed as N'A'WAN
+         * @param g reference vector computed as N'A'W(Ax - b) + N'c
+         */
+        void computeCostFunction(const TaskPtr& task, const Eigen::MatrixXd& N, const Eigen::VectorXd& x,
+                                 Eigen::MatrixXd& H, Eigen::VectorXd& g);
+
+        /**
+         * @brief computeNullSpaceBasis computes N_next = N * null(AN)
+         * @param AN task matrix projected in the null-space of the previous levels
+         * @param N basis of the null-space of the previous levels
+         * @param N_next basis of the null-space used at the next level
+         */
+        void computeNullSpaceBasis(const Eigen::MatrixXd& AN, const Eigen::MatrixXd& N, Eigen::MatrixXd& N_next);
+
+        /**
+         * @brief _N basis of the null-space used at each level
+         */
+        std::vector<Eigen::MatrixXd> _N;
+
+        Eigen::MatrixXd H;
+        Eigen::VectorXd g;
+
+        MatrixPiler A;
+        VectorPiler lA;
+        VectorPiler uA;
+
+        Eigen::VectorXd l;
+        Eigen::VectorXd u;
+
+        Eigen::MatrixXd _AN;
+        Eigen::MatrixXd _WAN;
+        Eigen::VectorXd _residual;
+        Eigen::VectorXd _x;
+
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> _qr;
+    };
+
+    }
+}
+
+#endif
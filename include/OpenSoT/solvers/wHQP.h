@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _WB_SOT_SOLVERS_WHQP_H_
+#define _WB_SOT_SOLVERS_WHQP_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Dense>
+#include <OpenSoT/Task.h>
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/utils/Piler.h>
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The wHQP class implements a "soft" hierarchy: the first strict_levels levels of the stack
+     * are solved with strict priorities as in iHQP, while the remaining levels are flattened in a single
+     * level whose cost is the weighted sum of their costs:
+     *
+     *      sum_i w_i ||A_i x - b_i||_W_i + w_i c_i'x
+     *
+     * so that a stack of L levels is solved by strict_levels + 1 QPs (a single QP when strict_levels
+     * is 0) instead of L. The constraints of the flattened tasks are constraints of the flattened level.
+     * The weights w_i are the scale factors of the lower levels: the priorities among them are only
+     * approximated, the larger the ratio between consecutive weights the closer the solution to
+     * the one of iHQP.
+     *
+     * The tasks are not updated by the solver: as for iHQP, they have to be updated before solve().
+     */
+    class wHQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
+    {
+    public:
+    typedef boost::shared_ptr<wHQP> Ptr;
+
+        /**
+         * @brief wHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param weights scale factors of the flattened levels, one for each level after the strict ones
+         * @param strict_levels number of levels solved with strict priorities
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized or the weights are not valid
+         */
+        wHQP(Stack& stack_of_tasks, const std::vector<double>& weights, const unsigned int strict_levels = 0,
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        /**
+         * @brief wHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param bounds a vector of bounds passed to all the stacks
+         * @param weights scale factors of the flattened levels, one for each level after the strict ones
+         * @param strict_levels number of levels solved with strict priorities
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized or the weights are not valid
+         */
+        wHQP(Stack& stack_of_tasks,
+             ConstraintPtr bounds,
+             const std::vector<double>& weights, const unsigned int strict_levels = 0,
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        /**
+         * @brief wHQP constructor of the problem
+         * @param stack_of_tasks a vector of tasks
+         * @param bounds a vector of bounds passed to all the stacks
+         * @param globalConstraints a vector of constraints passed to all the stacks
+         * @param weights scale factors of the flattened levels, one for each level after the strict ones
+         * @param strict_levels number of levels solved with strict priorities
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         * @throw exception if the stack can not be initialized or the weights are not valid
+         */
+        wHQP(Stack& stack_of_tasks,
+             ConstraintPtr bounds,
+             ConstraintPtr globalConstraints,
+             const std::vector<double>& weights, const unsigned int strict_levels = 0,
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        ~wHQP(){}
+
+        /**
+         * @brief solve a stack of tasks
+         * @param solution vector
+         * @return true if all the levels are solved
+         */
+        bool solve(Eigen::VectorXd& solution);
+
+        /**
+         * @brief getNumberOfTasks
+         * @return lenght of the stack
+         */
+        unsigned int getNumberOfTasks(){return _tasks.size();}
+
+        /**
+         * @brief getStrictLevels
+         * @return number of levels solved with strict priorities
+         */
+        unsigned int getStrictLevels(){return _strict_levels;}
+
+        /**
+         * @brief setWeight set the scale factor of a flattened level
+         * @param i level of the stack
+         * @param weight a positive scale factor
+         * @return false if the i-th level is not flattened or the weight is not positive
+         */
+        bool setWeight(const unsigned int i, const double weight);
+
+        /**
+         * @brief getWeight
+         * @param i level of the stack
+         * @param weight scale factor of the i-th level
+         * @return false if the i-th level is not flattened
+         */
+        bool getWeight(const unsigned int i, double& weight);
+
+        /**
+         * @brief getiHQP return the iHQP which solves the strict levels and the flattened one (the last),
+         * it can be used to set the options of the back-ends, the time budget, the telemetry, ...
+         * @return the solver
+         */
+        const iHQP::Ptr& getiHQP(){return _solver;}
+
+    protected:
+        virtual void _log(XBot::MatLogger::Ptr logger, const std::string& prefix);
+
+        /**
+         * @brief The FlattenedLevel class piles the flattened tasks in a single task with the block diagonal
+         * weight diag(w_i W_i) and c = sum_i w_i c_i. The tasks are piled by generate() and not updated.
+         */
+        class FlattenedLevel: public Task<Eigen::MatrixXd, Eigen::VectorXd>
+        {
+        public:
+            typedef boost::shared_ptr<FlattenedLevel> Ptr;
+
+            FlattenedLevel(const std::vector<TaskPtr>& tasks, const std::vector<double>& weights);
+
+            /**
+             * @brief generate piles A, b, c and the weight of the tasks
+             */
+            void generate();
+
+            std::vector<double>& getWeights(){return _weights;}
+
+        protected:
+            virtual void _update(const Eigen::VectorXd& x){generate();}
+
+            std::vector<TaskPtr> _flattened_tasks;
+            std::vector<double> _weights;
+
+            utils::MatrixPiler _A_piler;
+            utils::MatrixPiler _b_piler;
+        };
+
+        /**
+         * @brief init creates the flattened level and the iHQP
+         * @param weights scale factors of the flattened levels
+         * @param eps_regularisation regularisation factor
+         * @param be_solver back-end used for all the levels
+         */
+        void init(const std::vector<double>& weights, const double eps_regularisation,
+                  const solver_back_ends be_solver);
+
+        unsigned int _strict_levels;
+
+        /**
+         * @brief _levels the strict levels followed by the flattened one, solved by _solver
+         */
+        Stack _levels;
+        FlattenedLevel::Ptr _flattened_level;
+        iHQP::Ptr _solver;
+    };
+
+    }
+}
+
+#endif
@@ -53,6 +53,14 @@ using namespace OpenSoT::utils;
             MatrixPiler _tmpA;
             VectorPiler _tmpb;
 
+            /**
+             * @brief _tasks_versions and _tasks_matrix_versions store the versions of the tasks (see
+             * Task::getVersion() and Task::getMatrixVersion()) used by the last generateAll(), the rows
+             * W_i*A_i and W_i*b_i are piled again only if some task changed
+             */
+            std::vector<unsigned long> _tasks_versions;
+            std::vector<unsigned long> _tasks_matrix_versions;
+
             unsigned int _aggregationPolicy;
 
             void generateAll();
@@ -96,6 +104,13 @@ using namespace OpenSoT::utils;
              */
             HessianType computeHessianType();
 
+            /**
+             * @brief computeJacobianStructure compute the structure of the Aggregated Jacobian, which piles
+             * the rows W_i*A_i of the tasks: the rows of identity or selection Jacobians with a diagonal weight
+             * are a selection, block sparse Jacobians give a block sparse Jacobian with the union of the blocks
+             */
+            void computeJacobianStructure();
+
             void checkSizes();
 
             static const std::string concatenateTaskIds(const std::list<TaskPtr> tasks);
@@ -89,7 +89,6 @@ class GenericTask: public Task<Eigen::MatrixXd, Eigen::VectorXd> {
 
 private:
     AffineHelper _var;
-    AffineHelper _task;
 
     Eigen::MatrixXd __A;
     Eigen::VectorXd __b;
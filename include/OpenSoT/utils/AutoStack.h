@@ -90,8 +90,7 @@ namespace OpenSoT {
              * @param aggregationPolicy the new aggregation policy for this AutoStack's bounds
              */
             void setBoundsAggregationPolicy(const unsigned int aggregationPolicy =
-                OpenSoT::constraints::Aggregated::EQUALITIES_TO_INEQUALITIES |
-                OpenSoT::constraints::Aggregated::UNILATERAL_TO_BILATERAL);
+                OpenSoT::constraints::Aggregated::NATIVE_BILATERAL);
 
             OpenSoT::constraints::Aggregated::ConstraintPtr getBounds();
 
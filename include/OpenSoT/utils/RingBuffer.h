@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _OPENSOT_UTILS_RING_BUFFER_H_
+#define _OPENSOT_UTILS_RING_BUFFER_H_
+
+#include <atomic>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The RingBuffer class stores the last capacity elements written by a single writer
+     * thread, which can be read by any number of reader threads without locking.
+     *
+     * The elements are preallocated from a prototype and overwritten in place, so that writing
+     * does not allocate as long as the assignment of T does not (e.g. std::vector members must
+     * keep their size). Each slot is protected by a sequence counter: the writer never waits and
+     * a reader that overlaps a write of the same slot simply fails and can retry.
+     *
+     * Usage (writer):
+     *
+     *      T& data = buffer.beginWrite();
+     *      data.x = ...;
+     *      buffer.endWrite();
+     *
+     * Usage (reader):
+     *
+     *      T data = prototype;
+     *      if(buffer.readLatest(data)) ...
+     */
+    template <typename T>
+    class RingBuffer {
+
+    public:
+        typedef boost::shared_ptr<RingBuffer> Ptr;
+
+        /**
+         * @brief RingBuffer constructor
+         * @param capacity number of elements stored, at least 1
+         * @param prototype used to preallocate all the elements
+         */
+        RingBuffer(const unsigned int capacity, const T& prototype):
+            _slots(capacity > 0 ? capacity : 1),
+            _writes(0)
+        {
+            for(unsigned int i = 0; i < _slots.size(); ++i)
+            {
+                _slots[i].data = prototype;
+                _slots[i].sequence.store(0);
+            }
+        }
+
+        /**
+         * @brief beginWrite starts to write the next element (writer thread only)
+         * @return the element to fill, it contains an old element
+         */
+        T& beginWrite()
+        {
+            const unsigned long index = _writes.load(std::memory_order_relaxed);
+            Slot& slot = _slots[index % _slots.size()];
+            slot.sequence.store(2*index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            return slot.data;
+        }
+
+        /**
+         * @brief endWrite publishes the element filled after beginWrite() (writer thread only)
+         */
+        void endWrite()
+        {
+            const unsigned long index = _writes.load(std::memory_order_relaxed);
+            _slots[index % _slots.size()].sequence.store(2*index + 2, std::memory_order_release);
+            _writes.store(index + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief read copies the index-th element written since the construction
+         * @param index of the element
+         * @param data copy of the element
+         * @return false if the element has not been written yet, has been overwritten or
+         * has been written while copying it (data is not valid)
+         */
+        bool read(const unsigned long index, T& data) const
+        {
+            if(index >= _writes.load(std::memory_order_acquire))
+                return false;
+
+            const Slot& slot = _slots[index % _slots.size()];
+            const unsigned long sequence = 2*index + 2;
+            if(slot.sequence.load(std::memory_order_acquire) != sequence)
+                return false;
+
+            data = slot.data;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.sequence.load(std::memory_order_relaxed) == sequence;
+        }
+
+        /**
+         * @brief readLatest copies the last element written
+         * @param data copy of the element
+         * @return false if nothing has been written yet or if the copy failed (see read())
+         */
+        bool readLatest(T& data) const
+        {
+            const unsigned long writes = _writes.load(std::memory_order_acquire);
+            if(writes == 0)
+                return false;
+            return read(writes - 1, data);
+        }
+
+        /**
+         * @brief getNumberOfWrites
+         * @return number of elements written since the construction, the last one has index
+         * getNumberOfWrites()-1
+         */
+        unsigned long getNumberOfWrites() const {return _writes.load(std::memory_order_acquire);}
+
+        /**
+         * @brief getCapacity
+         * @return number of elements stored
+         */
+        unsigned int getCapacity() const {return _slots.size();}
+
+    private:
+        struct Slot
+        {
+            /**
+             * @brief sequence is odd while the slot is written, 2*index+2 when the index-th
+             * element is available
+             */
+            std::atomic<unsigned long> sequence;
+            T data;
+        };
+
+        std::vector<Slot> _slots;
+        std::atomic<unsigned long> _writes;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _OPENSOT_UTILS_WORKER_POOL_H_
+#define _OPENSOT_UTILS_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The WorkerPool class keeps a fixed number of threads alive and uses them to run
+     * a set of independent jobs. The thread calling run() takes part in the computation and
+     * returns when all the jobs are done. Jobs are indexed, so that each of them can write
+     * its own output buffer: the result does not depend on which thread runs which job.
+     */
+    class WorkerPool {
+
+    public:
+        typedef boost::shared_ptr<WorkerPool> Ptr;
+        typedef std::function<void(const unsigned int)> Job;
+
+        /**
+         * @brief WorkerPool constructor
+         * @param number_of_threads total number of threads used by run(), including the calling one
+         */
+        WorkerPool(const unsigned int number_of_threads);
+
+        ~WorkerPool();
+
+        /**
+         * @brief run calls job(i) for i = 0..number_of_jobs-1 and waits until all of them are done
+         * @param number_of_jobs
+         * @param job function to call, it has to be thread safe for different indices
+         */
+        void run(const unsigned int number_of_jobs, const Job& job);
+
+        /**
+         * @brief getNumberOfThreads
+         * @return the total number of threads used by run(), including the calling one
+         */
+        unsigned int getNumberOfThreads() const {return _workers.size() + 1;}
+
+    private:
+        void work();
+        void process();
+
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _start;
+        std::condition_variable _done;
+
+        const Job* _job;
+        unsigned int _number_of_jobs;
+        std::atomic<unsigned int> _next_job;
+        unsigned int _busy_workers;
+        unsigned long _generation;
+        bool _stop;
+    };
+
+} }
+
+#endif
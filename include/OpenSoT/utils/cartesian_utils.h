@@ -361,6 +361,19 @@ public:
                                       Eigen::VectorXd& position_error,
                                       Eigen::VectorXd& orientation_error);
 
+    /**
+     * @brief computeCartesianError orientation and position error, it does not allocate when the errors
+     * have already size 3 (e.g. in the update of the Cartesian task)
+     * @param T actual pose Homogeneous Matrix
+     * @param Td desired pose Homogeneous Matrix
+     * @param position_error position error [3x1]
+     * @param orientation_error orientation error [3x1]
+     */
+    static void computeCartesianError(const Eigen::Matrix4d &T,
+                                      const Eigen::Matrix4d &Td,
+                                      Eigen::VectorXd& position_error,
+                                      Eigen::VectorXd& orientation_error);
+
     /**
      * @brief computeGradient compute numerical gradient of a function using 2 points formula:
      *
@@ -20,11 +20,13 @@
 #ifndef _COLLISION_UTILS_H_
 #define _COLLISION_UTILS_H_
 
+#include <Eigen/Dense>
 #include <kdl/frames.hpp>
 #include <limits>
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 #include <XBotInterface/ModelInterface.h>
 #include <srdfdom_advr/model.h>
 #include <fcl/collision_object.h>
@@ -49,9 +51,12 @@
  *        in the respective link frame reference system of the minimum distance point
  *        in each shape.
  */
+class ComputeLinksDistance;
+
 class LinkPairDistance {
 public:
     typedef std::pair<std::string, std::string> LinksPair;
+    friend class ComputeLinksDistance;
 private:
     /**
      * @brief linkPair the pair of link names in alphabetic order
@@ -71,6 +76,17 @@ private:
      */
     double distance;
 
+    /**
+     * @brief setClosestPoints updates in place the closest points and the distance of the link pair
+     * @param link1 the first link name, the frames are swapped as in the constructor
+     * @param link1_T_closestPoint1 the transform from the first link frame to the closest point on its shape
+     * @param link2_T_closesPoint2 the transform from the second link frame to the closest point on its shape
+     * @param distance the distance between the two minimum distance points
+     */
+    void setClosestPoints(const std::string& link1,
+                          const KDL::Frame& link1_T_closestPoint1, const KDL::Frame& link2_T_closestPoint2,
+                          const double& distance);
+
 public:
     /**
      * @brief LinkPairDistance creates an instance of a link pair distance data structure
@@ -146,6 +162,49 @@ public:
         void getEndPoints(KDL::Vector& ep1, KDL::Vector& ep2) { ep1 = this->ep1; ep2 = this->ep2; }
     };
 
+    /**
+     * @brief The CapsulePairs class computes the distance and the closest points of a batch of capsule pairs
+     *        in closed form: the distance between the capsule segments minus the radii. The batch is
+     *        allocated once, one row per pair, so that all the capsule pairs are computed in a single loop
+     *        without calling fcl::distance.
+     */
+    class CapsulePairs {
+    public:
+        typedef Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> Points;
+
+        /**
+         * @brief resize allocates the batch, computeDistances() does not allocate
+         * @param pairs number of capsule pairs
+         */
+        void resize(const unsigned int pairs);
+
+        /**
+         * @brief size
+         * @return number of capsule pairs
+         */
+        unsigned int size() const { return distance.size(); }
+
+        /**
+         * @brief computeDistances computes distance, closestPointA and closestPointB from the end-points,
+         *        the axes and the radii of the capsules
+         */
+        void computeDistances();
+
+        /**
+         * @brief ep1A, ep1B the end-point number 1 of the capsules, axisA, axisB the vectors from the
+         *        end-point number 1 to the end-point number 2
+         */
+        Points ep1A, axisA, ep1B, axisB;
+        Eigen::VectorXd radiusA, radiusB;
+
+        /**
+         * @brief closestPointA, closestPointB the closest points on the capsule surfaces,
+         *        distance the distance between the capsules (negative if they intersect)
+         */
+        Points closestPointA, closestPointB;
+        Eigen::VectorXd distance;
+    };
+
     class LinksPair {
     public:
         std::string linkA;
@@ -290,6 +349,30 @@ private:
      */
     std::list< ComputeLinksDistance::LinksPair > pairsToCheck;
 
+    /**
+     * @brief capsulePairs the pairs of pairsToCheck where both links are capsules, in the same order:
+     *        their distances are computed by CapsulePairs::computeDistances() instead of fcl::distance
+     */
+    ComputeLinksDistance::CapsulePairs capsulePairs;
+
+    /**
+     * @brief linkPairDistances one LinkPairDistance for each pair of pairsToCheck, in the same order:
+     *        it is updated in place by computeLinkDistances()
+     */
+    std::vector<LinkPairDistance> linkPairDistances;
+
+    /**
+     * @brief boundingSpheresDistance is the broad phase of getLinkDistances: it returns the distance between
+     *        the bounding spheres of the two collision geometries (aabb_center, aabb_radius) at their current
+     *        transforms. It is a lower bound of the distance between the shapes, so that pairs whose
+     *        bounding spheres are farther than the detection threshold are not checked by fcl::distance
+     * @param collObj_shapeA the first collision object
+     * @param collObj_shapeB the second collision object
+     * @return the distance between the bounding spheres, negative if they intersect
+     */
+    static double boundingSpheresDistance(const fcl::CollisionObject& collObj_shapeA,
+                                          const fcl::CollisionObject& collObj_shapeB);
+
     /**
      * @brief loadDisabledCollisionsFromSRDF disabled collisions between links as specified in the robot srdf.
      *        Notice this function will not reset the acm, rather just disable collisions that are flagged as
@@ -310,11 +393,24 @@ public:
      * @brief getLinkDistances returns a list of distances between all link pairs which are enabled for checking.
      *                         If detectionThreshold is not infinity, the list will be clamped to contain only
      *                         the pairs whose distance is smaller than the detection threshold.
+     *                         The distance between two capsules is computed in closed form (see CapsulePairs),
+     *                         fcl is used for the other shapes: if the threshold is not infinity, these pairs
+     *                         are discarded before calling fcl when their bounding spheres are farther than it.
      * @param detectionThreshold the maximum distance which we use to look for link pairs.
      * @return a sorted list of linkPairDistances
      */
     std::list<LinkPairDistance> getLinkDistances(double detectionThreshold = std::numeric_limits<double>::infinity());
 
+    /**
+     * @brief computeLinkDistances is the version of getLinkDistances which does not allocate (besides fcl::distance,
+     *                             which is not called on the capsule pairs): the distances are updated in place
+     *                             and they are not sorted
+     * @param detectionThreshold the maximum distance which we use to look for link pairs.
+     * @return one linkPairDistance for each link pair which is enabled for checking, always in the same order:
+     *         the pairs which are not closer than detectionThreshold have an infinite distance
+     */
+    const std::vector<LinkPairDistance>& computeLinkDistances(double detectionThreshold = std::numeric_limits<double>::infinity());
+
     /**
      * @brief setCollisionWhiteList resets the allowed collision matrix by setting all collision pairs as disabled.
      *        It then enables all collision pairs specified in the whiteList. Lastly it will disable all collision pairs
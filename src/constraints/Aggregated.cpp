@@ -79,165 +79,186 @@ void Aggregated::update(const Eigen::VectorXd& x) {
     this->generateAll();
 }
 
-void Aggregated::generateAll() {
-    /* resetting all internal data */
-    _tmpupperBound.reset(1);
-    _tmplowerBound.reset(1);
+void Aggregated::computeLayout() {
+    _layout.resize(_bounds.size());
+
+    bool has_bounds = false;
+    int eq_rows = 0;
+    int ineq_rows = 0;
+
+    unsigned int k = 0;
+    for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin();
+        i != _bounds.end(); i++, k++) {
+
+        ConstraintPtr &b = *i;
+        RowsBlock& block = _layout[k];
+
+        has_bounds = has_bounds ||
+                     b->getUpperBound().rows() != 0 || b->getLowerBound().rows() != 0;
+
+        /* equalities: Aeq*x = beq, or beq <= Aeq*x <= beq, or Aeq*x <= beq && -Aeq*x <= -beq */
+        const int rows_eq = b->getAeq().rows();
+        block.eq_offset = eq_rows;
+        block.eq_rows = 0;
+        block.ineq_offset = ineq_rows;
+        block.ineq_rows = 0;
+        if(_aggregationPolicy & EQUALITIES_TO_INEQUALITIES)
+            block.ineq_rows += (_aggregationPolicy & UNILATERAL_TO_BILATERAL) ? rows_eq : 2*rows_eq;
+        else
+            block.eq_rows = rows_eq;
+
+        /* inequalities: bilateral constraints are doubled if we want only unilateral ones */
+        const int rows_ineq = b->getAineq().rows();
+        if(!(_aggregationPolicy & UNILATERAL_TO_BILATERAL) &&
+           b->getbUpperBound().rows() != 0 && b->getbLowerBound().rows() != 0)
+            block.ineq_rows += 2*rows_ineq;
+        else
+            block.ineq_rows += rows_ineq;
+
+        eq_rows += block.eq_rows;
+        ineq_rows += block.ineq_rows;
+    }
 
-    _tmpAeq.reset(_x_size);
-    _tmpbeq.reset(1);
+    if(!has_bounds) {
+        _upperBound.resize(0);
+        _lowerBound.resize(0);
+    }
+
+    _Aeq.resize(eq_rows, _x_size);
+    _beq.resize(eq_rows);
 
-    _tmpAineq.reset(_x_size);
-    _tmpbUpperBound.reset(1);
-    _tmpbLowerBound.reset(1);
+    _Aineq.resize(ineq_rows, _x_size);
+    _bUpperBound.resize(ineq_rows);
+    /* lower bounds are never piled if we want only unilateral constraints */
+    _bLowerBound.resize((_aggregationPolicy & UNILATERAL_TO_BILATERAL) ? ineq_rows : 0);
+}
 
+void Aggregated::generateAll() {
     if(_constraint_id.empty() || _number_of_bounds != _bounds.size()){
         _number_of_bounds = _bounds.size();
         _constraint_id = concatenateConstraintsIds(getConstraintsList());}
 
-    /* iterating on all bounds.. */
+    this->computeLayout();
+
+    /* each constraint is copied once in its slice of the aggregated matrices, signs are
+       flipped while copying: nothing is allocated as long as the sizes do not change */
+    bool first_bounds = true;
+    unsigned int k = 0;
     for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin();
-        i != _bounds.end(); i++) {
+        i != _bounds.end(); i++, k++) {
 
         ConstraintPtr &b = *i;
+        const RowsBlock& block = _layout[k];
 
-        Eigen::VectorXd boundUpperBound = b->getUpperBound();
-        Eigen::VectorXd boundLowerBound = b->getLowerBound();
+        const Eigen::VectorXd& boundUpperBound = b->getUpperBound();
+        const Eigen::VectorXd& boundLowerBound = b->getLowerBound();
 
-        Eigen::MatrixXd boundAeq = b->getAeq();
-        Eigen::VectorXd boundbeq = b->getbeq();
+        const Eigen::MatrixXd& boundAeq = b->getAeq();
+        const Eigen::VectorXd& boundbeq = b->getbeq();
 
-        Eigen::MatrixXd boundAineq = b->getAineq();
-        Eigen::VectorXd boundbUpperBound = b->getbUpperBound();
-        Eigen::VectorXd boundbLowerBound = b->getbLowerBound();
+        const Eigen::MatrixXd& boundAineq = b->getAineq();
+        const Eigen::VectorXd& boundbUpperBound = b->getbUpperBound();
+        const Eigen::VectorXd& boundbLowerBound = b->getbLowerBound();
 
-        /* copying lowerBound, upperBound */
+        /* lowerBound, upperBound */
         if(boundUpperBound.rows() != 0 ||
            boundLowerBound.rows() != 0) {
             assert(boundUpperBound.rows() == _x_size);
             assert(boundLowerBound.rows() == _x_size);
 
-            if(_tmpupperBound.rows() == 0 ||
-               _tmplowerBound.rows() == 0) { // first valid bounds found
-                assert(_tmpupperBound.rows() == _tmplowerBound.rows());
-                _tmpupperBound.set(boundUpperBound);
-                _tmplowerBound.set(boundLowerBound);
+            if(first_bounds) {
+                _upperBound = boundUpperBound;
+                _lowerBound = boundLowerBound;
+                first_bounds = false;
             } else {
-                for(unsigned int i = 0; i < _x_size; ++i) {
-                    // compute the minimum between current and new upper bounds
-                    _tmpupperBound[i] = std::min(  _tmpupperBound[i],
-                                                boundUpperBound[i]);
-                    // compute the maximum between current and new lower bounds
-                    _tmplowerBound[i] = std::max(  _tmplowerBound[i],
-                                                boundLowerBound[i]);
-                }
+                // minimum between current and new upper bounds, maximum between lower bounds
+                _upperBound = _upperBound.cwiseMin(boundUpperBound);
+                _lowerBound = _lowerBound.cwiseMax(boundLowerBound);
             }
         }
 
-        /* copying Aeq, beq */
-        if( boundAeq.rows() != 0 ||
-            boundbeq.rows() != 0) {
+        int row = block.ineq_offset;
+
+        /* Aeq, beq */
+        if(boundAeq.rows() != 0) {
             assert(boundAeq.rows() == boundbeq.rows());
+            assert(boundAeq.cols() == _x_size);
+            const int rows = boundAeq.rows();
             /* when transforming equalities to inequalities,
                 Aeq*x = beq becomes
                 beq <= Aeq*x <= beq */
             if(_aggregationPolicy & EQUALITIES_TO_INEQUALITIES) {
-                assert(_tmpAineq.cols() == boundAeq.cols());
-                _tmpAineq.pile(boundAeq);
-                _tmpbUpperBound.pile(boundbeq);
+                _Aineq.middleRows(row, rows) = boundAeq;
+                _bUpperBound.segment(row, rows) = boundbeq;
                 if(_aggregationPolicy & UNILATERAL_TO_BILATERAL) {
-                    _tmpbLowerBound.pile(boundbeq);
+                    _bLowerBound.segment(row, rows) = boundbeq;
+                    row += rows;
                 /* we want to have only unilateral constraints, so
                    beq <= Aeq*x <= beq becomes
                    -Aeq*x <= -beq && Aeq*x <= beq */
                 } else {
-                    assert(_tmpAineq.cols() == boundAeq.cols());
-                    _tmpAineq.pile(-1.0*boundAeq);
-                    _tmpbUpperBound.pile( -1.0 * boundbeq);
+                    row += rows;
+                    _Aineq.middleRows(row, rows) = -boundAeq;
+                    _bUpperBound.segment(row, rows) = -boundbeq;
+                    row += rows;
                 }
             } else {
-                assert(_tmpAeq.cols() == boundAeq.cols());
-                _tmpAeq.pile(boundAeq);
-                _tmpbeq.pile(boundbeq);
+                _Aeq.middleRows(block.eq_offset, rows) = boundAeq;
+                _beq.segment(block.eq_offset, rows) = boundbeq;
             }
         }
 
-        /* copying Aineq, bUpperBound, bLowerBound*/
-        if( boundAineq.rows() != 0 ||
-            boundbUpperBound.rows() != 0 ||
-            boundbLowerBound.rows() != 0) {
-
-            assert(boundAineq.rows() > 0);
+        /* Aineq, bUpperBound, bLowerBound*/
+        if(boundAineq.rows() != 0) {
             assert(boundbLowerBound.rows() > 0 ||
                    boundbUpperBound.rows() > 0);
             assert(boundAineq.cols() == _x_size);
+            const int rows = boundAineq.rows();
 
             /* if we need to transform all unilateral bounds to bilateral.. */
             if(_aggregationPolicy & UNILATERAL_TO_BILATERAL) {
+                _Aineq.middleRows(row, rows) = boundAineq;
                 if(boundbUpperBound.rows() == 0) {
-                    assert(boundAineq.rows() == boundbLowerBound.rows());
-                    boundbUpperBound.resize(boundAineq.rows());
-                    boundbUpperBound<<boundbUpperBound.setOnes(boundAineq.rows())*std::numeric_limits<double>::infinity();
+                    assert(rows == boundbLowerBound.rows());
+                    _bUpperBound.segment(row, rows).setConstant(std::numeric_limits<double>::infinity());
+                    _bLowerBound.segment(row, rows) = boundbLowerBound;
                 } else if(boundbLowerBound.rows() == 0) {
-                    assert(boundAineq.rows() == boundbUpperBound.rows());
-                    boundbLowerBound.resize(boundAineq.rows());
-                    boundbLowerBound<<boundbLowerBound.setOnes(boundAineq.rows())*-std::numeric_limits<double>::max();
+                    assert(rows == boundbUpperBound.rows());
+                    _bUpperBound.segment(row, rows) = boundbUpperBound;
+                    _bLowerBound.segment(row, rows).setConstant(-std::numeric_limits<double>::max());
                 } else {
-                    assert(boundAineq.rows() == boundbLowerBound.rows());
-                    assert(boundAineq.rows() == boundbUpperBound.rows());
+                    assert(rows == boundbLowerBound.rows());
+                    assert(rows == boundbUpperBound.rows());
+                    _bUpperBound.segment(row, rows) = boundbUpperBound;
+                    _bLowerBound.segment(row, rows) = boundbLowerBound;
                 }
-            /* if we need to transform all bilateral bounds to unilateral.. */
+            /* if we need to transform all bilateral bounds to unilateral..
+               (lower bounds are never piled) */
             } else {
                 /* we need to transform l < Ax into -Ax < -l */
                 if(boundbUpperBound.rows() == 0) {
-                    boundAineq = -1.0 * boundAineq;
-                    boundbLowerBound = -1.0 * boundbLowerBound;
-                    assert(boundAineq.rows() == boundbLowerBound.rows());
+                    assert(rows == boundbLowerBound.rows());
+                    _Aineq.middleRows(row, rows) = -boundAineq;
+                    _bUpperBound.segment(row, rows) = -boundbLowerBound;
                 } else if(boundbLowerBound.rows() == 0) {
-                    assert(boundAineq.rows() == boundbUpperBound.rows());
+                    assert(rows == boundbUpperBound.rows());
+                    _Aineq.middleRows(row, rows) = boundAineq;
+                    _bUpperBound.segment(row, rows) = boundbUpperBound;
                 } else {
-                    assert(boundAineq.rows() == boundbLowerBound.rows());
-                    assert(boundAineq.rows() == boundbUpperBound.rows());
-                    pile(boundAineq,-1.0 * boundAineq);
-                    pile(boundbUpperBound,-1.0 * boundbLowerBound);
+                    assert(rows == boundbLowerBound.rows());
+                    assert(rows == boundbUpperBound.rows());
+                    _Aineq.middleRows(row, rows) = boundAineq;
+                    _bUpperBound.segment(row, rows) = boundbUpperBound;
+                    row += rows;
+                    _Aineq.middleRows(row, rows) = -boundAineq;
+                    _bUpperBound.segment(row, rows) = -boundbLowerBound;
                 }
             }
-
-            assert(_tmpAineq.cols() == boundAineq.cols());
-            _tmpAineq.pile(boundAineq);
-            _tmpbUpperBound.pile(boundbUpperBound);
-            /*  if using UNILATERAL_TO_BILATERAL we always have lower bounds,
-                otherwise, we never have them */
-            if(_aggregationPolicy & UNILATERAL_TO_BILATERAL)
-                _tmpbLowerBound.pile( boundbLowerBound);
+            row += rows;
         }
-    }
-
-    /* checking everything went fine */
-    assert(_tmplowerBound.rows() == 0 || _tmplowerBound.rows() == _x_size);
-    assert(_tmpupperBound.rows() == 0 || _tmpupperBound.rows() == _x_size);
-
-    assert(_tmpAeq.rows() == _tmpbeq.rows());
-    if(_tmpAeq.rows() > 0)
-        assert(_tmpAeq.cols() == _x_size);
-
-    assert(_tmpAineq.rows() == _tmpbUpperBound.rows());
-    if(!(_aggregationPolicy & UNILATERAL_TO_BILATERAL))
-        assert(_tmpAineq.rows() == _tmpbLowerBound.rows());
-    if(_tmpAineq.rows() > 0)
-        assert(_tmpAineq.cols() == _x_size);
-
-
-    _upperBound = _tmpupperBound.generate_and_get();
-    _lowerBound = _tmplowerBound.generate_and_get();
-
-    _Aeq = _tmpAeq.generate_and_get();
-    _beq = _tmpbeq.generate_and_get();
-
-    _Aineq = _tmpAineq.generate_and_get();
-    _bUpperBound = _tmpbUpperBound.generate_and_get();
-    _bLowerBound = _tmpbLowerBound.generate_and_get();
 
+        assert(row == block.ineq_offset + block.ineq_rows);
+    }
 }
 
 void Aggregated::checkSizes()
@@ -56,9 +56,16 @@ void ConvexHull::update(const Eigen::VectorXd &x) {
     //assert(JCoM.rows() == _Aineq.cols());
 
     _Aineq = _Aineq * JCoM.block(0,0,2,_x_size);
+    padInequalities();
     /**********************************************************************/
 }
 
+bool ConvexHull::setInequalityCapacity(const unsigned int capacity)
+{
+    _inequality_capacity = capacity;
+    return true;
+}
+
 bool ConvexHull::getConvexHull(std::vector<KDL::Vector> &ch)
 {
     std::list<KDL::Vector> points;
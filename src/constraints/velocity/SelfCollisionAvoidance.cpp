@@ -49,6 +49,8 @@ SelfCollisionAvoidance::SelfCollisionAvoidance(const Eigen::VectorXd& x,
 {
 
     _J_transform.setZero(3,6);
+    _Link1_Jaco.setZero(6, robot.getJointNum());
+    _Link2_Jaco.setZero(6, robot.getJointNum());
 
     update(x);
 
@@ -128,49 +130,50 @@ void SelfCollisionAvoidance::calculate_Aineq_bUpperB (Eigen::MatrixXd & Aineq_fc
 
 //    robot_col.updateiDyn3Model(x, false);
 
-    std::list<LinkPairDistance> interested_LinkPairs;
-    std::list<LinkPairDistance>::iterator j;
-    interested_LinkPairs = computeLinksDistance.getLinkDistances(_detection_threshold);
+    const std::vector<LinkPairDistance>& linkPairs = computeLinksDistance.computeLinkDistances(_detection_threshold);
+
+    unsigned int interested_LinkPairs = 0;
+    for(unsigned int i = 0; i < linkPairs.size(); ++i)
+    {
+        if(linkPairs[i].getDistance() < _detection_threshold)
+            ++interested_LinkPairs;
+    }
 
     /*//////////////////////////////////////////////////////////*/
 
-    MatrixXd Aineq_fc_Eigen(interested_LinkPairs.size(), robot_col.getJointNum());
-    VectorXd bUpperB_fc_Eigen(interested_LinkPairs.size());
+    // Aineq_fc and bUpperB_fc keep at least _inequality_capacity rows: they allocate only when their size changes
+    const unsigned int rows = std::max(interested_LinkPairs, _inequality_capacity);
+    Aineq_fc.resize(rows, robot_col.getJointNum());
+    bUpperB_fc.resize(rows);
 
     double Dm_LinkPair;
-    KDL::Frame Link1_T_CP,Link2_T_CP;
-    std::string Link1_name, Link2_name;
-
-    int Link1_index, Link2_index;
-
     KDL::Frame Waist_T_Link1, Waist_T_Link2, Waist_T_Link1_CP, Waist_T_Link2_CP;
-    KDL::Vector Link1_origin_kdl, Link2_origin_kdl, Link1_CP_kdl, Link2_CP_kdl;
     Eigen::Matrix<double, 3, 1> Link1_origin, Link2_origin, Link1_CP, Link2_CP;
 
     Vector3d closepoint_dir;
 
-    MatrixXd Link1_CP_Jaco, Link2_CP_Jaco;
+    Eigen::Matrix<double, 1, 6> Link1_CP_dir, Link2_CP_dir;
 
     Affine3d Waist_frame_world_Eigen;
     robot_col.getPose(base_name, Waist_frame_world_Eigen);
     Waist_frame_world_Eigen.inverse();
 
-    Matrix3d Waist_frame_world_Eigen_Ro = Waist_frame_world_Eigen.matrix().block(0,0,3,3);
-    MatrixXd temp_trans_matrix(6,6); temp_trans_matrix.setZero(6,6);
-    temp_trans_matrix.block(0,0,3,3) = Waist_frame_world_Eigen_Ro;
-    temp_trans_matrix.block(3,3,3,3) = Waist_frame_world_Eigen_Ro;
+    const Matrix3d Waist_frame_world_Eigen_Ro = Waist_frame_world_Eigen.linear();
 
     int linkPairIndex = 0;
-    for (j = interested_LinkPairs.begin(); j != interested_LinkPairs.end(); ++j)
+    for (unsigned int j = 0; j < linkPairs.size(); ++j)
     {
 
-        LinkPairDistance& linkPair(*j);
+        const LinkPairDistance& linkPair(linkPairs[j]);
 
         Dm_LinkPair = linkPair.getDistance();
-        Link1_T_CP = linkPair.getLink_T_closestPoint().first;
-        Link2_T_CP = linkPair.getLink_T_closestPoint().second;
-        Link1_name = linkPair.getLinkNames().first;
-        Link2_name = linkPair.getLinkNames().second;
+        if(Dm_LinkPair >= _detection_threshold)
+            continue;
+
+        const KDL::Frame& Link1_T_CP = linkPair.getLink_T_closestPoint().first;
+        const KDL::Frame& Link2_T_CP = linkPair.getLink_T_closestPoint().second;
+        const std::string& Link1_name = linkPair.getLinkNames().first;
+        const std::string& Link2_name = linkPair.getLinkNames().second;
 
 
         robot_col.getPose(Link1_name, base_name, Waist_T_Link1);
@@ -178,45 +181,51 @@ void SelfCollisionAvoidance::calculate_Aineq_bUpperB (Eigen::MatrixXd & Aineq_fc
 
         Waist_T_Link1_CP = Waist_T_Link1 * Link1_T_CP;
         Waist_T_Link2_CP = Waist_T_Link2 * Link2_T_CP;
-        Link1_origin_kdl = Waist_T_Link1.p;
-        Link2_origin_kdl = Waist_T_Link2.p;
-        Link1_CP_kdl = Waist_T_Link1_CP.p;
-        Link2_CP_kdl = Waist_T_Link2_CP.p;
 
-        vectorKDLToEigen(Link1_origin_kdl, Link1_origin);
-        vectorKDLToEigen(Link2_origin_kdl, Link2_origin);
-        vectorKDLToEigen(Link1_CP_kdl, Link1_CP);
-        vectorKDLToEigen(Link2_CP_kdl, Link2_CP);
+        vectorKDLToEigen(Waist_T_Link1.p, Link1_origin);
+        vectorKDLToEigen(Waist_T_Link2.p, Link2_origin);
+        vectorKDLToEigen(Waist_T_Link1_CP.p, Link1_CP);
+        vectorKDLToEigen(Waist_T_Link2_CP.p, Link2_CP);
 
 
         closepoint_dir = Link2_CP - Link1_CP;
         closepoint_dir = closepoint_dir / Dm_LinkPair;
 
-        robot_col.getRelativeJacobian(Link1_name, base_name,Link1_CP_Jaco);
-
-        Link1_CP_Jaco = temp_trans_matrix * Link1_CP_Jaco;
+        // closepoint_dir^T * J_transform * diag(R, R) * Jacobian, the 1x6 row is computed first
+        robot_col.getRelativeJacobian(Link1_name, base_name, _Link1_Jaco);
         skewSymmetricOperator(Link1_CP - Link1_origin,_J_transform);
-        Link1_CP_Jaco = _J_transform * Link1_CP_Jaco;
-
-        robot_col.getRelativeJacobian(Link2_name, base_name, Link2_CP_Jaco);
+        Link1_CP_dir.noalias() = closepoint_dir.transpose() * _J_transform;
+        Link1_CP_dir.head<3>() = Link1_CP_dir.head<3>() * Waist_frame_world_Eigen_Ro;
+        Link1_CP_dir.tail<3>() = Link1_CP_dir.tail<3>() * Waist_frame_world_Eigen_Ro;
 
-        Link2_CP_Jaco = temp_trans_matrix * Link2_CP_Jaco;
+        robot_col.getRelativeJacobian(Link2_name, base_name, _Link2_Jaco);
         skewSymmetricOperator(Link2_CP - Link2_origin,_J_transform);
-        Link2_CP_Jaco = _J_transform * Link2_CP_Jaco;
+        Link2_CP_dir.noalias() = closepoint_dir.transpose() * _J_transform;
+        Link2_CP_dir.head<3>() = Link2_CP_dir.head<3>() * Waist_frame_world_Eigen_Ro;
+        Link2_CP_dir.tail<3>() = Link2_CP_dir.tail<3>() * Waist_frame_world_Eigen_Ro;
 
 
-        Aineq_fc_Eigen.row(linkPairIndex) = closepoint_dir.transpose() * ( Link1_CP_Jaco - Link2_CP_Jaco );
-        bUpperB_fc_Eigen(linkPairIndex) = (Dm_LinkPair - _linkPair_threshold) * _boundScaling;
+        Aineq_fc.row(linkPairIndex).noalias() = Link1_CP_dir * _Link1_Jaco;
+        Aineq_fc.row(linkPairIndex).noalias() -= Link2_CP_dir * _Link2_Jaco;
+        bUpperB_fc(linkPairIndex) = (Dm_LinkPair - _linkPair_threshold) * _boundScaling;
 
         ++linkPairIndex;
 
     }
 
-    Aineq_fc = Aineq_fc_Eigen;
-    bUpperB_fc = bUpperB_fc_Eigen;
+    // the rows up to the capacity are always satisfied (see Constraint::padInequalities())
+    Aineq_fc.bottomRows(rows - linkPairIndex).setZero();
+    bUpperB_fc.tail(rows - linkPairIndex).setConstant(PADDING_ROWS_BOUND);
+    _active_inequalities = linkPairIndex;
 
 }
 
+bool SelfCollisionAvoidance::setInequalityCapacity(const unsigned int capacity)
+{
+    _inequality_capacity = capacity;
+    return true;
+}
+
 void SelfCollisionAvoidance::setBoundScaling(const double boundScaling)
 {
     _boundScaling = boundScaling;
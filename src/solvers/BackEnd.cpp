@@ -3,10 +3,16 @@
 using namespace OpenSoT::solvers;
 
 BackEnd::BackEnd(const int number_of_variables, const int number_of_constraints):
-    _number_of_variables(number_of_variables)
+    _number_of_variables(number_of_variables),
+    _time_budget(0.)
 {
     _solution.setZero(number_of_variables);
 
+    _solve_info.path = SOLVE_COLDSTART;
+    _solve_info.iterations = -1;
+    _solve_info.status = 0;
+    _solve_info.time_limit_reached = false;
+
     _H.setZero(number_of_variables,number_of_variables);
     _g.setZero(number_of_variables);
     _A.setZero(number_of_constraints,number_of_variables);
@@ -109,7 +115,7 @@ void BackEnd::log(XBot::MatLogger::Ptr logger, int i, const std::string& prefix)
     logger->add(prefix+"H_"+std::to_string(i), _H);
     logger->add(prefix+"g_"+std::to_string(i), _g);
     if(_A.rows() > 0 && _A.cols() > 0)
-        logger->add(prefix+"A_"+std::to_string(i), _A);
+        logger->add(prefix+"A_"+std::to_string(i), getA());
     if(_lA.size() > 0)
         logger->add(prefix+"lA_"+std::to_string(i), _lA);
     if(_uA.size() > 0)
@@ -156,3 +162,7 @@ int OpenSoT::solvers::BackEnd::getNumVariables() const
     return _number_of_variables;
 }
 
+BackEnd::MatrixView OpenSoT::solvers::BackEnd::getAView()
+{
+    return MatrixView(_A.data(), _A.rows(), _A.cols(), Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(_A.rows(), 1));
+}
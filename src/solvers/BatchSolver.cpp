@@ -0,0 +1,78 @@
+#include <OpenSoT/solvers/BatchSolver.h>
+#include <XBotInterface/Logger.hpp>
+
+using namespace OpenSoT::solvers;
+
+BatchSolver::BatchSolver(const unsigned int number_of_problems, const ProblemFactory& factory,
+                         const unsigned int number_of_threads):
+    _pool(number_of_threads)
+{
+    for(unsigned int i = 0; i < number_of_problems; ++i)
+    {
+        Problem::Ptr problem = factory(i);
+        if(!problem || !problem->solver)
+            throw std::runtime_error("BatchSolver: the factory did not return a solver for problem " + std::to_string(i));
+
+        BackEnd::Ptr back_end;
+        if(!problem->solver->getBackEnd(0, back_end) || !back_end)
+            throw std::runtime_error("BatchSolver: the solver of problem " + std::to_string(i) + " has no back-end");
+
+        _problems.push_back(problem);
+        _states.push_back(Eigen::VectorXd());
+        _solutions.push_back(Eigen::VectorXd::Zero(back_end->getNumVariables()));
+        _solved.push_back(false);
+    }
+
+    _job = std::bind(&BatchSolver::solveProblem, this, std::placeholders::_1);
+}
+
+void BatchSolver::solveProblem(const unsigned int i)
+{
+    Problem& problem = *_problems[i];
+
+    if(problem.update)
+        problem.update(_states[i]);
+
+    _solved[i] = problem.solver->solve(_solutions[i]);
+}
+
+bool BatchSolver::solve(const Eigen::MatrixXd& states, Eigen::MatrixXd& solutions)
+{
+    if(states.cols() != static_cast<Eigen::Index>(_problems.size()))
+    {
+        XBot::Logger::error("BatchSolver: states has %i columns but there are %i problems\n",
+                            int(states.cols()), int(_problems.size()));
+        return false;
+    }
+
+    for(unsigned int i = 0; i < _problems.size(); ++i)
+        _states[i] = states.col(i);
+
+    _pool.run(_problems.size(), _job);
+
+    bool solved = true;
+    solutions.resize(_problems.empty() ? 0 : _solutions[0].size(), _problems.size());
+    for(unsigned int i = 0; i < _problems.size(); ++i)
+    {
+        solutions.col(i) = _solutions[i];
+        solved = solved && _solved[i];
+    }
+    return solved;
+}
+
+bool BatchSolver::isSolved(const unsigned int i) const
+{
+    if(i >= _solved.size())
+        return false;
+    return _solved[i];
+}
+
+BatchSolver::Problem::Ptr BatchSolver::getProblem(const unsigned int i)
+{
+    if(i >= _problems.size())
+    {
+        XBot::Logger::error("Requested problem %i which does not exists!\n", i);
+        return Problem::Ptr();
+    }
+    return _problems[i];
+}
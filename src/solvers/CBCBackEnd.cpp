@@ -1,6 +1,7 @@
 #include <OpenSoT/solvers/CBCBackEnd.h>
 #include <XBotInterface/SoLib.h>
 #include <boost/make_shared.hpp>
+#include <cstring>
 
 using namespace OpenSoT::solvers;
 
@@ -38,9 +39,11 @@ bool CBCBackEnd::solve()
      
     _model->solver()->branchAndBound();
 
+    _solve_info.path = SOLVE_COLDSTART;
+    _solve_info.iterations = _model->solver()->getIterationCount();
+    _solve_info.status = solverReturnError();
 
-
-    if(!solverReturnError())
+    if(!_solve_info.status)
         _solution = Eigen::Map<const Eigen::VectorXd>(_model->solver()->getColSolution(), getNumVariables());
     else
     {
@@ -106,6 +109,28 @@ boost::any CBCBackEnd::getOptions()
     return _opt;
 }
 
+std::size_t CBCBackEnd::writeOptions(char* buffer, const std::size_t size)
+{
+    const std::size_t options_size = _opt.integer_ind.size()*sizeof(int);
+    if(size < options_size)
+        return 0;
+    if(options_size > 0)
+        std::memcpy(buffer, _opt.integer_ind.data(), options_size);
+    return options_size;
+}
+
+bool CBCBackEnd::readOptions(const char* buffer, const std::size_t size)
+{
+    if(size % sizeof(int) != 0)
+        return false;
+    CBCBackEndOptions opt;
+    opt.integer_ind.resize(size/sizeof(int));
+    if(size > 0)
+        std::memcpy(opt.integer_ind.data(), buffer, size);
+    setOptions(opt);
+    return true;
+}
+
 
 void CBCBackEnd::setOptions(const boost::any& options)
 {
@@ -163,14 +188,20 @@ bool CBCBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
             return false;
         }
         
-
-        _ACP.copyOf(true, _A.rows(), _A.cols(), _AS.nonZeros(), _A.data(), _AS.innerIndexPtr(), _AS.outerIndexPtr(), _AS.innerNonZeroPtr());
-        
+        return commitConstraints();
     }
     
     return true;
 }
 
+bool CBCBackEnd::commitConstraints()
+{
+    if(_A.rows())
+        _ACP.copyOf(true, _A.rows(), _A.cols(), _AS.nonZeros(), _A.data(), _AS.innerIndexPtr(), _AS.outerIndexPtr(), _AS.innerNonZeroPtr());
+
+    return true;
+}
+
 CBCBackEnd::~CBCBackEnd()
 {
 
@@ -1,6 +1,7 @@
 #include <OpenSoT/solvers/OSQPBackEnd.h>
 #include <osqp/glob_opts.h>
 #include <exception>
+#include <cstring>
 #include <XBotInterface/SoLib.h>
 using namespace OpenSoT::solvers;
 
@@ -26,7 +27,14 @@ OSQPBackEnd::OSQPBackEnd(const int number_of_variables,
                          const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
     _eps_regularisation(eps_regularisation),
-    _I(number_of_variables)
+    _I(number_of_variables),
+    _pattern_changed(false),
+    _setup_settings_changed(false),
+    _keep_adapted_rho(true),
+    _P_changed(false),
+    _A_changed(false),
+    _number_of_setups(0),
+    _number_of_refactorizations(0)
 {
     
     #ifdef DLONG
@@ -34,11 +42,11 @@ OSQPBackEnd::OSQPBackEnd(const int number_of_variables,
     #endif
     
     _eye.setIdentity(number_of_variables, number_of_variables);
-    _P_values.resize(getNumVariables()*(getNumVariables() + 1)/2);
     
     _settings.reset(new OSQPSettings());
      osqp_set_default_settings(_settings.get());
     _settings->verbose = 0;
+    _settings->warm_start = 1;
     
    
     
@@ -53,40 +61,62 @@ void OSQPBackEnd::__generate_data_struct(const int number_of_variables,
                                          const int number_of_constraints, 
                                          const int number_of_bounds)
 {
-    _lb_piled.setConstant(number_of_bounds + number_of_constraints, -1.0);
-    _ub_piled.setConstant(number_of_bounds + number_of_constraints,  1.0);
+    if(_lb_piled.size() != number_of_bounds + number_of_constraints)
+    {
+        _lb_piled.setConstant(number_of_bounds + number_of_constraints, -1.0);
+        _ub_piled.setConstant(number_of_bounds + number_of_constraints,  1.0);
+    }
 
-    /* Set appropriate sparsity pattern to P (upper triangular) */
-    
-    Eigen::MatrixXd sp_pattern, ones;
-    sp_pattern.setZero(getNumVariables(), getNumVariables());
-    ones.setOnes(getNumVariables(), getNumVariables());
-    
-    sp_pattern.triangularView<Eigen::Upper>() = ones;
-    
-    _Psparse = sp_pattern.sparseView();
+    std::vector<Eigen::Triplet<double> > triplets;
+
+    /* Set sparsity pattern to P (upper triangular nonzeros of H plus the diagonal) */
+    if(_Psparse.rows() == number_of_variables && _Psparse.cols() == number_of_variables)
+    {
+        for(int c = 0; c < _Psparse.outerSize(); ++c)
+            for(SparseMatrix::InnerIterator it(_Psparse, c); it; ++it)
+                triplets.push_back(Eigen::Triplet<double>(it.row(), c, 0.));
+    }
+    for(int c = 0; c < number_of_variables; ++c)
+    {
+        for(int r = 0; r < c; ++r)
+        {
+            if(_H(r,c) != 0.)
+                triplets.push_back(Eigen::Triplet<double>(r, c, 0.));
+        }
+        triplets.push_back(Eigen::Triplet<double>(c, c, 0.));
+    }
+
+    _Psparse.resize(number_of_variables, number_of_variables);
+    _Psparse.setFromTriplets(triplets.begin(), triplets.end());
     _Psparse.makeCompressed();
-    
+
     setCSCMatrix(_Pcsc.get(), _Psparse);
-    _Pcsc->x = _P_values.data();
 
 
-    /* Set appropriate sparsity pattern to A (dense + diagonal) */
-    ones.setOnes(number_of_constraints, number_of_variables);
-    sp_pattern.setZero(number_of_constraints + number_of_bounds, number_of_variables);
-    sp_pattern.topRows(number_of_constraints) = ones;
-    sp_pattern.bottomRows(number_of_bounds) = Eigen::MatrixXd::Identity(number_of_bounds, number_of_variables);
+    /* Set sparsity pattern to A (nonzeros of the constraints + diagonal for the bounds) */
+    triplets.clear();
+    if(_Asparse.rows() == number_of_constraints + number_of_bounds && _Asparse.cols() == number_of_variables)
+    {
+        for(int c = 0; c < _Asparse.outerSize(); ++c)
+            for(SparseMatrix::InnerIterator it(_Asparse, c); it; ++it)
+                triplets.push_back(Eigen::Triplet<double>(it.row(), c, 0.));
+    }
+    for(int c = 0; c < number_of_variables; ++c)
+    {
+        for(int r = 0; r < number_of_constraints; ++r)
+        {
+            if(_A(r,c) != 0.)
+                triplets.push_back(Eigen::Triplet<double>(r, c, 0.));
+        }
+    }
+    for(int c = 0; c < number_of_bounds; ++c)
+        triplets.push_back(Eigen::Triplet<double>(number_of_constraints + c, c, 0.));
 
-    _Asparse = sp_pattern.sparseView();
+    _Asparse.resize(number_of_constraints + number_of_bounds, number_of_variables);
+    _Asparse.setFromTriplets(triplets.begin(), triplets.end());
     _Asparse.makeCompressed();
 
-    int bounds_defined = number_of_bounds > 0 ? 1 : 0;
-    _Adense.setOnes(number_of_constraints + bounds_defined, number_of_variables);
-
     setCSCMatrix(_Acsc.get(), _Asparse);
-    _Acsc->x = _Adense.data();
-
-
 
 
     /* Fill data */
@@ -99,8 +129,98 @@ void OSQPBackEnd::__generate_data_struct(const int number_of_variables,
     _data->A = _Acsc.get();
     _data->P = _Pcsc.get();
 
-    
-    
+    __update_P_values();
+    __update_A_values();
+    _pattern_changed = false;
+}
+
+bool OSQPBackEnd::__update_P_values()
+{
+    bool in_pattern = true;
+    for(int c = 0; c < _Psparse.outerSize(); ++c)
+    {
+        int nonzeros = 0;
+        for(SparseMatrix::InnerIterator it(_Psparse, c); it; ++it)
+        {
+            double value = _H(it.row(), c);
+            if(value != 0.)
+                nonzeros++;
+            if(it.row() == c)
+                value += _eps_regularisation*BASE_REGULARISATION; //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+
+            if(it.value() != value)
+            {
+                it.valueRef() = value;
+                _P_changed = true;
+            }
+        }
+
+        if(nonzeros != (_H.col(c).head(c+1).array() != 0.).count())
+            in_pattern = false;
+    }
+    return in_pattern;
+}
+
+bool OSQPBackEnd::__update_A_values()
+{
+    const int number_of_constraints = _A.rows();
+
+    bool in_pattern = true;
+    for(int c = 0; c < _Asparse.outerSize(); ++c)
+    {
+        int nonzeros = 0;
+        for(SparseMatrix::InnerIterator it(_Asparse, c); it; ++it)
+        {
+            double value = 1.;
+            if(it.row() < number_of_constraints)
+            {
+                value = _A(it.row(), c);
+                if(value != 0.)
+                    nonzeros++;
+            }
+
+            if(it.value() != value)
+            {
+                it.valueRef() = value;
+                _A_changed = true;
+            }
+        }
+
+        if(number_of_constraints > 0 && nonzeros != (_A.col(c).array() != 0.).count())
+            in_pattern = false;
+    }
+    return in_pattern;
+}
+
+bool OSQPBackEnd::__setup_workspace()
+{
+    if( ((_ub_piled - _lb_piled).array() < 0).any() )
+    {
+        XBot::Logger::error("OSQP: invalid bounds\n");
+        return false;
+    }
+
+    /* The previous solution can be used to warm-start only if the dimensions did not change */
+    bool warm_start = _workspace && _solution.size() == _data->n && _dual_solution.size() == _data->m;
+    if(_workspace && _keep_adapted_rho)
+        _settings->rho = _workspace->settings->rho;
+
+    _workspace.reset( osqp_setup(_data.get(), _settings.get()), osqp_cleanup );
+
+    if(!_workspace)
+    {
+        XBot::Logger::error("OSQP: unable to setup workspace\n");
+        return false;
+    }
+    _number_of_setups++;
+    _setup_settings_changed = false;
+    _keep_adapted_rho = true;
+    _P_changed = false;
+    _A_changed = false;
+
+    if(warm_start)
+        osqp_warm_start(_workspace.get(), _solution.data(), _dual_solution.data());
+    return true;
 }
 
 void OpenSoT::solvers::OSQPBackEnd::update_data_struct()
@@ -127,22 +247,25 @@ bool OSQPBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
         return false;
     }
     
-    
-    int idx = 0;
-    for(int c = 0; c < getNumVariables(); c++)
-    {
-        _P_values.segment(idx, c+1) = _H.col(c).head(c+1);
-        _P_values.segment(idx, c+1)(c) += _eps_regularisation*BASE_REGULARISATION; //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
-        idx += c+1;
-    }
-    
-    setCSCMatrix(_Pcsc.get(), _Psparse);
-    _data->P->x = _P_values.data();
+    return commitTask();
+}
+
+bool OSQPBackEnd::commitTask()
+{
+    if(!__update_P_values())
+        _pattern_changed = true;
     _data->q = _g.data();
     
     return true;
 }
 
+bool OSQPBackEnd::commitGradient()
+{
+    _data->q = _g.data();
+
+    return true;
+}
+
 
 
 
@@ -159,11 +282,19 @@ bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
             return false;
         }
         
+        return commitConstraints();
+    }
+    
+    return true;
+}
 
+bool OSQPBackEnd::commitConstraints()
+{
+    if(getNumConstraints() > 0)
+    {
         /* Update values in A upper part (constraints) */
-        _Adense.topRows(getNumConstraints()) = _A;
-        setCSCMatrix(_Acsc.get(), _Asparse); // Asparse may be reallocated???
-        _data->A->x = _Adense.data();
+        if(!__update_A_values())
+            _pattern_changed = true;
         
         /* Update constraints bounds */
         _lb_piled.head(getNumConstraints()) = _lA;
@@ -175,6 +306,19 @@ bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
     return true;
 }
 
+bool OSQPBackEnd::commitConstraintsBounds()
+{
+    if(getNumConstraints() > 0)
+    {
+        _lb_piled.head(getNumConstraints()) = _lA;
+        _ub_piled.head(getNumConstraints()) = _uA;
+        _data->l = _lb_piled.data();
+        _data->u = _ub_piled.data();
+    }
+
+    return true;
+}
+
 bool OSQPBackEnd::updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd& u)
 {
     if(l.rows() > 0)
@@ -186,6 +330,16 @@ bool OSQPBackEnd::updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd&
             return false;
         }
 
+        return commitBounds();
+    }
+    
+    return true;
+}
+
+bool OSQPBackEnd::commitBounds()
+{
+    if(_l.rows() > 0)
+    {
         _lb_piled.tail(getNumVariables()) = _l;
         _ub_piled.tail(getNumVariables()) = _u;
         _data->l = _lb_piled.data(); // lb_piled may be reallocated???
@@ -198,17 +352,48 @@ bool OSQPBackEnd::updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd&
 
 bool OSQPBackEnd::solve()
 {
-    osqp_update_lin_cost(_workspace.get(), _g.data());
-    c_int update_bound_flag = osqp_update_bounds(_workspace.get(), _lb_piled.data(), _ub_piled.data());
-    if(update_bound_flag != 0)
-        return false;
-    c_int update_A_flag = osqp_update_A(_workspace.get(), _Adense.data(), nullptr, _Adense.size());
-    if(update_A_flag != 0)
-        return false;
-    c_int update_P_flag = osqp_update_P(_workspace.get(), _P_values.data(), nullptr, _P_values.size());
-    if(update_P_flag != 0)
-        return false;
-    
+    /* ADMM is always warm started, a new workspace means a new factorization from scratch */
+    _solve_info.path = _pattern_changed || _setup_settings_changed ? SOLVE_COLDSTART : SOLVE_HOTSTART;
+    _solve_info.iterations = 0;
+    _solve_info.time_limit_reached = false;
+
+    if(_pattern_changed)
+    {
+        /* New nonzeros appeared: the pattern is enlarged and the workspace is set up again */
+        __generate_data_struct(getNumVariables(), getNumConstraints(), _l.size());
+        if(!__setup_workspace())
+            return false;
+    }
+    else if(_setup_settings_changed)
+    {
+        /* _data already points to the current values */
+        if(!__setup_workspace())
+            return false;
+    }
+    else
+    {
+        osqp_update_lin_cost(_workspace.get(), _g.data());
+        c_int update_bound_flag = osqp_update_bounds(_workspace.get(), _lb_piled.data(), _ub_piled.data());
+        if(update_bound_flag != 0)
+            return false;
+
+        /* The KKT system is factorized again only if P or A changed */
+        c_int update_matrices_flag = 0;
+        if(_P_changed && _A_changed)
+            update_matrices_flag = osqp_update_P_A(_workspace.get(),
+                                                   _Psparse.valuePtr(), nullptr, _Psparse.nonZeros(),
+                                                   _Asparse.valuePtr(), nullptr, _Asparse.nonZeros());
+        else if(_P_changed)
+            update_matrices_flag = osqp_update_P(_workspace.get(), _Psparse.valuePtr(), nullptr, _Psparse.nonZeros());
+        else if(_A_changed)
+            update_matrices_flag = osqp_update_A(_workspace.get(), _Asparse.valuePtr(), nullptr, _Asparse.nonZeros());
+        if(update_matrices_flag != 0)
+            return false;
+        if(_P_changed || _A_changed)
+            _number_of_refactorizations++;
+        _P_changed = false;
+        _A_changed = false;
+    }
     
     
     c_int exitflag = osqp_solve(_workspace.get());
@@ -216,16 +401,35 @@ bool OSQPBackEnd::solve()
         return false;
     
     c_int workspace_flag = _workspace->info->status_val;
+    _solve_info.iterations = _workspace->info->iter;
+    _solve_info.status = workspace_flag;
+#ifdef PROFILING
+    _solve_info.time_limit_reached = workspace_flag == OSQP_TIME_LIMIT_REACHED;
+#endif
     if(workspace_flag != 1 && workspace_flag != 2){
         XBot::Logger::error("%s", _workspace->info->status);
         return false;}
 
     _solution = Eigen::Map<Eigen::VectorXd>(_workspace->solution->x, _solution.size());
+    _dual_solution = Eigen::Map<Eigen::VectorXd>(_workspace->solution->y, _data->m);
 
     return true;
     
 }
 
+bool OSQPBackEnd::setTimeBudget(const double time)
+{
+#ifdef PROFILING
+    _time_budget = time;
+    _settings->time_limit = time > 0. ? time : 0.;
+    if(_workspace)
+        osqp_update_time_limit(_workspace.get(), _settings->time_limit);
+    return true;
+#else
+    return BackEnd::setTimeBudget(time);
+#endif
+}
+
 boost::any OSQPBackEnd::getOptions()
 {
     return _settings;
@@ -233,8 +437,75 @@ boost::any OSQPBackEnd::getOptions()
 
 void OSQPBackEnd::setOptions(const boost::any &options)
 {
-    _settings.reset(new OSQPSettings(boost::any_cast<OSQPSettings>(options)));
-    _workspace->settings = _settings.get();
+    const OSQPSettings settings = boost::any_cast<OSQPSettings>(options);
+
+    if(_workspace)
+    {
+        OSQPWorkspace* workspace = _workspace.get();
+
+        /* rho is compared with the last one set (or retained at the last setup), so that passing back
+           the settings returned by getOptions() keeps the rho adapted by the workspace */
+        const bool new_rho = settings.rho != _settings->rho;
+
+        if(settings.sigma != _settings->sigma ||
+           settings.scaling != _settings->scaling ||
+           settings.adaptive_rho != _settings->adaptive_rho ||
+           settings.adaptive_rho_interval != _settings->adaptive_rho_interval ||
+           settings.adaptive_rho_tolerance != _settings->adaptive_rho_tolerance ||
+#ifdef PROFILING
+           settings.adaptive_rho_fraction != _settings->adaptive_rho_fraction ||
+#endif
+           settings.linsys_solver != _settings->linsys_solver)
+        {
+            /* these settings are used only by osqp_setup */
+            _setup_settings_changed = true;
+            _keep_adapted_rho = _keep_adapted_rho && !new_rho;
+        }
+        else
+        {
+            c_int flag = 0;
+            if(new_rho)
+                flag = osqp_update_rho(workspace, settings.rho) || flag;
+            flag = osqp_update_max_iter(workspace, settings.max_iter) || flag;
+            flag = osqp_update_eps_abs(workspace, settings.eps_abs) || flag;
+            flag = osqp_update_eps_rel(workspace, settings.eps_rel) || flag;
+            flag = osqp_update_eps_prim_inf(workspace, settings.eps_prim_inf) || flag;
+            flag = osqp_update_eps_dual_inf(workspace, settings.eps_dual_inf) || flag;
+            flag = osqp_update_alpha(workspace, settings.alpha) || flag;
+            flag = osqp_update_delta(workspace, settings.delta) || flag;
+            flag = osqp_update_polish(workspace, settings.polish) || flag;
+            flag = osqp_update_polish_refine_iter(workspace, settings.polish_refine_iter) || flag;
+            flag = osqp_update_verbose(workspace, settings.verbose) || flag;
+            flag = osqp_update_scaled_termination(workspace, settings.scaled_termination) || flag;
+            flag = osqp_update_check_termination(workspace, settings.check_termination) || flag;
+            flag = osqp_update_warm_start(workspace, settings.warm_start) || flag;
+#ifdef PROFILING
+            flag = osqp_update_time_limit(workspace, settings.time_limit) || flag;
+#endif
+            if(flag)
+                XBot::Logger::error("OSQP: some of the options are not valid and have not been updated\n");
+        }
+    }
+
+    _settings.reset(new OSQPSettings(settings));
+}
+
+std::size_t OSQPBackEnd::writeOptions(char* buffer, const std::size_t size)
+{
+    if(size < sizeof(OSQPSettings))
+        return 0;
+    std::memcpy(buffer, _settings.get(), sizeof(OSQPSettings));
+    return sizeof(OSQPSettings);
+}
+
+bool OSQPBackEnd::readOptions(const char* buffer, const std::size_t size)
+{
+    if(size != sizeof(OSQPSettings))
+        return false;
+    OSQPSettings settings;
+    std::memcpy(&settings, buffer, sizeof(OSQPSettings));
+    setOptions(settings);
+    return true;
 }
 
 bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
@@ -242,8 +513,18 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
+    /* If the dimensions are the same, the workspace is reused and only the data are updated */
+    bool same_dimensions = _workspace && _H.rows() == H.rows() && _A.rows() == A.rows() && _l.size() == l.size();
+
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u; //this is needed since updateX should be used just to update and not init (maybe can be done in the base class)
-    __generate_data_struct(H.rows(), A.rows(), l.size());
+
+    if(!same_dimensions)
+    {
+        /* The sparsity pattern is computed from scratch */
+        _Psparse.resize(0, 0);
+        _Asparse.resize(0, 0);
+        __generate_data_struct(H.rows(), A.rows(), l.size());
+    }
 
     bool success = true;
     success = updateTask(H, g) && success;
@@ -252,19 +533,8 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
     if(l.rows() > 0)
         success = updateBounds(l, u) && success;
     
-    if( ((_ub_piled - _lb_piled).array() < 0).any() )
-    {
-        XBot::Logger::error("OSQP: invalid bounds\n");
-        return false;
-    }
-    
-    _workspace.reset( osqp_setup(_data.get(), _settings.get()) );
-    
-    if(!_workspace)
-    {
-        XBot::Logger::error("OSQP: unable to setup workspace\n");
+    if(!same_dimensions && !__setup_workspace())
         return false;
-    }
     
     success = solve() && success;
     
@@ -1,6 +1,7 @@
 #include <OpenSoT/solvers/QPOasesBackEnd.h>
 #include <qpOASES.hpp>
 #include <ctime>
+#include <cstring>
 #include <qpOASES/Utils.hpp>
 #include <fstream>
 #include <boost/make_shared.hpp>
@@ -14,8 +15,67 @@
 #define RED "\033[0;31m"
 #define DEFAULT "\033[0m"
 
+#define QPOASES_OPTIONS_VERSION 1 //format of the options serialized by writeOptions()
+#define QPOASES_OPTIONS_INTEGERS 17 //integer and enum fields of qpOASES::Options
+#define QPOASES_OPTIONS_REALS 16 //real_t fields of qpOASES::Options
+#define QPOASES_OPTIONS_SIZE (sizeof(int32_t)*(1 + QPOASES_OPTIONS_INTEGERS) + sizeof(double)*QPOASES_OPTIONS_REALS)
+
 using namespace OpenSoT::solvers;
 
+/* fields of the serialized options: integers and enums are written as int32_t, real_t as double */
+static void putInteger(char*& buffer, const int32_t value)
+{
+    std::memcpy(buffer, &value, sizeof(value));
+    buffer += sizeof(value);
+}
+
+static void putReal(char*& buffer, const double value)
+{
+    std::memcpy(buffer, &value, sizeof(value));
+    buffer += sizeof(value);
+}
+
+static int32_t getInteger(const char*& buffer)
+{
+    int32_t value;
+    std::memcpy(&value, buffer, sizeof(value));
+    buffer += sizeof(value);
+    return value;
+}
+
+static double getReal(const char*& buffer)
+{
+    double value;
+    std::memcpy(&value, buffer, sizeof(value));
+    buffer += sizeof(value);
+    return value;
+}
+
+/* state of a bound or constraint in the format of getWorkingSet() */
+static qpOASES::SubjectToStatus toSubjectToStatus(const double state)
+{
+    if(state < 0.)
+        return qpOASES::ST_LOWER;
+    if(state > 0.)
+        return qpOASES::ST_UPPER;
+    return qpOASES::ST_INACTIVE;
+}
+
+/* rows active in a guessed working set, equality rows are always active in the initial working set */
+static int countActive(const Eigen::VectorXd& states, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper)
+{
+    int active = 0;
+    for(unsigned int i = 0; i < states.size(); ++i)
+        active += states[i] != 0. || (lower.size() == states.size() && lower[i] == upper[i]);
+    return active;
+}
+
+/* qpOASES returns RET_MAX_NWSR_REACHED also when it stops for cputime, then fewer working set changes
+   than the allowed ones have been performed */
+static bool timeLimitReached(const qpOASES::returnValue val, const int nWSR, const int max_nWSR)
+{
+    return val == qpOASES::RET_MAX_NWSR_REACHED && nWSR < max_nWSR;
+}
 
 /* Define factories for dynamic loading */
 extern "C" BackEnd * create_instance(const int number_of_variables,
@@ -34,6 +94,11 @@ QPOasesBackEnd::QPOasesBackEnd(const int number_of_variables,
                                const int number_of_constraints,
                                OpenSoT::HessianType hessian_type, const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
+    _H_changed(true),
+    _A_changed(true),
+    _working_set_guess(false),
+    _reinitialized(false),
+    _time_spent(0.),
     _problem(new qpOASES::SQProblem(number_of_variables,
                                     number_of_constraints,
                                     (qpOASES::HessianType)(hessian_type))),
@@ -41,9 +106,11 @@ QPOasesBackEnd::QPOasesBackEnd(const int number_of_variables,
     _constraints(new qpOASES::Constraints()),
     _nWSR(13200),
     _epsRegularisation(eps_regularisation),
-    _dual_solution(number_of_variables),
-    _opt(new qpOASES::Options())
+    _opt(new qpOASES::Options()),
+    _dual_solution(number_of_variables)
 {
+    _A_row_major.setZero(number_of_constraints, number_of_variables);
+
     setDefaultOptions();
 }
 
@@ -81,12 +148,112 @@ void QPOasesBackEnd::setOptions(const boost::any &options){
 boost::any QPOasesBackEnd::getOptions(){
     return _problem->getOptions();}
 
+std::size_t QPOasesBackEnd::writeOptions(char* buffer, const std::size_t size)
+{
+    //the fields are written one by one: the format does not depend on the layout of qpOASES::Options
+    if(size < QPOASES_OPTIONS_SIZE)
+        return 0;
+    const qpOASES::Options opt = _problem->getOptions();
+
+    putInteger(buffer, QPOASES_OPTIONS_VERSION);
+
+    putInteger(buffer, opt.printLevel);
+    putInteger(buffer, opt.enableRamping);
+    putInteger(buffer, opt.enableFarBounds);
+    putInteger(buffer, opt.enableFlippingBounds);
+    putInteger(buffer, opt.enableRegularisation);
+    putInteger(buffer, opt.enableFullLITests);
+    putInteger(buffer, opt.enableNZCTests);
+    putInteger(buffer, opt.enableDriftCorrection);
+    putInteger(buffer, opt.enableCholeskyRefactorisation);
+    putInteger(buffer, opt.enableEqualities);
+    putInteger(buffer, opt.initialStatusBounds);
+    putInteger(buffer, opt.numRegularisationSteps);
+    putInteger(buffer, opt.numRefinementSteps);
+    putInteger(buffer, opt.enableDropInfeasibles);
+    putInteger(buffer, opt.dropBoundPriority);
+    putInteger(buffer, opt.dropEqConPriority);
+    putInteger(buffer, opt.dropIneqConPriority);
+
+    putReal(buffer, opt.terminationTolerance);
+    putReal(buffer, opt.boundTolerance);
+    putReal(buffer, opt.boundRelaxation);
+    putReal(buffer, opt.epsNum);
+    putReal(buffer, opt.epsDen);
+    putReal(buffer, opt.maxPrimalJump);
+    putReal(buffer, opt.maxDualJump);
+    putReal(buffer, opt.initialRamping);
+    putReal(buffer, opt.finalRamping);
+    putReal(buffer, opt.initialFarBounds);
+    putReal(buffer, opt.growFarBounds);
+    putReal(buffer, opt.epsFlipping);
+    putReal(buffer, opt.epsRegularisation);
+    putReal(buffer, opt.epsIterRef);
+    putReal(buffer, opt.epsLITests);
+    putReal(buffer, opt.epsNZCTests);
+
+    return QPOASES_OPTIONS_SIZE;
+}
+
+bool QPOasesBackEnd::readOptions(const char* buffer, const std::size_t size)
+{
+    if(size != QPOASES_OPTIONS_SIZE || getInteger(buffer) != QPOASES_OPTIONS_VERSION)
+        return false;
+
+    qpOASES::Options opt;
+
+    opt.printLevel = static_cast<qpOASES::PrintLevel>(getInteger(buffer));
+    opt.enableRamping = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableFarBounds = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableFlippingBounds = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableRegularisation = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableFullLITests = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableNZCTests = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.enableDriftCorrection = getInteger(buffer);
+    opt.enableCholeskyRefactorisation = getInteger(buffer);
+    opt.enableEqualities = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.initialStatusBounds = static_cast<qpOASES::SubjectToStatus>(getInteger(buffer));
+    opt.numRegularisationSteps = getInteger(buffer);
+    opt.numRefinementSteps = getInteger(buffer);
+    opt.enableDropInfeasibles = static_cast<qpOASES::BooleanType>(getInteger(buffer));
+    opt.dropBoundPriority = getInteger(buffer);
+    opt.dropEqConPriority = getInteger(buffer);
+    opt.dropIneqConPriority = getInteger(buffer);
+
+    opt.terminationTolerance = getReal(buffer);
+    opt.boundTolerance = getReal(buffer);
+    opt.boundRelaxation = getReal(buffer);
+    opt.epsNum = getReal(buffer);
+    opt.epsDen = getReal(buffer);
+    opt.maxPrimalJump = getReal(buffer);
+    opt.maxDualJump = getReal(buffer);
+    opt.initialRamping = getReal(buffer);
+    opt.finalRamping = getReal(buffer);
+    opt.initialFarBounds = getReal(buffer);
+    opt.growFarBounds = getReal(buffer);
+    opt.epsFlipping = getReal(buffer);
+    opt.epsRegularisation = getReal(buffer);
+    opt.epsIterRef = getReal(buffer);
+    opt.epsLITests = getReal(buffer);
+    opt.epsNZCTests = getReal(buffer);
+
+    setOptions(opt);
+    return true;
+}
+
 bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
                                  const Eigen::MatrixXd &A,
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
-    _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u;
+    _H = H; _g = g; _A_row_major = A; _lA = lA; _uA = uA; _l = l; _u = u;
+    _A.resize(A.rows(), A.cols());
+
+    return initQP();
+}
+
+bool QPOasesBackEnd::initQP(double* cputime)
+{
     checkINFTY();
 
 
@@ -95,10 +262,10 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
         XBot::Logger::error("u size: %i \n", _u.rows());
         assert(_l.rows() == _u.rows());
         return false;}
-    if(!(_lA.rows() == _A.rows())){
+    if(!(_lA.rows() == _A_row_major.rows())){
         XBot::Logger::error("lA size: %i \n", _lA.rows());
-        XBot::Logger::error("A rows: %i \n", _A.rows());
-        assert(_lA.rows() == _A.rows());
+        XBot::Logger::error("A rows: %i \n", _A_row_major.rows());
+        assert(_lA.rows() == _A_row_major.rows());
         return false;}
     if(!(_lA.rows() == _uA.rows())){
         XBot::Logger::error("lA size: %i \n", _lA.rows());
@@ -108,17 +275,86 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
 
     int nWSR = _nWSR;
 
+    _H_solver = _H;
+    _H_matrix = boost::make_shared<qpOASES::SymDenseMat>(_H_solver.rows(), _H_solver.cols(), _H_solver.cols(),
+                                                         _H_solver.data());
+    _A_matrix = boost::make_shared<qpOASES::DenseMatrix>(_A_row_major.rows(), _A_row_major.cols(),
+                                                         _A_row_major.cols(), _A_row_major.data());
+
     /**
-     * this typedef is needed since qpOASES wants RoWMajor organization
-     * of matrices. Thanks to Arturo Laurenzi for the help finding this issue!
+     * qpOASES wants RoWMajor organization of matrices.
+     * Thanks to Arturo Laurenzi for the help finding this issue!
      */
-    qpOASES::returnValue val =_problem->init(_H.data(),_g.data(),
-                       Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(_A).data(),
-                       _l.data(), _u.data(),
-                       _lA.data(),_uA.data(),
-                       nWSR,0);
+    qpOASES::returnValue val = qpOASES::RET_INIT_FAILED;
+    int iterations = 0;
+    double remaining_time = cputime ? *cputime : 0.;
+    bool out_of_time = false;
+    if(_working_set_guess && _bounds_guess.size() == _H.cols() && _constraints_guess.size() == _A_row_major.rows() &&
+       countActive(_bounds_guess, _l, _u) + countActive(_constraints_guess, _lA, _uA) <= _H.cols())
+    {
+        //a good guess needs few working set changes, a wrong one should not take the whole budget
+        const int max_guess_nWSR = std::min(nWSR, static_cast<int>(_H.cols() + _A_row_major.rows()));
+        int guess_nWSR = max_guess_nWSR;
+        double guess_cputime = remaining_time;
+
+        qpOASES::Bounds guessed_bounds(_bounds_guess.size());
+        for(unsigned int i = 0; i < _bounds_guess.size(); ++i)
+            guessed_bounds.setupBound(i, toSubjectToStatus(_bounds_guess[i]));
+        qpOASES::Constraints guessed_constraints(_constraints_guess.size());
+        for(unsigned int i = 0; i < _constraints_guess.size(); ++i)
+            guessed_constraints.setupConstraint(i, toSubjectToStatus(_constraints_guess[i]));
+
+        val =_problem->init(_H_matrix.get(),_g.data(),
+                           _A_matrix.get(),
+                           _l.data(), _u.data(),
+                           _lA.data(),_uA.data(),
+                           guess_nWSR, cputime ? &guess_cputime : 0,
+                           NULL, NULL,
+                           &guessed_bounds, &guessed_constraints);
+        if(cputime)
+        {
+            remaining_time -= guess_cputime;
+            out_of_time = timeLimitReached(val, guess_nWSR, max_guess_nWSR) || remaining_time <= 0.;
+        }
+
+        //a wrong guess (e.g. linearly dependent active constraints) makes the initialization fail
+        if(val != qpOASES::SUCCESSFUL_RETURN)
+        {
+            iterations = guess_nWSR;
+            _H_solver = _H;
+        }
+        else
+            nWSR = guess_nWSR;
+    }
+    _working_set_guess = false;
 
-    if(qpOASES::getSimpleStatus(val) < 0)
+    if(out_of_time)
+        nWSR = 0;
+    else if(val != qpOASES::SUCCESSFUL_RETURN)
+    {
+        double init_cputime = remaining_time;
+        val =_problem->init(_H_matrix.get(),_g.data(),
+                           _A_matrix.get(),
+                           _l.data(), _u.data(),
+                           _lA.data(),_uA.data(),
+                           nWSR, cputime ? &init_cputime : 0);
+        if(cputime)
+        {
+            remaining_time -= init_cputime;
+            out_of_time = timeLimitReached(val, nWSR, _nWSR);
+        }
+    }
+    if(cputime)
+        *cputime -= remaining_time;
+    _solve_info.path = SOLVE_COLDSTART;
+    _solve_info.iterations = iterations + nWSR;
+    _solve_info.status = val;
+    _solve_info.time_limit_reached = out_of_time;
+    _H_changed = false;
+    _A_changed = false;
+
+    //stopped by the time budget the homotopy is not at the solution
+    if(qpOASES::getSimpleStatus(val) < 0 || out_of_time)
     {
 #ifdef OPENSOT_VERBOSE
         _problem->printProperties();
@@ -142,8 +378,6 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
     //We get the solution
     qpOASES::returnValue success = _problem->getPrimalSolution(_solution.data());
     _problem->getDualSolution(_dual_solution.data());
-    _problem->getBounds(*_bounds);
-    _problem->getConstraints(*_constraints);
 
     if(success != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
@@ -153,6 +387,23 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
     return true;
 }
 
+bool QPOasesBackEnd::reinitQP()
+{
+    if(_time_budget <= 0.)
+        return initQP();
+
+    double cputime = _time_budget - _time_spent;
+    if(cputime <= 0.)
+    {
+        _solve_info.time_limit_reached = true;
+        return false;
+    }
+
+    bool solved = initQP(&cputime);
+    _time_spent += cputime;
+    return solved;
+}
+
 bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
 {
     if(!(_g.rows() == _H.rows())){
@@ -169,6 +420,7 @@ bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd
     {
         _H = H;
         _g = g;
+        _H_changed = true;
 
         return true;
     }
@@ -179,14 +431,15 @@ bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd
 
         qpOASES::HessianType hessian_type = _problem->getHessianType();
         int number_of_variables = _H.cols();
-        int number_of_constraints = _A.rows();
+        int number_of_constraints = _A_row_major.rows();
         _problem.reset();
         _problem = boost::shared_ptr<qpOASES::SQProblem> (new qpOASES::SQProblem(
                                                               number_of_variables,
                                                               number_of_constraints,
                                                               hessian_type));
         _problem->setOptions(*_opt.get());
-        return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+        _reinitialized = true;
+        return reinitQP();
     }
 }
 
@@ -207,29 +460,32 @@ bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>&
         std::cout<<RED<<"uA size: "<<uA.rows()<<DEFAULT<<std::endl;
         return false;}
 
-    if(A.rows() == _A.rows())
+    if(A.rows() == _A_row_major.rows())
     {
-        _A = A;
+        _A_row_major = A;
         _lA = lA;
         _uA = uA;
+        _A_changed = true;
         return true;
     }
     else
     {
-        _A = A;
+        _A_row_major = A;
+        _A.resize(A.rows(), A.cols());
         _lA = lA;
         _uA = uA;
 
         qpOASES::HessianType hessian_type = _problem->getHessianType();
         int number_of_variables = _H.cols();
-        int number_of_constraints = _A.rows();
+        int number_of_constraints = _A_row_major.rows();
         _problem.reset();
         _problem = boost::shared_ptr<qpOASES::SQProblem> (new qpOASES::SQProblem(
                                                               number_of_variables,
                                                               number_of_constraints,
                                                               hessian_type));
         _problem->setOptions(*_opt.get());
-        return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+        _reinitialized = true;
+        return reinitQP();
     }
 }
 
@@ -239,35 +495,103 @@ bool QPOasesBackEnd::solve()
     int nWSR = _nWSR;
     checkINFTY();
 
-    qpOASES::returnValue val =_problem->hotstart(_H.data(),_g.data(),
-                       Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(_A).data(),
+    /* with a time budget, cputime is the maximum time on input and the time spent on output */
+    const bool deadline = _time_budget > 0.;
+    double remaining_time = _time_budget - _time_spent;
+    double cputime = remaining_time;
+    _time_spent = 0.;
+    if(deadline && remaining_time <= 0.)
+    {
+        _reinitialized = false;
+        _solve_info.time_limit_reached = true;
+        return false;
+    }
+
+    /* if H and A did not change qpOASES keeps its factorization, only the vectors are passed */
+    qpOASES::returnValue val;
+    if(_H_changed || _A_changed)
+    {
+        _H_solver = _H;
+        val =_problem->hotstart(_H_matrix.get(),_g.data(),
+                       _A_matrix.get(),
                         _l.data(), _u.data(),
                        _lA.data(),_uA.data(),
-                       nWSR,0);
-
+                       nWSR, deadline ? &cputime : 0);
+    }
+    else
+        val =_problem->hotstart(_g.data(),
+                        _l.data(), _u.data(),
+                       _lA.data(),_uA.data(),
+                       nWSR, deadline ? &cputime : 0);
+    _H_changed = false;
+    _A_changed = false;
+
+    /* an initialization done by the updates since the last solve is part of this solve */
+    _solve_info.path = _reinitialized ? SOLVE_COLDSTART : SOLVE_HOTSTART;
+    _solve_info.iterations = (_reinitialized ? _solve_info.iterations : 0) + nWSR;
+    _solve_info.status = val;
+    _solve_info.time_limit_reached = false;
+    _reinitialized = false;
+
+    /* if hotstart fails, the working set of the last solution is guessed from the sign of
+       the dual solution: the working set is not copied out of qpOASES at every solve,
+       since the copy allocates */
     if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
         std::cout<<YELLOW<<"WARNING OPTIMIZING TASK IN HOTSTART! ERROR "<<val<<DEFAULT<<std::endl;
         std::cout<<GREEN<<"RETRYING INITING WITH WARMSTART"<<DEFAULT<<std::endl;
 #endif
-
-        val =_problem->init(_H.data(),_g.data(),
-                           Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(_A).data(),
+        //the matrices are passed again to the next hotstart
+        _H_changed = true;
+        _A_changed = true;
+
+        if(deadline)
+        {
+            remaining_time -= cputime;
+            cputime = remaining_time;
+            if(timeLimitReached(val, nWSR, _nWSR) || remaining_time <= 0.)
+            {
+                _solve_info.time_limit_reached = true;
+                return false;
+            }
+        }
+        nWSR = _nWSR;
+
+        //the dual solution is not a guess if an initialization failed after a change of size
+        const bool dual_guess = _dual_solution.size() == _problem->getNV() + _problem->getNC();
+        _H_solver = _H;
+        val =_problem->init(_H_matrix.get(),_g.data(),
+                           _A_matrix.get(),
                            _l.data(), _u.data(),
                            _lA.data(),_uA.data(),
-                           nWSR,0,
-                           _solution.data(), _dual_solution.data(),
-                           _bounds.get(), _constraints.get());
+                           nWSR, deadline ? &cputime : 0,
+                           NULL, dual_guess ? _dual_solution.data() : NULL,
+                           NULL, NULL);
+        _solve_info.path = SOLVE_WARMSTART;
+        _solve_info.iterations += nWSR;
+        _solve_info.status = val;
 
         if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
             std::cout<<YELLOW<<"WARNING OPTIMIZING TASK IN WARMSTART! ERROR "<<val<<DEFAULT<<std::endl;
             std::cout<<GREEN<<"RETRYING INITING"<<DEFAULT<<std::endl;
 #endif
-
-            return initProblem(_H, _g, _A, _lA, _uA, _l ,_u);}
+            if(deadline)
+            {
+                remaining_time -= cputime;
+                cputime = remaining_time;
+                if(timeLimitReached(val, nWSR, _nWSR) || remaining_time <= 0.)
+                {
+                    _solve_info.time_limit_reached = true;
+                    return false;
+                }
+            }
+
+            int iterations = _solve_info.iterations;
+            bool solved = initQP(deadline ? &cputime : NULL);
+            _solve_info.iterations += iterations;
+            return solved;}
     }
-
     // If solution has changed of size we update the size
     if(_solution.rows() != _problem->getNV())
         _solution.resize(_problem->getNV());
@@ -278,19 +602,33 @@ bool QPOasesBackEnd::solve()
     //We get the solution
     qpOASES::returnValue success = _problem->getPrimalSolution(_solution.data());
     _problem->getDualSolution(_dual_solution.data());
-    _problem->getBounds(*_bounds);
-    _problem->getConstraints(*_constraints);
 
     if(qpOASES::getSimpleStatus(success) < 0){
 #ifdef OPENSOT_VERBOSE
         std::cout<<"ERROR GETTING PRIMAL SOLUTION! ERROR "<<success<<std::endl;
 #endif
-        return initProblem(_H, _g, _A, _lA, _uA, _l ,_u);
+        if(deadline)
+        {
+            cputime = remaining_time - cputime;
+            if(cputime <= 0.)
+            {
+                _solve_info.time_limit_reached = true;
+                return false;
+            }
+        }
+        return initQP(deadline ? &cputime : NULL);
     }
     return true;
 }
 
 
+bool QPOasesBackEnd::setTimeBudget(const double time)
+{
+    _time_budget = time;
+    _time_spent = 0.;
+    return true;
+}
+
 OpenSoT::HessianType QPOasesBackEnd::getHessianType() {return (OpenSoT::HessianType)(_problem->getHessianType());}
 
 void QPOasesBackEnd::setHessianType(const OpenSoT::HessianType ht){_problem->setHessianType((qpOASES::HessianType)(ht));}
@@ -308,7 +646,7 @@ void QPOasesBackEnd::checkInfeasibility()
 
     std::cout<<std::endl;
     std::cout<<"A = ["<<std::endl;
-    std::cout<<_A<<" ]"<<std::endl;
+    std::cout<<_A_row_major<<" ]"<<std::endl;
     std::cout<<"--------------------------------------------"<<std::endl;
 }
 
@@ -319,6 +657,50 @@ void QPOasesBackEnd::_printProblemInformation()
     XBot::Logger::info("qpOASES # OF VARIABLES: %i\n", _problem->getNV());
 }
 
+const qpOASES::Bounds& QPOasesBackEnd::getActiveBounds()
+{
+    _problem->getBounds(*_bounds);
+    return *_bounds;
+}
+
+const qpOASES::Constraints& QPOasesBackEnd::getActiveConstraints()
+{
+    _problem->getConstraints(*_constraints);
+    return *_constraints;
+}
+
+bool QPOasesBackEnd::getWorkingSet(Eigen::VectorXd& bounds, Eigen::VectorXd& constraints)
+{
+    if(bounds.size() != _problem->getNV())
+        bounds.resize(_problem->getNV());
+    if(constraints.size() != _problem->getNC())
+        constraints.resize(_problem->getNC());
+
+    return _problem->getWorkingSetBounds(bounds.data()) == qpOASES::SUCCESSFUL_RETURN &&
+           (constraints.size() == 0 ||
+            _problem->getWorkingSetConstraints(constraints.data()) == qpOASES::SUCCESSFUL_RETURN);
+}
+
+bool QPOasesBackEnd::setWorkingSetGuess(const Eigen::VectorXd& bounds, const Eigen::VectorXd& constraints)
+{
+    _bounds_guess = bounds;
+    _constraints_guess = constraints;
+    _working_set_guess = true;
+    return true;
+}
+
+const Eigen::MatrixXd& QPOasesBackEnd::getA()
+{
+    _A = _A_row_major;
+    return _A;
+}
+
+BackEnd::MatrixView QPOasesBackEnd::getAView()
+{
+    return MatrixView(_A_row_major.data(), _A_row_major.rows(), _A_row_major.cols(),
+                      Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(1, _A_row_major.cols()));
+}
+
 double QPOasesBackEnd::getObjective()
 {
     return _problem->getObjVal();
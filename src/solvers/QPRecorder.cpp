@@ -0,0 +1,271 @@
+#include <OpenSoT/solvers/QPRecorder.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace OpenSoT::solvers;
+
+#define QP_RECORDER_MAGIC "OSOTQPR"
+#define QP_RECORDER_VERSION 1
+
+namespace {
+
+/**
+ * File layout: a FileHeader followed by the records. Each record is a RecordHeader followed by
+ * H (column major), g, A (column major), lA, uA, l, u, solution and the options, padded to 8 bytes.
+ */
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_header_size;
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t number_of_records;
+    uint64_t dropped_records;
+};
+
+struct RecordHeader
+{
+    uint64_t size;
+    uint64_t tick;
+    double solve_time;
+    double eps_regularisation;
+    int32_t level;
+    int32_t back_end;
+    int32_t hessian_type;
+    int32_t solved;
+    int32_t path;
+    int32_t iterations;
+    int32_t status;
+    int32_t number_of_variables;
+    int32_t number_of_constraints;
+    int32_t number_of_bounds;
+    int32_t options_size;
+    int32_t time_limit_reached;
+};
+
+std::size_t align(const std::size_t size)
+{
+    return (size + 7) & ~std::size_t(7);
+}
+
+char* writeValues(char* data, const double* values, const std::size_t size)
+{
+    std::memcpy(data, values, size*sizeof(double));
+    return data + size*sizeof(double);
+}
+
+const char* readValues(const char* data, double* values, const std::size_t size)
+{
+    std::memcpy(values, data, size*sizeof(double));
+    return data + size*sizeof(double);
+}
+
+}
+
+QPRecorder::QPRecorder(const std::string& file_name, const std::size_t capacity):
+    _file_name(file_name),
+    _capacity(capacity),
+    _fd(-1),
+    _data(NULL)
+{
+    if(_capacity < sizeof(FileHeader))
+        throw std::runtime_error("QPRecorder: capacity of " + file_name + " is too small");
+
+    _fd = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(_fd < 0)
+        throw std::runtime_error("QPRecorder: can not open " + file_name);
+
+    //the blocks are reserved now, so that writing in the mapped memory never fails for lack of space
+    if(::posix_fallocate(_fd, 0, _capacity) != 0)
+    {
+        ::close(_fd);
+        throw std::runtime_error("QPRecorder: can not allocate " + file_name);
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    //prefault the pages, record() does not page fault
+    flags |= MAP_POPULATE;
+#endif
+    void* data = ::mmap(NULL, _capacity, PROT_READ | PROT_WRITE, flags, _fd, 0);
+    if(data == MAP_FAILED)
+    {
+        ::close(_fd);
+        throw std::runtime_error("QPRecorder: can not map " + file_name);
+    }
+    _data = static_cast<char*>(data);
+
+    FileHeader* header = reinterpret_cast<FileHeader*>(_data);
+    std::memset(header, 0, sizeof(FileHeader));
+    std::strncpy(header->magic, QP_RECORDER_MAGIC, sizeof(header->magic));
+    header->version = QP_RECORDER_VERSION;
+    header->record_header_size = sizeof(RecordHeader);
+    header->capacity = _capacity;
+    header->size = sizeof(FileHeader);
+}
+
+QPRecorder::~QPRecorder()
+{
+    const std::size_t size = getSize();
+    ::munmap(_data, _capacity);
+    if(::ftruncate(_fd, size) != 0)
+        XBot::Logger::warning("QPRecorder: can not shrink %s\n", _file_name.c_str());
+    ::close(_fd);
+}
+
+bool QPRecorder::record(const unsigned long tick, const LevelInfo& level_info, BackEnd& back_end,
+                        const bool solved, const double solve_time)
+{
+    FileHeader* file_header = reinterpret_cast<FileHeader*>(_data);
+
+    const Eigen::MatrixXd& A = back_end.getA();
+    const std::size_t n = back_end.getH().rows();
+    const std::size_t m = A.rows();
+    const std::size_t b = back_end.getl().size();
+
+    const std::size_t data_size = sizeof(RecordHeader) + sizeof(double)*(n*n + n + m*n + 2*m + 2*b + n);
+    if(file_header->size + data_size > _capacity)
+    {
+        file_header->dropped_records++;
+        return false;
+    }
+
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(_data + file_header->size);
+    header->tick = tick;
+    header->solve_time = solve_time;
+    header->eps_regularisation = level_info.eps_regularisation;
+    header->level = level_info.level;
+    header->back_end = static_cast<int32_t>(level_info.back_end);
+    header->hessian_type = level_info.hessian_type;
+    header->solved = solved;
+    header->path = back_end.getSolveInfo().path;
+    header->iterations = back_end.getSolveInfo().iterations;
+    header->status = back_end.getSolveInfo().status;
+    header->number_of_variables = n;
+    header->number_of_constraints = m;
+    header->number_of_bounds = b;
+    header->time_limit_reached = back_end.getSolveInfo().time_limit_reached;
+
+    char* data = reinterpret_cast<char*>(header + 1);
+    data = writeValues(data, back_end.getH().data(), n*n);
+    data = writeValues(data, back_end.getg().data(), n);
+    data = writeValues(data, A.data(), m*n);
+    data = writeValues(data, back_end.getlA().data(), m);
+    data = writeValues(data, back_end.getuA().data(), m);
+    data = writeValues(data, back_end.getl().data(), b);
+    data = writeValues(data, back_end.getu().data(), b);
+    data = writeValues(data, back_end.getSolution().data(), n);
+
+    //the options are written straight in the file, they are dropped if they do not fit
+    const std::size_t options_size = back_end.writeOptions(data, _capacity - file_header->size - data_size);
+    header->options_size = options_size;
+    header->size = align(data_size + options_size);
+
+    //the record is published only once it is complete
+    std::atomic_thread_fence(std::memory_order_release);
+    file_header->size = std::min<std::size_t>(file_header->size + header->size, _capacity);
+    file_header->number_of_records++;
+
+    return true;
+}
+
+unsigned long QPRecorder::getNumberOfRecords() const
+{
+    return reinterpret_cast<const FileHeader*>(_data)->number_of_records;
+}
+
+unsigned long QPRecorder::getNumberOfDroppedRecords() const
+{
+    return reinterpret_cast<const FileHeader*>(_data)->dropped_records;
+}
+
+std::size_t QPRecorder::getSize() const
+{
+    return reinterpret_cast<const FileHeader*>(_data)->size;
+}
+
+QPRecording::QPRecording(const std::string& file_name)
+{
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    if(!file)
+        throw std::runtime_error("QPRecording: can not open " + file_name);
+    _data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if(_data.size() < sizeof(FileHeader))
+        throw std::runtime_error("QPRecording: " + file_name + " is not a recording");
+
+    FileHeader header;
+    std::memcpy(&header, _data.data(), sizeof(FileHeader));
+    if(std::strncmp(header.magic, QP_RECORDER_MAGIC, sizeof(header.magic)) != 0 ||
+       header.record_header_size != sizeof(RecordHeader))
+        throw std::runtime_error("QPRecording: " + file_name + " is not a recording");
+    if(header.version != QP_RECORDER_VERSION)
+        throw std::runtime_error("QPRecording: version of " + file_name + " is not supported");
+
+    //a recording which has not been closed can be longer than the recorded data
+    const std::size_t size = std::min<std::size_t>(header.size, _data.size());
+    std::size_t offset = sizeof(FileHeader);
+    while(_offsets.size() < header.number_of_records && offset + sizeof(RecordHeader) <= size)
+    {
+        RecordHeader record;
+        std::memcpy(&record, _data.data() + offset, sizeof(RecordHeader));
+        if(record.size < sizeof(RecordHeader) || offset + record.size > size)
+            break;
+        _offsets.push_back(offset);
+        offset += record.size;
+    }
+}
+
+bool QPRecording::read(const unsigned long index, Problem& problem) const
+{
+    if(index >= _offsets.size())
+        return false;
+
+    RecordHeader header;
+    std::memcpy(&header, _data.data() + _offsets[index], sizeof(RecordHeader));
+
+    problem.tick = header.tick;
+    problem.level_info.level = header.level;
+    problem.level_info.back_end = static_cast<solver_back_ends>(header.back_end);
+    problem.level_info.hessian_type = static_cast<OpenSoT::HessianType>(header.hessian_type);
+    problem.level_info.eps_regularisation = header.eps_regularisation;
+    problem.solved = header.solved;
+    problem.solve_info.path = static_cast<BackEnd::SolvePath>(header.path);
+    problem.solve_info.iterations = header.iterations;
+    problem.solve_info.status = header.status;
+    problem.solve_info.time_limit_reached = header.time_limit_reached;
+    problem.solve_time = header.solve_time;
+
+    const int n = header.number_of_variables;
+    const int m = header.number_of_constraints;
+    const int b = header.number_of_bounds;
+    problem.H.resize(n, n);
+    problem.g.resize(n);
+    problem.A.resize(m, n);
+    problem.lA.resize(m);
+    problem.uA.resize(m);
+    problem.l.resize(b);
+    problem.u.resize(b);
+    problem.solution.resize(n);
+
+    const char* data = _data.data() + _offsets[index] + sizeof(RecordHeader);
+    data = readValues(data, problem.H.data(), n*n);
+    data = readValues(data, problem.g.data(), n);
+    data = readValues(data, problem.A.data(), m*n);
+    data = readValues(data, problem.lA.data(), m);
+    data = readValues(data, problem.uA.data(), m);
+    data = readValues(data, problem.l.data(), b);
+    data = readValues(data, problem.u.data(), b);
+    data = readValues(data, problem.solution.data(), n);
+    problem.options.assign(data, data + header.options_size);
+
+    return true;
+}
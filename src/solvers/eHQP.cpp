@@ -9,7 +9,8 @@
 
 using namespace OpenSoT::solvers;
 
-eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigma_min(Eigen::NumTraits<double>::epsilon())
+eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigma_min(Eigen::NumTraits<double>::epsilon()),
+    _decomposition(SVD), _pinv_strategy(PINV_SVD)
 {
     if(stack.size() > 0)
     {
@@ -22,6 +23,7 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
             if(i == 0)
             {
                 lvl._P = Eigen::MatrixXd::Identity(_x_size, _x_size);
+                lvl._Z = Eigen::MatrixXd::Identity(_x_size, _x_size);
             }
             else
             {
@@ -46,7 +48,14 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
 
                 #endif
 
+                lvl._JPJPt = Eigen::MatrixXd::Identity(
+                    _tasks[i-1]->getA().rows(), _tasks[i-1]->getA().rows());
+                lvl._JPJPtLDLT = Eigen::LDLT<Eigen::MatrixXd>(_tasks[i-1]->getA().rows());
 
+                lvl._W.resize(0,0);
+                lvl._W_identity = false;
+                lvl._JZqr = Eigen::ColPivHouseholderQR<Eigen::MatrixXd>(
+                            _x_size, _tasks[i-1]->getA().rows());
             }
             _stack_levels.push_back(lvl);
 
@@ -62,13 +71,57 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
 }
 
 bool eHQP::solve(Eigen::VectorXd& solution)
+{
+    if(_decomposition == NULL_SPACE_BASIS)
+        return solveNullSpaceBasis(solution);
+    return solveSVD(solution);
+}
+
+void eHQP::updateWeight(const unsigned int i)
+{
+    stack_level& lvl = _stack_levels[i];
+    const Eigen::MatrixXd& W = _tasks[i-1]->getWeight();
+
+    if(lvl._W.rows() != W.rows() || lvl._W.cols() != W.cols() || lvl._W != W)
+    {
+        lvl._W = W;
+        lvl._W_identity = W.isIdentity(0.);
+        if(!lvl._W_identity)
+            lvl._WChol.compute(W);
+    }
+
+    if(lvl._W_identity)
+    {
+        lvl._LA = _tasks[i-1]->getA();
+        lvl._Lb = _tasks[i-1]->getb();
+    }
+    else
+    {
+        lvl._LA.noalias() = lvl._WChol.matrixL().transpose() * _tasks[i-1]->getA();
+        lvl._Lb.noalias() = lvl._WChol.matrixL().transpose() * _tasks[i-1]->getb();
+    }
+}
+
+bool eHQP::solveSVD(Eigen::VectorXd& solution)
 {
     solution.setZero(solution.size());
     for(unsigned int i = 1; i <= _tasks.size(); ++i)
     {
-        _stack_levels[i]._WChol.compute(_tasks[i-1]->getWeight());
+        updateWeight(i);
+
+        _stack_levels[i]._JP.noalias() = _stack_levels[i]._LA*_stack_levels[i-1]._P;
+
+        if(_pinv_strategy == PINV_LDLT && computeLDLTPinv(i))
+        {
+            solution += _stack_levels[i]._JPpinv * (
+                        _stack_levels[i]._Lb - _stack_levels[i]._LA*solution);
+
+            // JP^+JP = VV'
+            _stack_levels[i]._P = _stack_levels[i-1]._P;
+            _stack_levels[i]._P.noalias() -= _stack_levels[i]._JPpinv * _stack_levels[i]._JP;
+            continue;
+        }
 
-        _stack_levels[i]._JP = _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*_stack_levels[i-1]._P;
         _stack_levels[i]._JPsvd.compute(_stack_levels[i]._JP);
 
 #if EIGEN_MINOR_VERSION <= 0
@@ -82,14 +135,99 @@ bool eHQP::solve(Eigen::VectorXd& solution)
 #endif
 
          solution += _stack_levels[i]._JPpinv * (
-                     _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getb()-
-                 _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*solution
-                 );
+                     _stack_levels[i]._Lb - _stack_levels[i]._LA*solution);
+
+
+
+        // only the right singular vectors of the non-zero singular values span the row space of JP
+#if EIGEN_MINOR_VERSION <= 0
+        const int rank = _stack_levels[i]._FPL.rank();
+#else
+        const int rank = _stack_levels[i]._JPsvd.rank();
+#endif
+        _stack_levels[i]._P = _stack_levels[i-1]._P;
+        _stack_levels[i]._P.noalias() -= _stack_levels[i]._JPsvd.matrixV().leftCols(rank) *
+                _stack_levels[i]._JPsvd.matrixV().leftCols(rank).transpose();
+    }
+    return true;
+}
+
+bool eHQP::computeLDLTPinv(const unsigned int i)
+{
+    stack_level& lvl = _stack_levels[i];
+    if(lvl._JP.rows() == 0 || lvl._JP.rows() > lvl._JP.cols())
+        return false;
+
+    lvl._JPJPt.noalias() = lvl._JP*lvl._JP.transpose();
+    lvl._JPJPtLDLT.compute(lvl._JPJPt);
+    if(lvl._JPJPtLDLT.info() != Eigen::Success)
+        return false;
+
+    const double max_pivot = lvl._JPJPtLDLT.vectorD().cwiseAbs().maxCoeff();
+    const double min_pivot = lvl._JPJPtLDLT.vectorD().minCoeff();
+    if(min_pivot <= PINV_LDLT_CONDITIONING*max_pivot || min_pivot < sigma_min*sigma_min)
+        return false;
+
+    // JP^+ = JP'(JPJP')^-1 = ((JPJP')^-1 JP)'
+    lvl._JPpinv.transpose() = lvl._JPJPtLDLT.solve(lvl._JP);
+    return true;
+}
 
+bool eHQP::solveNullSpaceBasis(Eigen::VectorXd& solution)
+{
+    solution.setZero(_x_size);
+    for(unsigned int i = 1; i <= _tasks.size(); ++i)
+    {
+        updateWeight(i);
 
+        stack_level& lvl = _stack_levels[i];
+        const Eigen::MatrixXd& Z = _stack_levels[i-1]._Z;
+        const int k = Z.cols();
+        const int m = lvl._LA.rows();
+
+        if(k == 0 || m == 0)
+        {
+            lvl._Z = Z;
+            continue;
+        }
+
+        // (JZ)' Pi = Q [R11 R12; 0 0] with R11 r x r, hence JZ = Pi [R11 R12]' Q1'
+        lvl._JP.noalias() = lvl._LA*Z;
+        lvl._JZqr.compute(lvl._JP.transpose());
+        const int r = lvl._JZqr.rank();
+
+        if(r > 0)
+        {
+            // minimum norm solution of JZ y = Lb - LA x: y = Q1 w with
+            // [R11 R12]' w = Pi' (Lb - LA x) in the least squares sense
+            lvl._residual = lvl._Lb;
+            lvl._residual.noalias() -= lvl._LA*solution;
+            lvl._residual.applyOnTheLeft(lvl._JZqr.colsPermutation().transpose());
+
+            if(r == m)
+            {
+                lvl._w = lvl._JZqr.matrixQR().topLeftCorner(r, r).transpose().
+                        triangularView<Eigen::Lower>().solve(lvl._residual);
+            }
+            else
+            {
+                lvl._R = lvl._JZqr.matrixQR().topRows(r).triangularView<Eigen::Upper>();
+                lvl._RRt.noalias() = lvl._R*lvl._R.transpose();
+                lvl._RRtChol.compute(lvl._RRt);
+                lvl._w.noalias() = lvl._R*lvl._residual;
+                lvl._RRtChol.solveInPlace(lvl._w);
+            }
+
+            lvl._y.setZero(k);
+            lvl._y.head(r) = lvl._w;
+            lvl._y.applyOnTheLeft(lvl._JZqr.householderQ());
+            solution.noalias() += Z*lvl._y;
+        }
 
-        _stack_levels[i]._P = _stack_levels[i-1]._P -
-                _stack_levels[i]._JPsvd.matrixV() * _stack_levels[i]._JPsvd.matrixV().transpose();
+        // the basis of the null-space of this level are the last k - r columns of Z Q
+        lvl._ZQ = Z;
+        lvl._ZQ.applyOnTheRight(lvl._JZqr.householderQ());
+        lvl._Z = lvl._ZQ.rightCols(k - r);
     }
     return true;
 }
@@ -157,7 +295,10 @@ void eHQP::setSigmaMin(const double& sigma_min)
     if(sigma_min > 0)
     {
         for(unsigned int i = 0; i < _stack_levels.size(); ++i)
+        {
             _stack_levels[i]._FPL.setThreshold(sigma_min);
+            _stack_levels[i]._JZqr.setThreshold(sigma_min);
+        }
 
         this->sigma_min = sigma_min;
     }
@@ -170,7 +311,10 @@ void eHQP::setSigmaMin(const double& sigma_min)
         // for(unsigned int i = 0; i < _JPsvd.size(); ++i)
         //    _JPsvd[i].setThreshold(sigma_min);
         for(unsigned int i = 0; i < _stack_levels.size(); ++i)
+        {
             _stack_levels[i]._JPsvd.setThreshold(sigma_min);
+            _stack_levels[i]._JZqr.setThreshold(sigma_min);
+        }
 
 
         this->sigma_min = sigma_min;
@@ -178,6 +322,26 @@ void eHQP::setSigmaMin(const double& sigma_min)
 }
 #endif
 
+void eHQP::setDecomposition(const Decomposition decomposition)
+{
+    _decomposition = decomposition;
+}
+
+eHQP::Decomposition eHQP::getDecomposition() const
+{
+    return _decomposition;
+}
+
+void eHQP::setPinvStrategy(const PinvStrategy strategy)
+{
+    _pinv_strategy = strategy;
+}
+
+eHQP::PinvStrategy eHQP::getPinvStrategy() const
+{
+    return _pinv_strategy;
+}
+
 void eHQP::printProblemInformation(const int problem_number, const std::string& problem_id,
                                       const std::string& constraints_id, const std::string& bounds_id)
 {
@@ -1,13 +1,21 @@
 #include <OpenSoT/solvers/iHQP.h>
 #include <OpenSoT/constraints/BilateralConstraint.h>
 #include <XBotInterface/Logger.hpp>
+#include <chrono>
 
 
 using namespace OpenSoT::solvers;
 
 iHQP::iHQP(Stack &stack_of_tasks, const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -22,7 +30,14 @@ iHQP::iHQP(Stack& stack_of_tasks, const double eps_regularisation,
      const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks),
     _epsRegularisation(eps_regularisation),
-    _be_solver(be_solver)
+    _be_solver(be_solver),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
         _active_stacks.push_back(true);
@@ -35,7 +50,14 @@ iHQP::iHQP(Stack &stack_of_tasks,
                          ConstraintPtr bounds,
                          const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks, bounds),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -52,7 +74,14 @@ iHQP::iHQP(Stack& stack_of_tasks,
             const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks, bounds),
     _epsRegularisation(eps_regularisation),
-    _be_solver(be_solver)
+    _be_solver(be_solver),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
         _active_stacks.push_back(true);
@@ -66,7 +95,14 @@ iHQP::iHQP(Stack &stack_of_tasks,
                          ConstraintPtr globalConstraints,
                          const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks, bounds, globalConstraints),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -84,7 +120,14 @@ iHQP::iHQP(Stack& stack_of_tasks,
             const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks, bounds, globalConstraints),
     _epsRegularisation(eps_regularisation),
-    _be_solver(be_solver)
+    _be_solver(be_solver),
+    _time_budget(0.),
+    _last_solved_level(-1),
+    _deadline_missed(false),
+    _tick_telemetry(NULL),
+    _telemetry_ticks(0),
+    _recorder_ticks(0),
+    _working_set_transfer(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
         _active_stacks.push_back(true);
@@ -93,61 +136,187 @@ iHQP::iHQP(Stack& stack_of_tasks,
         throw std::runtime_error("Can Not initizalize SoT with bounds!");
 }
 
-void iHQP::computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::VectorXd& g)
+void iHQP::computeCostFunction(const TaskPtr& task, Eigen::Ref<Eigen::MatrixXd> H, Eigen::Ref<Eigen::VectorXd> g)
 {
 //    H = task->getA().transpose() * task->getWeight() * task->getA();
 //    g = -1.0 * task->getA().transpose() * task->getWeight() * task->getb();
 
+    computeGradient(task, g);
 
-    H.resize(task->getXSize(), task->getXSize());
-    if(task->getWeight().isIdentity())
+    const Eigen::MatrixXd& A = task->getA();
+    const bool identity_weight = task->getWeight().isIdentity();
+    const bool diagonal_weight = identity_weight || task->getWeightIsDiagonalFlag();
+
+    switch(task->getJacobianStructure())
     {
-        H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getA();
-        H = H.selfadjointView<Eigen::Upper>();
-        g.noalias() = -1.0 * task->getATranspose() * task->getb();
-        g += task->getc();
+    case JS_IDENTITY:
+        //H = W
+        H = task->getWeight();
+        return;
+
+    case JS_DIAGONAL_SELECTION:
+        if(diagonal_weight)
+        {
+            //the i-th row of A is d*e_j: H(j,j) += w_i*d^2
+            H.setZero();
+            for(unsigned int i = 0; i < A.rows(); ++i)
+            {
+                for(unsigned int j = 0; j < A.cols(); ++j)
+                {
+                    if(A(i,j) != 0.)
+                    {
+                        const double w = identity_weight ? 1. : task->getWeight()(i,i);
+                        H(j,j) += w*A(i,j)*A(i,j);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+        break;
+
+    case JS_BLOCK_SPARSE:
+    {
+        //only the block of the non zero columns is computed
+        const unsigned int start = task->getJacobianBlockStart();
+        const unsigned int size = task->getJacobianBlockSize();
+        H.setZero();
+        if(identity_weight)
+            H.block(start, start, size, size).selfadjointView<Eigen::Upper>().rankUpdate(A.middleCols(start, size).transpose());
+        else
+            H.block(start, start, size, size).triangularView<Eigen::Upper>() =
+                    A.middleCols(start, size).transpose() * task->getWA().middleCols(start, size);
+        H.block(start, start, size, size) = H.block(start, start, size, size).selfadjointView<Eigen::Upper>();
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    //general case: the upper triangular part of H is computed without copying A transposed
+    if(identity_weight)
+    {
+        H.setZero();
+        H.selfadjointView<Eigen::Upper>().rankUpdate(A.transpose());
     }
     else
+        H.triangularView<Eigen::Upper>() = A.transpose()*task->getWA();
+    H = H.selfadjointView<Eigen::Upper>();
+}
+
+void iHQP::computeGradient(const TaskPtr& task, Eigen::Ref<Eigen::VectorXd> g)
+{
+    const Eigen::MatrixXd& A = task->getA();
+    const bool identity_weight = task->getWeight().isIdentity();
+    const bool diagonal_weight = identity_weight || task->getWeightIsDiagonalFlag();
+
+    switch(task->getJacobianStructure())
     {
-        H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getWA();
-        H = H.selfadjointView<Eigen::Upper>();
-        g.noalias() = -1.0 * task->getATranspose() * task->getWb();
+    case JS_IDENTITY:
+        //g = -Wb
+        g.noalias() = -1.0 * task->getWb();
         g += task->getc();
+        return;
+
+    case JS_DIAGONAL_SELECTION:
+        if(diagonal_weight)
+        {
+            //the i-th row of A is d*e_j: g(j) -= w_i*d*b_i
+            g = task->getc();
+            for(unsigned int i = 0; i < A.rows(); ++i)
+            {
+                for(unsigned int j = 0; j < A.cols(); ++j)
+                {
+                    if(A(i,j) != 0.)
+                    {
+                        const double w = identity_weight ? 1. : task->getWeight()(i,i);
+                        g(j) -= w*A(i,j)*task->getb()(i);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+        break;
+
+    case JS_BLOCK_SPARSE:
+    {
+        const unsigned int start = task->getJacobianBlockStart();
+        const unsigned int size = task->getJacobianBlockSize();
+        g = task->getc();
+        if(identity_weight)
+            g.segment(start, size).noalias() -= A.middleCols(start, size).transpose() * task->getb();
+        else
+            g.segment(start, size).noalias() -= A.middleCols(start, size).transpose() * task->getWb();
+        return;
+    }
+
+    default:
+        break;
     }
-    
-    
+
+    if(identity_weight)
+        g.noalias() = -1.0 * A.transpose() * task->getb();
+    else
+        g.noalias() = -1.0 * A.transpose() * task->getWb();
+    g += task->getc();
 }
 
 void iHQP::computeOptimalityConstraint(  const TaskPtr& task, BackEnd::Ptr& problem,
                                                 Eigen::MatrixXd& A, Eigen::VectorXd& lA, Eigen::VectorXd& uA)
 {
     A = task->getA();
-    lA = task->getA()*problem->getSolution();
+    lA.noalias() = A*problem->getSolution();
     uA = lA;
 }
 
 bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
 {   
+    //global constraints and bounds are aggregated once for all the levels
+    std::list<ConstraintPtr> shared_constraints;
+    if(_globalConstraints)
+        shared_constraints.push_back(_globalConstraints);
+    else if(_bounds && _bounds->isConstraint())
+        shared_constraints.push_back(_bounds);
+    if(_bounds && _bounds->isBound())
+        shared_constraints.push_back(_bounds);
+    //equalities and bilateral constraints are passed to the back-ends as single rows
+    _shared_constraints.reset(new OpenSoT::constraints::Aggregated(shared_constraints,
+                                                                   _tasks.empty() ? 0 : _tasks[0]->getXSize(),
+                                                                   OpenSoT::constraints::Aggregated::NATIVE_BILATERAL));
+    generateSharedConstraints();
+    _levels_lower_bound.resize(_tasks.size());
+    _levels_upper_bound.resize(_tasks.size());
+
     for(unsigned int i = 0; i < _tasks.size(); ++i)
     {
         XBot::Logger::info("#USING BACK-END @LEVEL %i: %s\n", i, getBackEndName(i).c_str());
+        H.resize(_tasks[i]->getXSize(), _tasks[i]->getXSize());
+        g.resize(_tasks[i]->getXSize());
         computeCostFunction(_tasks[i], H, g);
 
-        OpenSoT::constraints::Aggregated constraints_task_i(_tasks[i]->getConstraints(), _tasks[i]->getXSize());
-        if(_globalConstraints){
-            constraints_task_i.getConstraintsList().push_back(_globalConstraints);
-            constraints_task_i.generateAll();}
-        else if(_bounds && _bounds->isConstraint())
+        constraints_task.push_back(OpenSoT::constraints::Aggregated(_tasks[i]->getConstraints(), _tasks[i]->getXSize(),
+                                                                    OpenSoT::constraints::Aggregated::NATIVE_BILATERAL));
+        OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task.back();
+        mergeLevelBounds(i);
+
+        std::string constraints_str = "";
+        if(!constraints_task_i.getConstraintsList().empty())
+            constraints_str = constraints_task_i.getConstraintID();
+        if(_globalConstraints || (_bounds && _bounds->isConstraint()))
         {
-            constraints_task_i.getConstraintsList().push_back(_bounds);
-            constraints_task_i.generateAll();
+            if(!constraints_str.compare("") == 0)
+                constraints_str = constraints_str + "+";
+            constraints_str = constraints_str + shared_constraints.front()->getConstraintID();
         }
 
-        std::string constraints_str = constraints_task_i.getConstraintID();
-
         A.set(constraints_task_i.getAineq());
         lA.set(constraints_task_i.getbLowerBound());
         uA.set(constraints_task_i.getbUpperBound());
+        A.pile(_shared_constraints->getAineq());
+        lA.pile(_shared_constraints->getbLowerBound());
+        uA.pile(_shared_constraints->getbUpperBound());
         if(i > 0)
         {
             Eigen::MatrixXd _tmp_A;
@@ -173,11 +342,8 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
             }
         }
 
-        if(_bounds && _bounds->isBound()){   // if it is a constraint, it has already been added in #74
-            constraints_task_i.getConstraintsList().push_back(_bounds);
-            constraints_task_i.generateAll();}
-        l = constraints_task_i.getLowerBound();
-        u = constraints_task_i.getUpperBound();
+        l = getLevelLowerBound(i);
+        u = getLevelUpperBound(i);
 
 //        QPOasesBackEnd problem_i(_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
 //                                 _epsRegularisation);
@@ -196,74 +362,479 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
         else{
             XBot::Logger::error("ERROR: INITIALIZING STACK %i \n", i);
             return false;}
+    }
 
-
-        constraints_task.push_back(constraints_task_i);
+    //the first solve passes all the data to the back-ends
+    _optimality_versions.assign(tmp_A.size(), 0);
+    LevelVersions versions;
+    versions.valid = false;
+    versions.task = versions.task_matrix = 0;
+    versions.constraints = versions.constraints_matrix = 0;
+    versions.shared = versions.shared_matrix = 0;
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        versions.optimality_matrix.assign(i, 0);
+        _committed_versions.push_back(versions);
+        _assembled_versions.push_back(versions);
     }
+
+    _rows_layout.resize(_tasks.size());
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+        computeRowsLayout(i, _rows_layout[i]);
+
+    _assembly_job = [this](const unsigned int i){
+        if(_active_stacks[i])
+            assembleLevel(i);};
+
     return true;
 }
 
+void iHQP::generateSharedConstraints()
+{
+    _shared_constraints->generateAll();
+    _shared_matrix_version = _shared_constraints->getMatrixVersion();
+    _shared_version = _shared_constraints->getVersion();
+}
+
+void iHQP::mergeLevelBounds(const unsigned int i)
+{
+    //the bounds of the tasks are merged as constraints::Aggregated does, only if the level has both
+    OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task[i];
+    if(!constraints_task_i.hasBounds() || !_shared_constraints->hasBounds())
+        return;
+    _levels_lower_bound[i] = constraints_task_i.getLowerBound().cwiseMax(_shared_constraints->getLowerBound());
+    _levels_upper_bound[i] = constraints_task_i.getUpperBound().cwiseMin(_shared_constraints->getUpperBound());
+}
+
+bool iHQP::hasLevelBounds(const unsigned int i)
+{
+    return constraints_task[i].hasBounds() || _shared_constraints->hasBounds();
+}
+
+const Eigen::VectorXd& iHQP::getLevelLowerBound(const unsigned int i)
+{
+    if(!constraints_task[i].hasBounds())
+        return _shared_constraints->getLowerBound();
+    if(!_shared_constraints->hasBounds())
+        return constraints_task[i].getLowerBound();
+    return _levels_lower_bound[i];
+}
+
+const Eigen::VectorXd& iHQP::getLevelUpperBound(const unsigned int i)
+{
+    if(!constraints_task[i].hasBounds())
+        return _shared_constraints->getUpperBound();
+    if(!_shared_constraints->hasBounds())
+        return constraints_task[i].getUpperBound();
+    return _levels_upper_bound[i];
+}
+
+void iHQP::assembleLevel(const unsigned int i)
+{
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start;
+    if(_tick_telemetry)
+        start = clock::now();
+
+    //H and g are left in the back-end as they are if the task did not change
+    const LevelVersions& committed = _committed_versions[i];
+    LevelVersions& assembled = _assembled_versions[i];
+    assembled.task_matrix = _tasks[i]->getMatrixVersion();
+    assembled.task = _tasks[i]->getVersion();
+    if(!committed.valid || assembled.task_matrix != committed.task_matrix)
+        computeCostFunction(_tasks[i], _qp_stack_of_tasks[i]->getHView(), _qp_stack_of_tasks[i]->getgView());
+    else if(assembled.task != committed.task)
+        computeGradient(_tasks[i], _qp_stack_of_tasks[i]->getgView());
+
+    constraints_task[i].generateAll();
+    mergeLevelBounds(i);
+    assembled.constraints_matrix = constraints_task[i].getMatrixVersion();
+    assembled.constraints = constraints_task[i].getVersion();
+    assembled.shared_matrix = _shared_matrix_version;
+    assembled.shared = _shared_version;
+
+    if(_tick_telemetry)
+        _assembly_time[i] = std::chrono::duration<double>(clock::now() - start).count();
+}
+
+bool iHQP::updateConstraints(const unsigned int i)
+{
+    OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task[i];
+    BackEnd::Ptr& problem_i = _qp_stack_of_tasks[i];
+    const LevelVersions& committed = _committed_versions[i];
+    LevelVersions& assembled = _assembled_versions[i];
+
+    //The optimality constraints of the previous levels are computed once,
+    //right after each level is solved, and here they are just piled
+    const Eigen::MatrixXd& A_shared = _shared_constraints->getAineq();
+    int rows = constraints_task_i.getAineq().rows() + A_shared.rows();
+    bool matrix_changed = !committed.valid || assembled.constraints_matrix != committed.constraints_matrix ||
+            assembled.shared_matrix != committed.shared_matrix;
+    for(unsigned int j = 0; j < i; ++j)
+    {
+        rows += tmp_A[j].rows();
+        assembled.optimality_matrix[j] = _optimality_versions[j];
+        matrix_changed = matrix_changed || assembled.optimality_matrix[j] != committed.optimality_matrix[j];
+    }
+
+    if(_working_set_transfer && rows != problem_i->getNumConstraints())
+        transferWorkingSet(i);
+    computeRowsLayout(i, _rows_layout[i]);
+
+    if(rows == problem_i->getNumConstraints())
+    {
+        //the bounds of the optimality constraints depend on the solution of the previous levels
+        const bool constraints_changed = matrix_changed || assembled.constraints != committed.constraints ||
+                assembled.shared != committed.shared;
+        if(!constraints_changed && i == 0)
+            return true;
+
+        BackEnd::MatrixView A_i = problem_i->getAView();
+        Eigen::Ref<Eigen::VectorXd> lA_i = problem_i->getlAView();
+        Eigen::Ref<Eigen::VectorXd> uA_i = problem_i->getuAView();
+
+        int r = constraints_task_i.getAineq().rows();
+        if(matrix_changed)
+        {
+            A_i.topRows(r) = constraints_task_i.getAineq();
+            A_i.middleRows(r, A_shared.rows()) = A_shared;
+        }
+        if(constraints_changed)
+        {
+            lA_i.head(r) = constraints_task_i.getbLowerBound();
+            uA_i.head(r) = constraints_task_i.getbUpperBound();
+            lA_i.segment(r, A_shared.rows()) = _shared_constraints->getbLowerBound();
+            uA_i.segment(r, A_shared.rows()) = _shared_constraints->getbUpperBound();
+        }
+        r += A_shared.rows();
+        for(unsigned int j = 0; j < i; ++j)
+        {
+            if(matrix_changed)
+                A_i.middleRows(r, tmp_A[j].rows()) = tmp_A[j];
+            lA_i.segment(r, tmp_lA[j].size()) = tmp_lA[j];
+            uA_i.segment(r, tmp_uA[j].size()) = tmp_uA[j];
+            r += tmp_A[j].rows();
+        }
+
+        if(matrix_changed)
+            return problem_i->commitConstraints();
+        return problem_i->commitConstraintsBounds();
+    }
+
+    A.set(constraints_task_i.getAineq());
+    lA.set(constraints_task_i.getbLowerBound());
+    uA.set(constraints_task_i.getbUpperBound());
+    A.pile(A_shared);
+    lA.pile(_shared_constraints->getbLowerBound());
+    uA.pile(_shared_constraints->getbUpperBound());
+    for(unsigned int j = 0; j < i; ++j)
+    {
+        A.pile(tmp_A[j]);
+        lA.pile(tmp_lA[j]);
+        uA.pile(tmp_uA[j]);
+    }
+
+    return problem_i->updateConstraints(A.generate_and_get(), lA.generate_and_get(), uA.generate_and_get());
+}
+
+void iHQP::computeRowsLayout(const unsigned int i, std::vector<RowsBlock>& layout)
+{
+    layout.clear();
+
+    //each constraint piles its equality and inequality rows (see constraints::Aggregated),
+    //the shared constraints follow the ones of the tasks
+    std::list<ConstraintPtr>* constraints[2] = {&constraints_task[i].getConstraintsList(),
+                                                &_shared_constraints->getConstraintsList()};
+    for(unsigned int k = 0; k < 2; ++k)
+    {
+        for(std::list<ConstraintPtr>::iterator c = constraints[k]->begin(); c != constraints[k]->end(); ++c)
+        {
+            RowsBlock block;
+            block.owner = c->get();
+            block.rows = (*c)->getAeq().rows() + (*c)->getAineq().rows();
+            if(block.rows > 0)
+                layout.push_back(block);
+        }
+    }
+
+    for(unsigned int j = 0; j < i; ++j)
+    {
+        RowsBlock block;
+        block.owner = _tasks[j].get();
+        block.rows = tmp_A[j].rows();
+        layout.push_back(block);
+    }
+}
+
+void iHQP::transferWorkingSet(const unsigned int i)
+{
+    auto sumRows = [](const std::vector<RowsBlock>& layout){
+        int rows = 0;
+        for(unsigned int k = 0; k < layout.size(); ++k)
+            rows += layout[k].rows;
+        return rows;};
+
+    //first row of the block with the same owner and size in layout, -1 if not found
+    auto findBlock = [](const std::vector<RowsBlock>& layout, const RowsBlock& block){
+        int row = 0;
+        for(unsigned int k = 0; k < layout.size(); ++k)
+        {
+            if(layout[k].owner == block.owner)
+                return layout[k].rows == block.rows ? row : -1;
+            row += layout[k].rows;
+        }
+        return -1;};
+
+    //the back-end is initialized again: this is not done at every solve and it allocates anyway
+    Eigen::VectorXd bounds, constraints;
+    if(!_qp_stack_of_tasks[i]->getWorkingSet(bounds, constraints) ||
+       sumRows(_rows_layout[i]) != constraints.size())
+        return;
+
+    //the previous level has been solved in this solve
+    Eigen::VectorXd previous_bounds, previous_constraints;
+    const bool previous = i > 0 && _active_stacks[i-1] &&
+            _qp_stack_of_tasks[i-1]->getWorkingSet(previous_bounds, previous_constraints) &&
+            sumRows(_rows_layout[i-1]) == previous_constraints.size();
+
+    //the bounds are shared only if they are the same
+    const Eigen::VectorXd& l_i = getLevelLowerBound(i);
+    const Eigen::VectorXd& u_i = getLevelUpperBound(i);
+    if(previous && l_i.size() == bounds.size() && u_i.size() == bounds.size() &&
+       getLevelLowerBound(i-1).size() == l_i.size() &&
+       getLevelLowerBound(i-1) == l_i && getLevelUpperBound(i-1) == u_i)
+        bounds = previous_bounds;
+
+    std::vector<RowsBlock> layout;
+    computeRowsLayout(i, layout);
+
+    //the optimality rows (the last i blocks) keep their own states: the working set of level i-1 may
+    //depend linearly on the optimality constraint of its task, which is an equality in level i
+    const unsigned int shared_blocks = layout.size() - i;
+
+    Eigen::VectorXd guess = Eigen::VectorXd::Zero(sumRows(layout));
+    int row = 0;
+    for(unsigned int k = 0; k < layout.size(); ++k)
+    {
+        int source_row = -1;
+        if(previous && k < shared_blocks && (source_row = findBlock(_rows_layout[i-1], layout[k])) >= 0)
+            guess.segment(row, layout[k].rows) = previous_constraints.segment(source_row, layout[k].rows);
+        else if((source_row = findBlock(_rows_layout[i], layout[k])) >= 0)
+            guess.segment(row, layout[k].rows) = constraints.segment(source_row, layout[k].rows);
+        row += layout[k].rows;
+    }
+
+    _qp_stack_of_tasks[i]->setWorkingSetGuess(bounds, guess);
+}
+
 bool iHQP::solve(Eigen::VectorXd &solution)
 {
+    if(!_telemetry)
+        return solveLevels(solution);
+
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+
+    _tick_telemetry = &_telemetry->beginWrite();
+    _tick_telemetry->tick = _telemetry_ticks++;
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        LevelTelemetry& level = _tick_telemetry->levels[i];
+        level.active = _active_stacks[i];
+        level.solved = false;
+        level.assembly_time = 0.;
+        level.solve_time = 0.;
+        _assembly_time[i] = 0.;
+    }
+
+    bool solved = solveLevels(solution);
+    _tick_telemetry->solved = solved;
+    _tick_telemetry->deadline_missed = _deadline_missed;
+    _tick_telemetry->solve_time = std::chrono::duration<double>(clock::now() - start).count();
+
+    _telemetry->endWrite();
+    _tick_telemetry = NULL;
+
+    return solved;
+}
+
+bool iHQP::solveLevels(Eigen::VectorXd &solution)
+{
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    const bool deadline = _time_budget > 0.;
+
+    _last_solved_level = -1;
+    _deadline_missed = false;
+
+    const unsigned long recorder_tick = _recorder_ticks;
+    if(_recorder)
+        _recorder_ticks++;
+
+    //The shared constraints are generated once for all the levels.
+    //Cost functions and constraints do not depend on the solution of the previous levels
+    generateSharedConstraints();
+    if(_assembly_pool)
+        _assembly_pool->run(_tasks.size(), _assembly_job);
+
     for(unsigned int i = 0; i < _tasks.size(); ++i)
     {
         if(_active_stacks[i])
         {
-            computeCostFunction(_tasks[i], H, g);
-            if(!_qp_stack_of_tasks[i]->updateTask(H, g))
-                return false;
+            clock::time_point level_start;
+            if(_tick_telemetry)
+                level_start = clock::now();
 
-            OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task[i];
-            constraints_task_i.generateAll();
+            if(!_assembly_pool)
+                assembleLevel(i);
 
-            A.set(constraints_task_i.getAineq());
-            lA.set(constraints_task_i.getbLowerBound());
-            uA.set(constraints_task_i.getbUpperBound());
-            if(i > 0)
+            //the budget is set before committing, since a change of size initializes the back-end again
+            clock::time_point budget_start;
+            double level_budget = 0.;
+            if(deadline)
             {
-                for(unsigned int j = 0; j < i; ++j)
-                {
-                    if(_active_stacks[j])
-                        computeOptimalityConstraint(_tasks[j], _qp_stack_of_tasks[j], tmp_A[j], tmp_lA[j], tmp_uA[j]);
-                    else
-                    {
-                        //Here we consider fake optimality constraints:
-                        //
-                        //    -1 <= 0x <= 1
-                        tmp_A[j].setZero(_tasks[j]->getA().rows(), _tasks[j]->getA().cols());
-                        tmp_lA[j].setConstant(_tasks[j]->getA().rows(), -1.0);
-                        tmp_uA[j].setConstant(_tasks[j]->getA().rows(), 1.0);
-                    }
-                    A.pile(tmp_A[j]);
-                    lA.pile(tmp_lA[j]);
-                    uA.pile(tmp_uA[j]);
-                }
+                //the time left is shared among the active levels which still have to be solved
+                unsigned int levels_left = 0;
+                for(unsigned int j = i; j < _tasks.size(); ++j)
+                    levels_left += _active_stacks[j];
+
+                budget_start = clock::now();
+                double elapsed = std::chrono::duration<double>(budget_start - start).count();
+                level_budget = (_time_budget - elapsed)/levels_left;
+                if(level_budget <= 0.)
+                    return stopAtDeadline(i);
+                _time_bounded[i] = _qp_stack_of_tasks[i]->setTimeBudget(level_budget);
             }
 
-            if(!_qp_stack_of_tasks[i]->updateConstraints(A.generate_and_get(),
-                                    lA.generate_and_get(), uA.generate_and_get()))
+            if(!commitLevel(i))
+            {
+                if(deadline && outOfTime(i, std::chrono::duration<double>(clock::now() - budget_start).count(),
+                                         level_budget))
+                    return stopAtDeadline(i);
                 return false;
+            }
+
+            clock::time_point level_assembled;
+            if(_tick_telemetry || _recorder)
+                level_assembled = clock::now();
 
+            bool solved = _qp_stack_of_tasks[i]->solve();
 
-            if(constraints_task_i.hasBounds()) // bounds specified everywhere will work
+            clock::time_point level_solved;
+            if(_tick_telemetry || _recorder)
+                level_solved = clock::now();
+
+            if(_recorder)
             {
-                if(!_qp_stack_of_tasks[i]->updateBounds(constraints_task_i.getLowerBound(), constraints_task_i.getUpperBound()))
-                    return false;
+                QPRecorder::LevelInfo level_info;
+                level_info.level = i;
+                level_info.back_end = _be_solver[i];
+                level_info.hessian_type = (OpenSoT::HessianType)(_tasks[i]->getHessianAtype());
+                level_info.eps_regularisation = _epsRegularisation;
+                _recorder->record(recorder_tick, level_info, *_qp_stack_of_tasks[i], solved,
+                                  std::chrono::duration<double>(level_solved - level_assembled).count());
             }
 
-            if(!_qp_stack_of_tasks[i]->solve())
+            if(_tick_telemetry)
+            {
+                LevelTelemetry& level = _tick_telemetry->levels[i];
+                level.solved = solved;
+                //with the parallel assembly, assembleLevel() ran before the loop
+                level.assembly_time = (_assembly_pool ? _assembly_time[i] : 0.) +
+                        std::chrono::duration<double>(level_assembled - level_start).count();
+                level.solve_time = std::chrono::duration<double>(level_solved - level_assembled).count();
+                level.solve_info = _qp_stack_of_tasks[i]->getSolveInfo();
+                level.number_of_variables = _qp_stack_of_tasks[i]->getNumVariables();
+                level.number_of_constraints = _qp_stack_of_tasks[i]->getNumConstraints();
+            }
+
+            if(!solved)
+            {
+                if(deadline && outOfTime(i, std::chrono::duration<double>(clock::now() - budget_start).count(),
+                                         level_budget))
+                    return stopAtDeadline(i);
                 return false;
+            }
 
             solution = _qp_stack_of_tasks[i]->getSolution();
+            _last_solved_level = i;
         }
         else
         {
             //Here we do nothing
         }
+
+        updateOptimalityConstraint(i);
     }
     return true;
 }
 
+bool iHQP::commitLevel(const unsigned int i)
+{
+    LevelVersions& committed = _committed_versions[i];
+    const LevelVersions& assembled = _assembled_versions[i];
+    BackEnd::Ptr& problem_i = _qp_stack_of_tasks[i];
+
+    bool success = true;
+    if(!committed.valid || assembled.task_matrix != committed.task_matrix)
+        success = problem_i->commitTask();
+    else if(assembled.task != committed.task)
+        success = problem_i->commitGradient();
+
+    success = success && updateConstraints(i);
+
+    if(success && hasLevelBounds(i) && // bounds specified everywhere will work
+       (!committed.valid || assembled.constraints != committed.constraints || assembled.shared != committed.shared))
+        success = problem_i->updateBounds(getLevelLowerBound(i), getLevelUpperBound(i));
+
+    //if something went wrong everything is passed again at the next solve
+    committed = assembled;
+    committed.valid = success;
+    return success;
+}
+
+bool iHQP::outOfTime(const unsigned int i, const double level_time, const double level_budget)
+{
+    return _qp_stack_of_tasks[i]->getSolveInfo().time_limit_reached || level_time >= level_budget;
+}
+
+bool iHQP::stopAtDeadline(const unsigned int i)
+{
+    _deadline_missed = true;
+#ifdef OPENSOT_VERBOSE
+    XBot::Logger::warning("iHQP: time budget exceeded at level %i, returning the solution of level %i\n",
+                          i, _last_solved_level);
+#endif
+    //the solution is the one of the last solved level, nothing if none of the levels has been solved
+    return _last_solved_level >= 0;
+}
+
+void iHQP::updateOptimalityConstraint(const unsigned int i)
+{
+    //the optimality constraint of the last level is never used
+    if(i >= tmp_A.size())
+        return;
+
+    //the lower priority levels pass tmp_A[i] to their back-ends only if it changed
+    if(_active_stacks[i])
+    {
+        if(OpenSoT::updateCopy(_tasks[i]->getA(), tmp_A[i]))
+            _optimality_versions[i]++;
+        tmp_lA[i].noalias() = tmp_A[i]*_qp_stack_of_tasks[i]->getSolution();
+        tmp_uA[i] = tmp_lA[i];
+    }
+    else
+    {
+        //Here we consider fake optimality constraints:
+        //
+        //    -1 <= 0x <= 1
+        if(OpenSoT::updateCopy(Eigen::MatrixXd::Zero(_tasks[i]->getA().rows(), _tasks[i]->getA().cols()), tmp_A[i]))
+            _optimality_versions[i]++;
+        tmp_lA[i].setConstant(_tasks[i]->getA().rows(), -1.0);
+        tmp_uA[i].setConstant(_tasks[i]->getA().rows(), 1.0);
+    }
+}
+
 bool iHQP::setOptions(const unsigned int i, const boost::any &opt)
 {
     if(i > _qp_stack_of_tasks.size()){
@@ -333,3 +904,68 @@ bool iHQP::getBackEnd(const unsigned int i, BackEnd::Ptr& back_end)
     back_end = _qp_stack_of_tasks[i];
     return true;
 }
+
+void iHQP::setParallelAssembly(const unsigned int number_of_threads)
+{
+    if(number_of_threads > 1)
+        _assembly_pool.reset(new WorkerPool(number_of_threads));
+    else
+        _assembly_pool.reset();
+}
+
+unsigned int iHQP::getParallelAssembly()
+{
+    if(_assembly_pool)
+        return _assembly_pool->getNumberOfThreads();
+    return 1;
+}
+
+void iHQP::enableTelemetry(const unsigned int capacity)
+{
+    if(capacity == 0)
+    {
+        _telemetry.reset();
+        return;
+    }
+
+    Telemetry prototype;
+    prototype.tick = 0;
+    prototype.solve_time = 0.;
+    prototype.solved = false;
+    prototype.deadline_missed = false;
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        LevelTelemetry level;
+        level.active = _active_stacks[i];
+        level.solved = false;
+        level.assembly_time = 0.;
+        level.solve_time = 0.;
+        level.solve_info = _qp_stack_of_tasks[i]->getSolveInfo();
+        level.number_of_variables = _qp_stack_of_tasks[i]->getNumVariables();
+        level.number_of_constraints = _qp_stack_of_tasks[i]->getNumConstraints();
+        prototype.levels.push_back(level);
+    }
+
+    _assembly_time.assign(_tasks.size(), 0.);
+    _telemetry_ticks = 0;
+    _telemetry.reset(new TelemetryBuffer(capacity, prototype));
+}
+
+bool iHQP::setTimeBudget(const double time)
+{
+    _time_budget = time;
+
+    bool supported = true;
+    _time_bounded.assign(_qp_stack_of_tasks.size(), false);
+    for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
+    {
+        _time_bounded[i] = _qp_stack_of_tasks[i]->setTimeBudget(time);
+        if(!_time_bounded[i])
+        {
+            XBot::Logger::warning("iHQP: back-end %s at level %i does not support time limits\n",
+                                  getBackEndName(i).c_str(), i);
+            supported = false;
+        }
+    }
+    return supported;
+}
@@ -0,0 +1,332 @@
+#include <OpenSoT/solvers/nHQP.h>
+#include <XBotInterface/Logger.hpp>
+
+
+using namespace OpenSoT::solvers;
+
+nHQP::nHQP(Stack &stack_of_tasks, const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks),
+    _epsRegularisation(eps_regularisation),
+    _null_space_threshold(Eigen::NumTraits<double>::dummy_precision())
+{
+    for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
+        _active_stacks.push_back(true);
+        _be_solver.push_back(be_solver);
+    }
+
+    if(!prepareSoT())
+        throw std::runtime_error("Can Not initizalize SoT!");
+}
+
+nHQP::nHQP(Stack &stack_of_tasks,
+           ConstraintPtr bounds,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks, bounds),
+    _epsRegularisation(eps_regularisation),
+    _null_space_threshold(Eigen::NumTraits<double>::dummy_precision())
+{
+    for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
+        _active_stacks.push_back(true);
+        _be_solver.push_back(be_solver);
+    }
+
+    if(!prepareSoT())
+        throw std::runtime_error("Can Not initizalize SoT with bounds!");
+}
+
+nHQP::nHQP(Stack &stack_of_tasks,
+           ConstraintPtr bounds,
+           ConstraintPtr globalConstraints,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks, bounds, globalConstraints),
+    _epsRegularisation(eps_regularisation),
+    _null_space_threshold(Eigen::NumTraits<double>::dummy_precision())
+{
+    for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
+        _active_stacks.push_back(true);
+        _be_solver.push_back(be_solver);
+    }
+
+    if(!prepareSoT())
+        throw std::runtime_error("Can Not initizalize SoT with bounds!");
+}
+
+bool nHQP::prepareSoT()
+{
+    if(_tasks.empty())
+        return false;
+
+    unsigned int x_size = _tasks[0]->getXSize();
+
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        XBot::Logger::info("#USING BACK-END @LEVEL %i: %s\n", i, getBackEndName(i).c_str());
+
+        OpenSoT::constraints::Aggregated constraints_task_i(_tasks[i]->getConstraints(), x_size);
+        if(_globalConstraints)
+            constraints_task_i.getConstraintsList().push_back(_globalConstraints);
+        if(_bounds)
+            constraints_task_i.getConstraintsList().push_back(_bounds);
+        constraints_task_i.generateAll();
+
+        constraints_task.push_back(constraints_task_i);
+
+        _N.push_back(Eigen::MatrixXd());
+        _qp_stack_of_tasks.push_back(BackEnd::Ptr());
+    }
+
+    _N[0].setIdentity(x_size, x_size);
+    _x.setZero(x_size);
+
+    //The first solve creates and initializes the back-ends of all the levels
+    Eigen::VectorXd solution(x_size);
+    return solve(solution);
+}
+
+void nHQP::computeCostFunction(const TaskPtr& task, const Eigen::MatrixXd& N, const Eigen::VectorXd& x,
+                               Eigen::MatrixXd& H, Eigen::VectorXd& g)
+{
+    _AN.noalias() = task->getA()*N;
+    _residual.noalias() = task->getA()*x;
+    _residual -= task->getb();
+
+    H.resize(N.cols(), N.cols());
+    if(task->getWeight().isIdentity())
+    {
+        H.triangularView<Eigen::Upper>() = _AN.transpose()*_AN;
+        g.noalias() = _AN.transpose()*_residual;
+    }
+    else
+    {
+        if(task->getWeightIsDiagonalFlag())
+            _WAN.noalias() = task->getWeight().diagonal().asDiagonal()*_AN;
+        else
+            _WAN.noalias() = task->getWeight()*_AN;
+        H.triangularView<Eigen::Upper>() = _AN.transpose()*_WAN;
+        g.noalias() = _WAN.transpose()*_residual;
+    }
+    H = H.selfadjointView<Eigen::Upper>();
+    g.noalias() += N.transpose()*task->getc();
+}
+
+void nHQP::computeNullSpaceBasis(const Eigen::MatrixXd& AN, const Eigen::MatrixXd& N, Eigen::MatrixXd& N_next)
+{
+    if(AN.rows() == 0 || N.cols() == 0)
+    {
+        N_next = N;
+        return;
+    }
+
+    _qr.setThreshold(_null_space_threshold);
+    _qr.compute(AN.transpose());
+
+    // AN' P = Q R: the first rank columns of Q span the row space of AN, the others its null-space
+    int rank = _qr.rank();
+    if(rank == 0)
+        N_next = N;
+    else
+    {
+        Eigen::MatrixXd Q = _qr.householderQ();
+        N_next.noalias() = N*Q.rightCols(N.cols() - rank);
+    }
+}
+
+bool nHQP::solveLevel(const unsigned int i, Eigen::VectorXd& x)
+{
+    const Eigen::MatrixXd& N = _N[i];
+    const int r = N.cols();
+
+    //The null-space is empty: nothing can be done at this level
+    if(r == 0)
+    {
+        if(i+1 < _N.size())
+            _N[i+1] = N;
+        return true;
+    }
+
+    computeCostFunction(_tasks[i], N, x, H, g);
+
+    OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task[i];
+    constraints_task_i.generateAll();
+
+    A.reset(r);
+    lA.reset(1);
+    uA.reset(1);
+    if(constraints_task_i.getAineq().rows() > 0)
+    {
+        A.pile(constraints_task_i.getAineq()*N);
+        lA.pile(constraints_task_i.getbLowerBound() - constraints_task_i.getAineq()*x);
+        uA.pile(constraints_task_i.getbUpperBound() - constraints_task_i.getAineq()*x);
+    }
+
+    //Bounds are passed as bounds only if N is the identity, otherwise they became constraints
+    const bool native_bounds = (r == x.size());
+    l.resize(0);
+    u.resize(0);
+    if(constraints_task_i.hasBounds())
+    {
+        if(native_bounds)
+        {
+            l = constraints_task_i.getLowerBound() - x;
+            u = constraints_task_i.getUpperBound() - x;
+        }
+        else
+        {
+            A.pile(N);
+            lA.pile(constraints_task_i.getLowerBound() - x);
+            uA.pile(constraints_task_i.getUpperBound() - x);
+        }
+    }
+
+    BackEnd::Ptr& problem_i = _qp_stack_of_tasks[i];
+    if(!problem_i || problem_i->getNumVariables() != r)
+    {
+        OpenSoT::HessianType hessian_type = _tasks[i]->getHessianAtype();
+        if(!native_bounds && hessian_type != OpenSoT::HST_ZERO)
+            hessian_type = OpenSoT::HST_UNKNOWN;
+
+        problem_i = BackEndFactory(_be_solver[i], r, A.rows(), hessian_type, _epsRegularisation);
+        if(!problem_i->initProblem(H, g, A.generate_and_get(), lA.generate_and_get(), uA.generate_and_get(), l, u))
+        {
+            XBot::Logger::error("ERROR: INITIALIZING STACK %i \n", i);
+            problem_i.reset();
+            return false;
+        }
+
+        std::string bounds_string = "";
+        if(_bounds)
+            bounds_string = _bounds->getConstraintID();
+        problem_i->printProblemInformation(i, _tasks[i]->getTaskID(),
+                                           constraints_task_i.getConstraintID(), bounds_string);
+    }
+    else
+    {
+        if(!problem_i->updateTask(H, g))
+            return false;
+
+        if(!problem_i->updateConstraints(A.generate_and_get(), lA.generate_and_get(), uA.generate_and_get()))
+            return false;
+
+        if(l.size() > 0)
+        {
+            if(!problem_i->updateBounds(l, u))
+                return false;
+        }
+
+        if(!problem_i->solve())
+            return false;
+    }
+
+    x.noalias() += N*problem_i->getSolution();
+
+    if(i+1 < _N.size())
+        computeNullSpaceBasis(_AN, N, _N[i+1]);
+
+    return true;
+}
+
+bool nHQP::solve(Eigen::VectorXd &solution)
+{
+    _x.setZero(_x.size());
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        if(_active_stacks[i])
+        {
+            if(!solveLevel(i, _x))
+                return false;
+        }
+        else if(i+1 < _N.size())
+            _N[i+1] = _N[i];
+    }
+    solution = _x;
+    return true;
+}
+
+bool nHQP::setOptions(const unsigned int i, const boost::any &opt)
+{
+    if(i >= _qp_stack_of_tasks.size() || !_qp_stack_of_tasks[i]){
+        XBot::Logger::error("ERROR Index out of range! \n");
+        return false;}
+
+    _qp_stack_of_tasks[i]->setOptions(opt);
+    return true;
+}
+
+bool nHQP::getOptions(const unsigned int i, boost::any& opt)
+{
+    if(i >= _qp_stack_of_tasks.size() || !_qp_stack_of_tasks[i]){
+        XBot::Logger::error("ERROR Index out of range! \n");
+        return false;}
+
+    opt = _qp_stack_of_tasks[i]->getOptions();
+    return true;
+}
+
+bool nHQP::getObjective(const unsigned int i, double& val)
+{
+    if(i >= _qp_stack_of_tasks.size() || !_qp_stack_of_tasks[i]){
+        XBot::Logger::error("ERROR Index out of range! \n");
+        return false;}
+
+    val = _qp_stack_of_tasks[i]->getObjective();
+    return true;
+}
+
+void nHQP::setActiveStack(const unsigned int i, const bool flag)
+{
+    if(i < _active_stacks.size())
+        _active_stacks[i] = flag;
+}
+
+void nHQP::activateAllStacks()
+{
+    _active_stacks.assign(_active_stacks.size(), true);
+}
+
+void nHQP::setNullSpaceThreshold(const double threshold)
+{
+    if(threshold > 0.)
+        _null_space_threshold = threshold;
+}
+
+bool nHQP::getNullSpaceBasis(const unsigned int i, Eigen::MatrixXd& N)
+{
+    if(i >= _N.size())
+    {
+        XBot::Logger::error("Requested level %i null-space basis which does not exists!\n", i);
+        return false;
+    }
+    N = _N[i];
+    return true;
+}
+
+void nHQP::_log(XBot::MatLogger::Ptr logger, const std::string& prefix)
+{
+    for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
+    {
+        if(_qp_stack_of_tasks[i])
+            _qp_stack_of_tasks[i]->log(logger, i, prefix);
+        logger->add(prefix+"N_"+std::to_string(i), _N[i]);
+    }
+}
+
+std::string nHQP::getBackEndName(const unsigned int i)
+{
+    if(i >= _be_solver.size())
+    {
+        XBot::Logger::error("Requested level %i BackEnd which does not exists!\n", i);
+        return "";
+    }
+    return OpenSoT::solvers::whichBackEnd(_be_solver[i]);
+}
+
+bool nHQP::getBackEnd(const unsigned int i, BackEnd::Ptr& back_end)
+{
+    if(i >= _qp_stack_of_tasks.size() || !_qp_stack_of_tasks[i])
+    {
+        XBot::Logger::error("Requested level %i BackEnd which does not exists!\n", i);
+        return false;
+    }
+    back_end = _qp_stack_of_tasks[i];
+    return true;
+}
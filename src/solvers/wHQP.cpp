@@ -0,0 +1,158 @@
+#include <OpenSoT/solvers/wHQP.h>
+#include <XBotInterface/Logger.hpp>
+#include <algorithm>
+
+
+using namespace OpenSoT::solvers;
+
+wHQP::FlattenedLevel::FlattenedLevel(const std::vector<TaskPtr>& tasks, const std::vector<double>& weights):
+    Task("flattened", tasks[0]->getXSize()),
+    _flattened_tasks(tasks),
+    _weights(weights),
+    _A_piler(tasks[0]->getXSize()),
+    _b_piler(1)
+{
+    bool all_zero = true;
+    _hessianType = HST_SEMIDEF;
+    for(unsigned int i = 0; i < _flattened_tasks.size(); ++i)
+    {
+        _task_id = i == 0 ? _flattened_tasks[i]->getTaskID() : _task_id + "+" + _flattened_tasks[i]->getTaskID();
+
+        //as tasks::Aggregated::computeHessianType(), HST_UNKNOWN is propagated
+        const HessianType hessian_type = _flattened_tasks[i]->getHessianAtype();
+        if(hessian_type == HST_UNKNOWN)
+            _hessianType = HST_UNKNOWN;
+        else if(hessian_type == HST_POSDEF && _hessianType != HST_UNKNOWN)
+            _hessianType = HST_POSDEF;
+        all_zero = all_zero && hessian_type == HST_ZERO;
+
+        //the constraints of the tasks are constraints of the flattened level
+        std::list<ConstraintPtr>& constraints = _flattened_tasks[i]->getConstraints();
+        for(std::list<ConstraintPtr>::iterator c = constraints.begin(); c != constraints.end(); ++c)
+        {
+            if(std::find(_constraints.begin(), _constraints.end(), *c) == _constraints.end())
+                _constraints.push_back(*c);
+        }
+    }
+    if(all_zero)
+        _hessianType = HST_ZERO;
+
+    generate();
+}
+
+void wHQP::FlattenedLevel::generate()
+{
+    _A_piler.reset();
+    _b_piler.reset();
+    _c.setZero(_x_size);
+
+    bool diagonal_weight = true;
+    for(unsigned int i = 0; i < _flattened_tasks.size(); ++i)
+    {
+        _A_piler.pile(_flattened_tasks[i]->getA());
+        _b_piler.pile(_flattened_tasks[i]->getb());
+        _c += _weights[i]*_flattened_tasks[i]->getc();
+        diagonal_weight = diagonal_weight && (_flattened_tasks[i]->getWeightIsDiagonalFlag() ||
+                                              _flattened_tasks[i]->getWeight().isDiagonal(0.));
+    }
+    _A = _A_piler.generate_and_get();
+    _b = _b_piler.generate_and_get();
+
+    //the weight is allocated again only if the number of rows changed
+    if(_W.rows() != _A.rows())
+        _W.resize(_A.rows(), _A.rows());
+    _W.setZero();
+    int row = 0;
+    for(unsigned int i = 0; i < _flattened_tasks.size(); ++i)
+    {
+        const int rows = _flattened_tasks[i]->getA().rows();
+        _W.block(row, row, rows, rows) = _weights[i]*_flattened_tasks[i]->getWeight();
+        row += rows;
+    }
+    _weight_is_diagonal = diagonal_weight;
+}
+
+wHQP::wHQP(Stack& stack_of_tasks, const std::vector<double>& weights, const unsigned int strict_levels,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks),
+    _strict_levels(strict_levels)
+{
+    init(weights, eps_regularisation, be_solver);
+}
+
+wHQP::wHQP(Stack& stack_of_tasks,
+           ConstraintPtr bounds,
+           const std::vector<double>& weights, const unsigned int strict_levels,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks, bounds),
+    _strict_levels(strict_levels)
+{
+    init(weights, eps_regularisation, be_solver);
+}
+
+wHQP::wHQP(Stack& stack_of_tasks,
+           ConstraintPtr bounds,
+           ConstraintPtr globalConstraints,
+           const std::vector<double>& weights, const unsigned int strict_levels,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks, bounds, globalConstraints),
+    _strict_levels(strict_levels)
+{
+    init(weights, eps_regularisation, be_solver);
+}
+
+void wHQP::init(const std::vector<double>& weights, const double eps_regularisation,
+                const solver_back_ends be_solver)
+{
+    if(_tasks.empty() || _strict_levels > _tasks.size())
+        throw std::runtime_error("Can Not initizalize wHQP: the number of strict levels exceeds the stack!");
+    if(weights.size() != _tasks.size() - _strict_levels)
+        throw std::runtime_error("Can Not initizalize wHQP: one weight is needed for each flattened level!");
+    for(unsigned int i = 0; i < weights.size(); ++i)
+    {
+        if(!(weights[i] > 0.))
+            throw std::runtime_error("Can Not initizalize wHQP: weights have to be positive!");
+    }
+
+    _levels.assign(_tasks.begin(), _tasks.begin() + _strict_levels);
+    if(_strict_levels < _tasks.size())
+    {
+        _flattened_level.reset(new FlattenedLevel(
+                                   std::vector<TaskPtr>(_tasks.begin() + _strict_levels, _tasks.end()), weights));
+        _levels.push_back(_flattened_level);
+    }
+
+    XBot::Logger::info("wHQP: %u strict levels, %u levels flattened\n", _strict_levels,
+                       static_cast<unsigned int>(weights.size()));
+
+    _solver.reset(new iHQP(_levels, _bounds, _globalConstraints, eps_regularisation, be_solver));
+}
+
+bool wHQP::solve(Eigen::VectorXd& solution)
+{
+    if(_flattened_level)
+        _flattened_level->generate();
+    return _solver->solve(solution);
+}
+
+bool wHQP::setWeight(const unsigned int i, const double weight)
+{
+    if(i < _strict_levels || i >= _tasks.size() || !(weight > 0.))
+        return false;
+    _flattened_level->getWeights()[i - _strict_levels] = weight;
+    return true;
+}
+
+bool wHQP::getWeight(const unsigned int i, double& weight)
+{
+    if(i < _strict_levels || i >= _tasks.size())
+        return false;
+    weight = _flattened_level->getWeights()[i - _strict_levels];
+    return true;
+}
+
+void wHQP::_log(XBot::MatLogger::Ptr logger, const std::string& prefix)
+{
+    _solver->setSolverID(_solver_id);
+    _solver->log(logger);
+}
@@ -93,23 +93,55 @@ void Aggregated::checkSizes() {
 
 
 void Aggregated::generateAll() {
-    _tmpA.reset(_x_size);
-    _tmpb.reset(1);
-    _c.setZero(_x_size);
+    /* the pilers keep the rows of the last call: W_i*A_i are piled again only if the matrices
+       of some task changed, W_i*b_i and c only if some task changed */
+    bool matrix_changed = _tasks_versions.size() != _tasks.size();
+    bool changed = matrix_changed;
+    if(matrix_changed)
+    {
+        _tasks_versions.assign(_tasks.size(), 0);
+        _tasks_matrix_versions.assign(_tasks.size(), 0);
+    }
 
+    unsigned int k = 0;
     for(std::list< TaskPtr >::iterator i = _tasks.begin();
-        i != _tasks.end(); ++i) {
+        i != _tasks.end(); ++i, ++k) {
+        TaskPtr t = *i;
+        const unsigned long matrix_version = t->getMatrixVersion();
+        const unsigned long version = t->getVersion();
+        if(matrix_version != _tasks_matrix_versions[k])
+            matrix_changed = true;
+        if(version != _tasks_versions[k])
+            changed = true;
+        _tasks_matrix_versions[k] = matrix_version;
+        _tasks_versions[k] = version;
+    }
+
+    if(matrix_changed)
+        _tmpA.reset(_x_size);
+    if(changed)
+    {
+        _tmpb.reset(1);
+        _c.setZero(_x_size);
+    }
+
+    for(std::list< TaskPtr >::iterator i = _tasks.begin();
+        i != _tasks.end() && changed; ++i) {
         TaskPtr t = *i;
 //        _tmpA.pile(t->getWeight()*t->getA()); //This is potentially not RT safe
 //        _tmpb.pile(t->getWeight()*t->getb());
-        _tmpA.pile(t->getWA());
+        if(matrix_changed)
+            _tmpA.pile(t->getWA());
         _tmpb.pile(t->getWb());
         _c += t->getc();
     }
 
+    /* _A is copied anyway since it is masked in place by update() */
     _A = _tmpA.generate_and_get();
     _b = _tmpb.generate_and_get();
 
+    computeJacobianStructure();
+
     generateConstraints();
 }
 
@@ -204,6 +236,36 @@ OpenSoT::HessianType OpenSoT::tasks::Aggregated::computeHessianType()
     return HST_SEMIDEF;
 }
 
+void OpenSoT::tasks::Aggregated::computeJacobianStructure()
+{
+    bool selection = true;
+    bool block_sparse = true;
+    unsigned int block_start = _x_size, block_end = 0;
+    for(std::list< TaskPtr >::iterator i = _tasks.begin();
+        i != _tasks.end(); ++i) {
+        TaskPtr t = *i;
+        JacobianStructure structure = t->getJacobianStructure();
+
+        bool diagonal_weight = t->getWeightIsDiagonalFlag() || t->getWeight().isDiagonal(0.);
+        selection = selection && diagonal_weight &&
+                (structure == JS_IDENTITY || structure == JS_DIAGONAL_SELECTION);
+
+        block_sparse = block_sparse && structure == JS_BLOCK_SPARSE;
+        if(block_sparse)
+        {
+            block_start = std::min(block_start, t->getJacobianBlockStart());
+            block_end = std::max(block_end, t->getJacobianBlockStart() + t->getJacobianBlockSize());
+        }
+    }
+
+    if(selection)
+        setJacobianStructure(JS_DIAGONAL_SELECTION);
+    else if(block_sparse)
+        setJacobianBlock(block_start, block_end - block_start);
+    else
+        setJacobianStructure(JS_GENERAL);
+}
+
 const std::string Aggregated::concatenateTaskIds(const std::list<TaskPtr> tasks) {
     std::string concatenatedId;
     int taskSize = tasks.size();
@@ -48,12 +48,12 @@ GenericTask::~GenericTask()
 
 void GenericTask::_update(const Eigen::VectorXd &x)
 {
-    _task = __A*_var - __b;
+    //A*(Mx + q) - b, written directly in _A, _b and _c to do not allocate temporaries
+    _A.noalias() = __A*_var.getM();
+    _b = __b;
+    _b.noalias() -= __A*_var.getq();
 
-    _A = _task.getM();
-    _b = -_task.getq();
-
-    _c = _var.getM().transpose()*__c;
+    _c.noalias() = _var.getM().transpose()*__c;
 }
 
 bool GenericTask::setc(const Eigen::VectorXd& c)
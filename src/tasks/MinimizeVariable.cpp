@@ -14,6 +14,9 @@ OpenSoT::tasks::MinimizeVariable::MinimizeVariable(std::string task_id,
     _A = _var.getM();
     _b = -_var.getq();
     _W.setIdentity(_A.rows(), _A.rows());
+
+    //variables are usually a selection of the (constant) input
+    detectJacobianStructure();
 }
 
 bool OpenSoT::tasks::MinimizeVariable::setReference(const Eigen::VectorXd& ref)
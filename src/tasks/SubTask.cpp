@@ -13,6 +13,7 @@ OpenSoT::SubTask::SubTask(OpenSoT::SubTask::TaskPtr taskPtr, const std::list<uns
     this->generateA();
     this->generateb();
     this->generateHessianAtype();
+    this->generateJacobianStructure();
     this->generateWeight();
 }
 
@@ -38,6 +39,18 @@ void OpenSoT::SubTask::generateHessianAtype()
     else this->_hessianType = fatherHessianType;
 }
 
+void OpenSoT::SubTask::generateJacobianStructure()
+{
+    OpenSoT::JacobianStructure fatherJacobianStructure = _taskPtr->getJacobianStructure();
+
+    if(fatherJacobianStructure == JS_IDENTITY || fatherJacobianStructure == JS_DIAGONAL_SELECTION)
+        this->setJacobianStructure(JS_DIAGONAL_SELECTION);
+    else if(fatherJacobianStructure == JS_BLOCK_SPARSE)
+        this->setJacobianBlock(_taskPtr->getJacobianBlockStart(), _taskPtr->getJacobianBlockSize());
+    else
+        this->setJacobianStructure(JS_GENERAL);
+}
+
 void OpenSoT::SubTask::generateb()
 {
     unsigned int chunk_size = 0;
@@ -106,6 +119,7 @@ void OpenSoT::SubTask::_update(const Eigen::VectorXd &x)
     this->generateA();
     this->generateb();
     this->generateHessianAtype();
+    this->generateJacobianStructure();
     this->generateWeight();
 }
 
@@ -17,6 +17,7 @@ MinimizeAcceleration::MinimizeAcceleration(const Eigen::VectorXd &x):
     _A.setIdentity(_x_size, _x_size);
 
     _hessianType = HST_IDENTITY;
+    _jacobian_structure = JS_IDENTITY;
 
     this->_update(x);
 }
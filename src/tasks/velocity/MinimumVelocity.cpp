@@ -34,6 +34,7 @@ MinimumVelocity::MinimumVelocity(const int& x_size) :
     _b.setZero(_x_size);
 
     _hessianType = HST_IDENTITY;
+    _jacobian_structure = JS_IDENTITY;
 }
 
 MinimumVelocity::~MinimumVelocity()
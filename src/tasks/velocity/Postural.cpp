@@ -33,6 +33,7 @@ Postural::Postural(   const Eigen::VectorXd& x) :
     _A.setIdentity(_x_size, _x_size);
 
     _hessianType = HST_IDENTITY;
+    _jacobian_structure = JS_IDENTITY;
 
     /* first update. Setting desired pose equal to the actual pose */
     this->setReference(x);
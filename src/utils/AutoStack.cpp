@@ -327,7 +327,8 @@ void OpenSoT::AutoStack::setBoundsAggregationPolicy(const unsigned int aggregati
     _boundsAggregated.reset(
         new OpenSoT::constraints::Aggregated(
             bounds,
-            bounds.front()->getXSize()));
+            bounds.front()->getXSize(),
+            aggregationPolicy));
 }
 
 OpenSoT::constraints::Aggregated::ConstraintPtr OpenSoT::AutoStack::getBounds()
@@ -0,0 +1,83 @@
+#include <OpenSoT/utils/WorkerPool.h>
+
+using namespace OpenSoT::utils;
+
+WorkerPool::WorkerPool(const unsigned int number_of_threads):
+    _job(nullptr),
+    _number_of_jobs(0),
+    _next_job(0),
+    _busy_workers(0),
+    _generation(0),
+    _stop(false)
+{
+    for(unsigned int i = 1; i < number_of_threads; ++i)
+        _workers.push_back(std::thread(&WorkerPool::work, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _start.notify_all();
+
+    for(unsigned int i = 0; i < _workers.size(); ++i)
+        _workers[i].join();
+}
+
+void WorkerPool::run(const unsigned int number_of_jobs, const Job& job)
+{
+    if(_workers.empty())
+    {
+        for(unsigned int i = 0; i < number_of_jobs; ++i)
+            job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _number_of_jobs = number_of_jobs;
+        _next_job = 0;
+        _busy_workers = _workers.size();
+        ++_generation;
+    }
+    _start.notify_all();
+
+    process();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]{return _busy_workers == 0;});
+    _job = nullptr;
+}
+
+void WorkerPool::process()
+{
+    unsigned int i;
+    while((i = _next_job++) < _number_of_jobs)
+        (*_job)(i);
+}
+
+void WorkerPool::work()
+{
+    unsigned long generation = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [this, generation]{return _stop || _generation != generation;});
+            if(_stop)
+                return;
+            generation = _generation;
+        }
+
+        process();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(--_busy_workers == 0)
+                _done.notify_one();
+        }
+    }
+}
@@ -81,21 +81,29 @@ void cartesian_utils::computeCartesianError(const Eigen::MatrixXd &T,
                                   const Eigen::MatrixXd &Td,
                                   Eigen::VectorXd& position_error,
                                   Eigen::VectorXd& orientation_error)
+{
+    Eigen::Matrix4d tmp = T;
+    Eigen::Matrix4d tmpd = Td;
+    computeCartesianError(tmp, tmpd, position_error, orientation_error);
+}
+
+void cartesian_utils::computeCartesianError(const Eigen::Matrix4d &T,
+                                  const Eigen::Matrix4d &Td,
+                                  Eigen::VectorXd& position_error,
+                                  Eigen::VectorXd& orientation_error)
 {
     position_error.setZero(3);
     orientation_error.setZero(3);
 
     KDL::Frame x; // ee pose
     x.Identity();
-    Eigen::Matrix4d tmp = T;
-    tf::transformEigenToKDL(Eigen::Affine3d(tmp),x);
+    tf::transformEigenToKDL(Eigen::Affine3d(T),x);
     quaternion q;
     x.M.GetQuaternion(q.x, q.y, q.z, q.w);
 
     KDL::Frame xd; // ee desired pose
     xd.Identity();
-    tmp = Td;
-    tf::transformEigenToKDL(Eigen::Affine3d(tmp),xd);
+    tf::transformEigenToKDL(Eigen::Affine3d(Td),xd);
     quaternion qd;
     xd.M.GetQuaternion(qd.x, qd.y, qd.z, qd.w);
 
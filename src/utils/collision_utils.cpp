@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <OpenSoT/utils/collision_utils.h>
 #include <kdl_parser/kdl_parser.hpp>
@@ -11,6 +12,8 @@
 #include <boost/make_shared.hpp>
 #include <fcl/config.h>
 
+#define CAPSULE_PAIRS_EPS 1e-12
+
 // construct vector
 KDL::Vector toKdl(urdf::Vector3 v)
 {
@@ -29,6 +32,60 @@ KDL::Frame toKdl(urdf::Pose p)
   return KDL::Frame(toKdl(p.rotation), toKdl(p.position));
 }
 
+void ComputeLinksDistance::CapsulePairs::resize(const unsigned int pairs)
+{
+    ep1A.setZero(pairs, 3);
+    axisA.setZero(pairs, 3);
+    ep1B.setZero(pairs, 3);
+    axisB.setZero(pairs, 3);
+    radiusA.setZero(pairs);
+    radiusB.setZero(pairs);
+    closestPointA.setZero(pairs, 3);
+    closestPointB.setZero(pairs, 3);
+    distance.setZero(pairs);
+}
+
+void ComputeLinksDistance::CapsulePairs::computeDistances()
+{
+    for(unsigned int k = 0; k < size(); ++k)
+    {
+        // closest points of the segments A(sA) = ep1A + sA axisA, B(sB) = ep1B + sB axisB, sA, sB in [0, 1]
+        // (Ericson, Real-Time Collision Detection, 5.1.9), zero length segments are spheres
+        const Eigen::Vector3d u = axisA.row(k);
+        const Eigen::Vector3d v = axisB.row(k);
+        Eigen::Vector3d w = ep1A.row(k) - ep1B.row(k);
+
+        const double uu = std::max(u.squaredNorm(), CAPSULE_PAIRS_EPS);
+        const double vv = std::max(v.squaredNorm(), CAPSULE_PAIRS_EPS);
+        const double uv = u.dot(v);
+        const double uw = u.dot(w);
+        const double vw = v.dot(w);
+
+        // closest point of the line A to the line B, sA = 0 if the segments are parallel
+        const double den = uu*vv - uv*uv;
+        double sA = 0.;
+        if(den > CAPSULE_PAIRS_EPS*uu*vv)
+            sA = std::min(std::max((uv*vw - uw*vv)/den, 0.), 1.);
+
+        // closest point of the segment B to A(sA), if it is clamped sA is computed again
+        double sB = (uv*sA + vw)/vv;
+        if(sB < 0. || sB > 1.)
+        {
+            sB = std::min(std::max(sB, 0.), 1.);
+            sA = std::min(std::max((uv*sB - uw)/uu, 0.), 1.);
+        }
+
+        // the closest points on the surfaces are moved by the radii along the segments closest points difference
+        w += sA*u - sB*v;
+        const double segments_distance = w.norm();
+        w /= std::max(segments_distance, CAPSULE_PAIRS_EPS);
+
+        closestPointA.row(k) = ep1A.row(k) + sA*axisA.row(k) - radiusA[k]*w.transpose();
+        closestPointB.row(k) = ep1B.row(k) + sB*axisB.row(k) + radiusB[k]*w.transpose();
+        distance[k] = segments_distance - radiusA[k] - radiusB[k];
+    }
+}
+
 bool ComputeLinksDistance::globalToLinkCoordinates(const std::string& linkName,
                                                    const fcl::Transform3f &fcl_w_T_f,
                                                    KDL::Frame &link_T_f)
@@ -194,7 +251,7 @@ bool ComputeLinksDistance::updateCollisionObjects()
         it != linksToUpdate.end(); ++it)
     {
 //        std::string link_name = it->first;
-        std::string link_name = *it;
+        const std::string& link_name = *it;
         KDL::Frame w_T_link, w_T_shape;
         model.getPose(link_name, w_T_link);
         w_T_shape = w_T_link * link_T_shape[link_name];
@@ -292,7 +349,25 @@ void ComputeLinksDistance::generatePairsToCheck()
             }
         }
     }
-    std::cout << "Checking " << pairsToCheck.size() << " pairs for collision" << std::endl;
+
+    unsigned int capsule_pairs = 0;
+    for(std::list< ComputeLinksDistance::LinksPair >::iterator it = pairsToCheck.begin();
+        it != pairsToCheck.end(); ++it)
+    {
+        if(it->capsuleA && it->capsuleB)
+            ++capsule_pairs;
+    }
+    capsulePairs.resize(capsule_pairs);
+
+    linkPairDistances.clear();
+    linkPairDistances.reserve(pairsToCheck.size());
+    for(std::list< ComputeLinksDistance::LinksPair >::iterator it = pairsToCheck.begin();
+        it != pairsToCheck.end(); ++it)
+        linkPairDistances.push_back(LinkPairDistance(it->linkA, it->linkB, KDL::Frame(), KDL::Frame(),
+                                                     std::numeric_limits<double>::infinity()));
+
+    std::cout << "Checking " << pairsToCheck.size() << " pairs for collision, "
+              << capsule_pairs << " capsule pairs" << std::endl;
 }
 
 ComputeLinksDistance::ComputeLinksDistance(XBot::ModelInterface &model) : model(model)
@@ -338,24 +413,105 @@ ComputeLinksDistance::ComputeLinksDistance(XBot::ModelInterface &model) : model(
     this->setCollisionBlackList(std::list<LinkPairDistance::LinksPair>());
 }
 
+double ComputeLinksDistance::boundingSpheresDistance(const fcl::CollisionObject& collObj_shapeA,
+                                                     const fcl::CollisionObject& collObj_shapeB)
+{
+    const fcl::CollisionGeometry* shapeA = collObj_shapeA.collisionGeometry().get();
+    const fcl::CollisionGeometry* shapeB = collObj_shapeB.collisionGeometry().get();
+
+    fcl::Vec3f w_centerA = collObj_shapeA.getTransform().transform(shapeA->aabb_center);
+    fcl::Vec3f w_centerB = collObj_shapeB.getTransform().transform(shapeB->aabb_center);
+
+    return (w_centerA - w_centerB).length() - shapeA->aabb_radius - shapeB->aabb_radius;
+}
+
 std::list<LinkPairDistance> ComputeLinksDistance::getLinkDistances(double detectionThreshold)
 {
     std::list<LinkPairDistance> results;
 
+    const std::vector<LinkPairDistance>& distances = computeLinkDistances(detectionThreshold);
+    for(unsigned int k = 0; k < distances.size(); ++k)
+    {
+        if(distances[k].getDistance() < detectionThreshold)
+            results.push_back(distances[k]);
+    }
+
+    results.sort();
+
+    return results;
+}
+
+const std::vector<LinkPairDistance>& ComputeLinksDistance::computeLinkDistances(double detectionThreshold)
+{
     updateCollisionObjects();
 
     typedef std::list< ComputeLinksDistance::LinksPair >::iterator iter_pair;
 
+    // capsule pairs: the end-point number 1 is the origin of the shape frame, the axis is its z-axis
+    unsigned int capsule_pair = 0;
     for(iter_pair it = pairsToCheck.begin();
         it != pairsToCheck.end();
         ++it)
     {
-        std::string linkA = it->linkA;
-        std::string linkB = it->linkB;
+        if(!(it->capsuleA && it->capsuleB))
+            continue;
+
+        const fcl::Transform3f& w_T_shapeA = it->collisionObjectA->getTransform();
+        const fcl::Transform3f& w_T_shapeB = it->collisionObjectB->getTransform();
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            capsulePairs.ep1A(capsule_pair, i) = w_T_shapeA.getTranslation()[i];
+            capsulePairs.axisA(capsule_pair, i) = it->capsuleA->getLength()*w_T_shapeA.getRotation()(i, 2);
+            capsulePairs.ep1B(capsule_pair, i) = w_T_shapeB.getTranslation()[i];
+            capsulePairs.axisB(capsule_pair, i) = it->capsuleB->getLength()*w_T_shapeB.getRotation()(i, 2);
+        }
+        capsulePairs.radiusA[capsule_pair] = it->capsuleA->getRadius();
+        capsulePairs.radiusB[capsule_pair] = it->capsuleB->getRadius();
+        ++capsule_pair;
+    }
+    capsulePairs.computeDistances();
+
+    capsule_pair = 0;
+    unsigned int pair = 0;
+    for(iter_pair it = pairsToCheck.begin();
+        it != pairsToCheck.end();
+        ++it, ++pair)
+    {
+        const std::string& linkA = it->linkA;
+        const std::string& linkB = it->linkB;
+        LinkPairDistance& linkPairDistance = linkPairDistances[pair];
+        linkPairDistance.distance = std::numeric_limits<double>::infinity();
+
+        if(it->capsuleA && it->capsuleB)
+        {
+            if(capsulePairs.distance[capsule_pair] < detectionThreshold)
+            {
+                fcl::Vec3f w_pA(capsulePairs.closestPointA(capsule_pair, 0),
+                                capsulePairs.closestPointA(capsule_pair, 1),
+                                capsulePairs.closestPointA(capsule_pair, 2));
+                fcl::Vec3f w_pB(capsulePairs.closestPointB(capsule_pair, 0),
+                                capsulePairs.closestPointB(capsule_pair, 1),
+                                capsulePairs.closestPointB(capsule_pair, 2));
+
+                KDL::Frame linkA_pA, linkB_pB;
+                globalToLinkCoordinates(linkA, fcl::Transform3f(w_pA), linkA_pA);
+                globalToLinkCoordinates(linkB, fcl::Transform3f(w_pB), linkB_pB);
+
+                linkPairDistance.setClosestPoints(linkA, linkA_pA, linkB_pB,
+                                                  capsulePairs.distance[capsule_pair]);
+            }
+            ++capsule_pair;
+            continue;
+        }
 
         fcl::CollisionObject* collObj_shapeA = it->collisionObjectA.get();
         fcl::CollisionObject* collObj_shapeB = it->collisionObjectB.get();
 
+        // broad phase: the bounding spheres distance is a lower bound of min_distance
+        if(detectionThreshold < std::numeric_limits<double>::infinity() &&
+           boundingSpheresDistance(*collObj_shapeA, *collObj_shapeB) >= detectionThreshold)
+            continue;
+
         fcl::DistanceRequest request;
 #if FCL_MINOR_VERSION > 2
         request.gjk_solver_type = fcl::GST_INDEP;
@@ -369,28 +525,17 @@ std::list<LinkPairDistance> ComputeLinksDistance::getLinkDistances(double detect
         fcl::distance(collObj_shapeA, collObj_shapeB, request, result);
 
         // p1Homo, p2Homo newly computed points by FCL
-        // absolutely computed w.r.t. base-frame
+        // computed w.r.t. the shape frames (the capsule pairs are not computed by FCL)
         KDL::Frame linkA_pA, linkB_pB;
 
-        if(collObj_shapeA->getNodeType() == fcl::GEOM_CAPSULE &&
-           collObj_shapeB->getNodeType() == fcl::GEOM_CAPSULE)
-        {
-            globalToLinkCoordinates(linkA, result.nearest_points[0], linkA_pA);
-            globalToLinkCoordinates(linkB, result.nearest_points[1], linkB_pB);
-        } else {
-            shapeToLinkCoordinates(linkA, result.nearest_points[0], linkA_pA);
-            shapeToLinkCoordinates(linkB, result.nearest_points[1], linkB_pB);
-        }
+        shapeToLinkCoordinates(linkA, result.nearest_points[0], linkA_pA);
+        shapeToLinkCoordinates(linkB, result.nearest_points[1], linkB_pB);
 
         if(result.min_distance < detectionThreshold)
-            results.push_back(LinkPairDistance(linkA, linkB,
-                                               linkA_pA, linkB_pB,
-                                               result.min_distance));
+            linkPairDistance.setClosestPoints(linkA, linkA_pA, linkB_pB, result.min_distance);
     }
 
-    results.sort();
-
-    return results;
+    return linkPairDistances;
 }
 
 bool ComputeLinksDistance::setCollisionWhiteList(std::list<LinkPairDistance::LinksPair> whiteList)
@@ -484,6 +629,24 @@ LinkPairDistance::LinkPairDistance(const std::string &link1, const std::string &
 
 }
 
+void LinkPairDistance::setClosestPoints(const std::string &link1,
+                                        const KDL::Frame &link1_T_closestPoint1,
+                                        const KDL::Frame &link2_T_closestPoint2,
+                                        const double &distance)
+{
+    if(link1 == linksPair.first)
+    {
+        link_T_closestPoint.first = link1_T_closestPoint1;
+        link_T_closestPoint.second = link2_T_closestPoint2;
+    }
+    else
+    {
+        link_T_closestPoint.first = link2_T_closestPoint2;
+        link_T_closestPoint.second = link1_T_closestPoint1;
+    }
+    this->distance = distance;
+}
+
 const double &LinkPairDistance::getDistance() const
 {
     return distance;
@@ -5,6 +5,7 @@
 #include <OpenSoT/constraints/velocity/JointLimits.h>
 #include <OpenSoT/constraints/velocity/ConvexHull.h>
 #include <string>
+#include <limits>
 #include <XBotInterface/ModelInterface.h>
 
 
@@ -174,8 +175,90 @@ TEST_F(testAggregated, UnilateralToBilateralWorks) {
 
 }
 
-/// TODO implement
+/**
+ * @brief The rawConstraint class sets directly the matrices of the constraint
+ */
+class rawConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    rawConstraint(const std::string& id,
+                  const Eigen::MatrixXd& Aeq, const Eigen::VectorXd& beq,
+                  const Eigen::MatrixXd& Aineq,
+                  const Eigen::VectorXd& bUpperBound, const Eigen::VectorXd& bLowerBound):
+        Constraint(id, Aineq.cols())
+    {
+        _Aeq = Aeq; _beq = beq;
+        _Aineq = Aineq; _bUpperBound = bUpperBound; _bLowerBound = bLowerBound;
+    }
+};
+
 TEST_F(testAggregated, EqualityToInequalityWorks) {
+    using namespace OpenSoT::constraints;
+    const unsigned int nJ = 6;
+    Eigen::MatrixXd Aeq(2, nJ), Aineq(3, nJ), Aempty(0, nJ);
+    Aeq.setRandom(2, nJ);
+    Aineq.setRandom(3, nJ);
+    Eigen::VectorXd beq(2), u(3), l(3), empty(0);
+    beq.setRandom(2);
+    u.setConstant(3, 1.);
+    l.setConstant(3, -2.);
+
+    std::list<Aggregated::ConstraintPtr> constraints;
+    constraints.push_back(Aggregated::ConstraintPtr(new rawConstraint("bilateral", Aempty, empty, Aineq, u, l)));
+    constraints.push_back(Aggregated::ConstraintPtr(new rawConstraint("equality", Aeq, beq, Aempty, empty, empty)));
+    constraints.push_back(Aggregated::ConstraintPtr(new rawConstraint("upper", Aempty, empty, Aineq, u, empty)));
+    constraints.push_back(Aggregated::ConstraintPtr(new rawConstraint("lower", Aempty, empty, Aineq, empty, l)));
+    constraints.push_back(Aggregated::ConstraintPtr(new velocity::VelocityLimits(1., 1., nJ)));
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double max = std::numeric_limits<double>::max();
+
+    /* default policy: equalities become beq <= Aeq*x <= beq, unilateral constraints become bilateral */
+    Aggregated bilateral(constraints, nJ);
+    EXPECT_EQ(bilateral.getAggregationPolicy(), Aggregated::NATIVE_BILATERAL);
+    Eigen::MatrixXd A(11, nJ);
+    A << Aineq, Aeq, Aineq, Aineq;
+    Eigen::VectorXd uA(11), lA(11);
+    uA << u, beq, u, Eigen::VectorXd::Constant(3, inf);
+    lA << l, beq, Eigen::VectorXd::Constant(3, -max), l;
+    EXPECT_TRUE(bilateral.getAineq() == A);
+    EXPECT_TRUE(bilateral.getbUpperBound() == uA);
+    EXPECT_TRUE(bilateral.getbLowerBound() == lA);
+    EXPECT_EQ(bilateral.getAeq().rows(), 0);
+    EXPECT_EQ(bilateral.getUpperBound().size(), nJ);
+
+    /* only unilateral constraints: bilateral constraints and equalities are doubled */
+    Aggregated unilateral(constraints, nJ, Aggregated::EQUALITIES_TO_INEQUALITIES);
+    A.resize(16, nJ);
+    A << Aineq, -Aineq, Aeq, -Aeq, Aineq, -Aineq;
+    uA.resize(16);
+    uA << u, -l, beq, -beq, u, -l;
+    EXPECT_TRUE(unilateral.getAineq() == A);
+    EXPECT_TRUE(unilateral.getbUpperBound() == uA);
+    EXPECT_EQ(unilateral.getbLowerBound().size(), 0);
+    EXPECT_EQ(unilateral.getAeq().rows(), 0);
+
+    /* an aggregated constraint keeps its rows when aggregated again */
+    std::list<Aggregated::ConstraintPtr> aggregated_constraints;
+    aggregated_constraints.push_back(Aggregated::ConstraintPtr(
+                                         new Aggregated(constraints, nJ, Aggregated::NATIVE_BILATERAL)));
+    Aggregated native(aggregated_constraints, nJ);
+    EXPECT_TRUE(native.getAineq() == bilateral.getAineq());
+    EXPECT_TRUE(native.getbUpperBound() == bilateral.getbUpperBound());
+    EXPECT_TRUE(native.getbLowerBound() == bilateral.getbLowerBound());
+
+    /* equalities are kept */
+    Aggregated equalities(constraints, nJ, Aggregated::UNILATERAL_TO_BILATERAL);
+    EXPECT_TRUE(equalities.getAeq() == Aeq);
+    EXPECT_TRUE(equalities.getbeq() == beq);
+    EXPECT_EQ(equalities.getAineq().rows(), 9);
+
+    /* the aggregated matrices are written in place */
+    const double* data = bilateral.getAineq().data();
+    for(unsigned int i = 0; i < 10; ++i)
+        bilateral.update(Eigen::VectorXd::Zero(nJ));
+    EXPECT_EQ(bilateral.getAineq().data(), data);
+    EXPECT_EQ(bilateral.getbUpperBound().size(), 11);
 }
 
 TEST_F(testAggregated, MultipleAggregationdWork) {
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/BatchSolver.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <utils/RandomStack.h>
+
+namespace {
+
+/**
+ * @brief createProblem builds the same RandomStack for each problem of the batch:
+ * the state x enters in the reference of the first task (A x_ref = b - x.head())
+ */
+OpenSoT::solvers::BatchSolver::Problem::Ptr createProblem(const unsigned int x_size)
+{
+    RandomStack random(x_size);
+
+    OpenSoT::solvers::BatchSolver::Problem::Ptr problem(new OpenSoT::solvers::BatchSolver::Problem());
+    problem->solver.reset(new OpenSoT::solvers::iHQP(random._stack, random._bounds, 1.));
+
+    OpenSoT::tasks::GenericTask::Ptr first_task = random._tasks[0];
+    Eigen::VectorXd b0 = first_task->getb();
+    problem->update = [first_task, b0](const Eigen::VectorXd& x){
+        first_task->setb(b0 - x.head(b0.size()));
+        first_task->update(x);};
+    return problem;
+}
+
+TEST(testBatchSolver, testSameSolutionOfiHQP)
+{
+    const unsigned int x_size = 20;
+    const unsigned int number_of_problems = 16;
+
+    OpenSoT::solvers::BatchSolver batch(number_of_problems,
+        [&](const unsigned int i){ return createProblem(x_size); },
+        4);
+    EXPECT_EQ(batch.getNumberOfProblems(), number_of_problems);
+    EXPECT_EQ(batch.getNumberOfThreads(), 4);
+
+    //reference: the same problems solved one after the other
+    std::vector<OpenSoT::solvers::BatchSolver::Problem::Ptr> serial;
+    for(unsigned int i = 0; i < number_of_problems; ++i)
+        serial.push_back(createProblem(x_size));
+
+    Eigen::MatrixXd states(x_size, number_of_problems), solutions;
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        states.setRandom(x_size, number_of_problems);
+        EXPECT_TRUE(batch.solve(states, solutions));
+        EXPECT_EQ(solutions.rows(), x_size);
+        EXPECT_EQ(solutions.cols(), number_of_problems);
+
+        for(unsigned int i = 0; i < number_of_problems; ++i)
+        {
+            EXPECT_TRUE(batch.isSolved(i));
+
+            Eigen::VectorXd x(x_size);
+            serial[i]->update(states.col(i));
+            EXPECT_TRUE(serial[i]->solver->solve(x));
+            for(unsigned int j = 0; j < x_size; ++j)
+                EXPECT_NEAR(solutions(j,i), x[j], 1e-9);
+        }
+    }
+
+    //wrong number of states
+    EXPECT_FALSE(batch.solve(Eigen::MatrixXd::Zero(x_size, number_of_problems-1), solutions));
+    EXPECT_FALSE(batch.getProblem(number_of_problems));
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
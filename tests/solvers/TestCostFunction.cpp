@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/tasks/MinimizeVariable.h>
+#include <OpenSoT/SubTask.h>
+
+namespace {
+
+/**
+ * @brief The CostFunction class exposes iHQP::computeCostFunction()
+ */
+class CostFunction: public OpenSoT::solvers::iHQP
+{
+public:
+    CostFunction(OpenSoT::solvers::iHQP::Stack& stack):
+        OpenSoT::solvers::iHQP(stack, 1.)
+    {}
+
+    void compute(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::VectorXd& g)
+    {
+        H.setConstant(task->getXSize(), task->getXSize(), 1e3);
+        g.setConstant(task->getXSize(), 1e3);
+        computeCostFunction(task, H, g);
+    }
+
+    void computeGradient(const TaskPtr& task, Eigen::VectorXd& g)
+    {
+        g.setConstant(task->getXSize(), 1e3);
+        OpenSoT::solvers::iHQP::computeGradient(task, g);
+    }
+};
+
+/**
+ * @brief The FullUpdate class passes the whole problem to the back-ends at each solve
+ */
+class FullUpdate: public OpenSoT::solvers::iHQP
+{
+public:
+    FullUpdate(OpenSoT::solvers::iHQP::Stack& stack, ConstraintPtr bounds):
+        OpenSoT::solvers::iHQP(stack, bounds, 1.)
+    {}
+
+    bool solve(Eigen::VectorXd& solution)
+    {
+        for(unsigned int i = 0; i < _committed_versions.size(); ++i)
+            _committed_versions[i].valid = false;
+        return OpenSoT::solvers::iHQP::solve(solution);
+    }
+};
+
+class testCostFunction: public ::testing::Test
+{
+protected:
+    testCostFunction():
+        x_size(8)
+    {
+        std::srand(0);
+        OpenSoT::tasks::GenericTask::Ptr postural(
+                    new OpenSoT::tasks::GenericTask("postural", Eigen::MatrixXd::Identity(x_size, x_size),
+                                                    Eigen::VectorXd::Zero(x_size)));
+        stack.push_back(postural);
+        cost_function.reset(new CostFunction(stack));
+    }
+
+    /**
+     * @brief check compares the cost function computed with the structure of the task with the
+     * dense one, computed with the structure set to JS_GENERAL
+     */
+    void check(OpenSoT::tasks::GenericTask::Ptr task, const OpenSoT::JacobianStructure structure)
+    {
+        EXPECT_EQ(task->getJacobianStructure(), structure);
+
+        Eigen::MatrixXd H, H_dense;
+        Eigen::VectorXd g, g_dense;
+        cost_function->compute(task, H, g);
+
+        Eigen::MatrixXd W = task->getWeight();
+        H_dense = task->getA().transpose()*W*task->getA();
+        g_dense = -task->getA().transpose()*W*task->getb() + task->getc();
+
+        EXPECT_TRUE(H.isApprox(H_dense, 1e-12)) << "H:\n" << H << "\nH_dense:\n" << H_dense;
+        EXPECT_TRUE(g.isApprox(g_dense, 1e-12)) << "g: " << g.transpose() << "\ng_dense: " << g_dense.transpose();
+
+        //the gradient alone, used when the Hessian did not change
+        Eigen::VectorXd g_only;
+        cost_function->computeGradient(task, g_only);
+        EXPECT_TRUE(g_only.isApprox(g_dense, 1e-12));
+
+        //the general kernel
+        task->setJacobianStructure(OpenSoT::JS_GENERAL);
+        cost_function->compute(task, H, g);
+        EXPECT_TRUE(H.isApprox(H_dense, 1e-12));
+        EXPECT_TRUE(g.isApprox(g_dense, 1e-12));
+    }
+
+    OpenSoT::tasks::GenericTask::Ptr createTask(const Eigen::MatrixXd& A)
+    {
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task", A, Eigen::VectorXd::Random(A.rows())));
+        task->setc(Eigen::VectorXd::Random(x_size));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        return task;
+    }
+
+    Eigen::MatrixXd randomDiagonalWeight(const int size)
+    {
+        Eigen::VectorXd w = Eigen::VectorXd::Random(size).array().abs() + 0.1;
+        return w.asDiagonal();
+    }
+
+    Eigen::MatrixXd randomWeight(const int size)
+    {
+        Eigen::MatrixXd W = Eigen::MatrixXd::Random(size, size);
+        return W*W.transpose() + Eigen::MatrixXd::Identity(size, size);
+    }
+
+    unsigned int x_size;
+    OpenSoT::solvers::iHQP::Stack stack;
+    boost::shared_ptr<CostFunction> cost_function;
+};
+
+TEST_F(testCostFunction, testIdentity)
+{
+    OpenSoT::tasks::GenericTask::Ptr task = createTask(Eigen::MatrixXd::Identity(x_size, x_size));
+    task->setJacobianStructure(OpenSoT::JS_IDENTITY);
+    check(task, OpenSoT::JS_IDENTITY);
+
+    task->setJacobianStructure(OpenSoT::JS_IDENTITY);
+    task->setWeight(randomDiagonalWeight(x_size));
+    task->setWeightIsDiagonalFlag(true);
+    check(task, OpenSoT::JS_IDENTITY);
+
+    task->setJacobianStructure(OpenSoT::JS_IDENTITY);
+    task->setWeight(randomWeight(x_size));
+    task->setWeightIsDiagonalFlag(false);
+    check(task, OpenSoT::JS_IDENTITY);
+
+    //masked columns are zero, the Jacobian is a selection
+    task->setJacobianStructure(OpenSoT::JS_IDENTITY);
+    task->setWeight(randomDiagonalWeight(x_size));
+    task->setWeightIsDiagonalFlag(true);
+    std::vector<bool> mask(x_size, true);
+    mask[2] = mask[5] = false;
+    task->setActiveJointsMask(mask);
+    check(task, OpenSoT::JS_DIAGONAL_SELECTION);
+}
+
+TEST_F(testCostFunction, testDiagonalSelection)
+{
+    Eigen::MatrixXd A(4, x_size);
+    A.setZero();
+    A(0,1) = 2.; A(1,6) = -0.5; A(2,3) = 1.; A(3,1) = 1.;
+    OpenSoT::tasks::GenericTask::Ptr task = createTask(A);
+    task->setJacobianStructure(OpenSoT::JS_DIAGONAL_SELECTION);
+    check(task, OpenSoT::JS_DIAGONAL_SELECTION);
+
+    task->setJacobianStructure(OpenSoT::JS_DIAGONAL_SELECTION);
+    task->setWeight(randomDiagonalWeight(4));
+    task->setWeightIsDiagonalFlag(true);
+    check(task, OpenSoT::JS_DIAGONAL_SELECTION);
+
+    //a non diagonal weight uses the general kernel
+    task->setJacobianStructure(OpenSoT::JS_DIAGONAL_SELECTION);
+    task->setWeight(randomWeight(4));
+    task->setWeightIsDiagonalFlag(false);
+    check(task, OpenSoT::JS_DIAGONAL_SELECTION);
+}
+
+TEST_F(testCostFunction, testBlockSparse)
+{
+    Eigen::MatrixXd A(5, x_size);
+    A.setZero();
+    A.middleCols(2, 4).setRandom();
+    OpenSoT::tasks::GenericTask::Ptr task = createTask(A);
+    task->setJacobianBlock(2, 4);
+    check(task, OpenSoT::JS_BLOCK_SPARSE);
+
+    task->setJacobianBlock(2, 4);
+    task->setWeight(randomWeight(5));
+    check(task, OpenSoT::JS_BLOCK_SPARSE);
+}
+
+TEST_F(testCostFunction, testGeneral)
+{
+    OpenSoT::tasks::GenericTask::Ptr task = createTask(Eigen::MatrixXd::Random(6, x_size));
+    check(task, OpenSoT::JS_GENERAL);
+
+    task->setWeight(randomWeight(6));
+    check(task, OpenSoT::JS_GENERAL);
+}
+
+TEST_F(testCostFunction, testStructurePropagation)
+{
+    //variables of an OptvarHelper are a selection of the input
+    OpenSoT::OptvarHelper::VariableVector variables;
+    variables.emplace_back("qddot", 6);
+    variables.emplace_back("force", 2);
+    OpenSoT::OptvarHelper optvar(variables);
+    OpenSoT::tasks::MinimizeVariable::Ptr min_force(
+                new OpenSoT::tasks::MinimizeVariable("min_force", optvar.getVariable("force")));
+    EXPECT_EQ(min_force->getJacobianStructure(), OpenSoT::JS_DIAGONAL_SELECTION);
+
+    Eigen::MatrixXd A(3, x_size);
+    A.setZero();
+    A.middleCols(1, 3).setRandom();
+    OpenSoT::tasks::GenericTask::Ptr block = createTask(A);
+    block->setJacobianBlock(1, 3);
+    Eigen::MatrixXd B(2, x_size);
+    B.setZero();
+    B.middleCols(3, 2).setRandom();
+    OpenSoT::tasks::GenericTask::Ptr block2 = createTask(B);
+    block2->setJacobianBlock(3, 2);
+    OpenSoT::tasks::GenericTask::Ptr identity = createTask(Eigen::MatrixXd::Identity(x_size, x_size));
+    identity->setJacobianStructure(OpenSoT::JS_IDENTITY);
+
+    //rows of an identity are a selection
+    std::list<unsigned int> rows = {1, 2, 5};
+    OpenSoT::SubTask::Ptr sub_task(new OpenSoT::SubTask(identity, rows));
+    EXPECT_EQ(sub_task->getJacobianStructure(), OpenSoT::JS_DIAGONAL_SELECTION);
+
+    OpenSoT::tasks::Aggregated::Ptr selections(new OpenSoT::tasks::Aggregated(min_force, identity, x_size));
+    EXPECT_EQ(selections->getJacobianStructure(), OpenSoT::JS_DIAGONAL_SELECTION);
+
+    OpenSoT::tasks::Aggregated::Ptr blocks(new OpenSoT::tasks::Aggregated(block, block2, x_size));
+    EXPECT_EQ(blocks->getJacobianStructure(), OpenSoT::JS_BLOCK_SPARSE);
+    EXPECT_EQ(blocks->getJacobianBlockStart(), 1);
+    EXPECT_EQ(blocks->getJacobianBlockSize(), 4);
+
+    OpenSoT::tasks::Aggregated::Ptr mixed(new OpenSoT::tasks::Aggregated(block, identity, x_size));
+    EXPECT_EQ(mixed->getJacobianStructure(), OpenSoT::JS_GENERAL);
+
+    //a non diagonal weight mixes the rows
+    identity->setWeight(randomWeight(x_size));
+    selections->update(Eigen::VectorXd::Zero(x_size));
+    EXPECT_EQ(selections->getJacobianStructure(), OpenSoT::JS_GENERAL);
+
+    //the aggregated cost functions are the same of the dense ones
+    Eigen::MatrixXd H, H_dense;
+    Eigen::VectorXd g, g_dense;
+    std::vector<OpenSoT::tasks::Aggregated::TaskPtr> tasks = {sub_task, blocks, min_force};
+    for(unsigned int i = 0; i < tasks.size(); ++i)
+    {
+        cost_function->compute(tasks[i], H, g);
+        H_dense = tasks[i]->getA().transpose()*tasks[i]->getWeight()*tasks[i]->getA();
+        g_dense = -tasks[i]->getA().transpose()*tasks[i]->getWeight()*tasks[i]->getb() + tasks[i]->getc();
+        EXPECT_TRUE(H.isApprox(H_dense, 1e-12));
+        EXPECT_TRUE(g.isApprox(g_dense, 1e-12));
+    }
+}
+
+TEST_F(testCostFunction, testUnchangedData)
+{
+    //the parts of the problem which do not change are not passed again to the back-ends,
+    //the solutions are the same of a solver which receives the whole problem at each solve
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Random(4, x_size);
+    Eigen::MatrixXd A2 = Eigen::MatrixXd::Random(4, x_size);
+    Eigen::VectorXd b1 = Eigen::VectorXd::Random(4);
+    Eigen::VectorXd b2 = Eigen::VectorXd::Random(4);
+    Eigen::VectorXd u(x_size);
+    u.setConstant(0.5);
+
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+    std::vector<OpenSoT::constraints::GenericConstraint::Ptr> bounds;
+    std::vector<OpenSoT::solvers::iHQP::Stack> stacks;
+    for(unsigned int j = 0; j < 2; ++j)
+    {
+        OpenSoT::tasks::GenericTask::Ptr task1(new OpenSoT::tasks::GenericTask("task1", A1, b1));
+        OpenSoT::tasks::GenericTask::Ptr task2(new OpenSoT::tasks::GenericTask("task2", A2, b2));
+        bounds.emplace_back(new OpenSoT::constraints::GenericConstraint("bounds", u, -u, x_size));
+        tasks.push_back(task1);
+        tasks.push_back(task2);
+        stacks.push_back({task1, task2});
+    }
+    OpenSoT::solvers::iHQP solver(stacks[0], bounds[0], 1.);
+    FullUpdate reference_solver(stacks[1], bounds[1]);
+
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(x_size), x_reference(x_size);
+    for(unsigned int k = 0; k < 30; ++k)
+    {
+        //b moves at every solve, A and the bounds only sometimes
+        b2[k%4] += 0.05;
+        if(k%5 == 0)
+            A1(k%4, k%x_size) += 0.1;
+        if(k == 12)
+            u[k%x_size] = 0.1;
+
+        for(unsigned int j = 0; j < 2; ++j)
+        {
+            tasks[2*j]->setA(A1);
+            tasks[2*j+1]->setb(b2);
+            bounds[j]->setBounds(u, -u);
+            bounds[j]->update(x);
+        }
+
+        ASSERT_TRUE(solver.solve(x));
+        ASSERT_TRUE(reference_solver.solve(x_reference));
+        EXPECT_NEAR((x - x_reference).lpNorm<Eigen::Infinity>(), 0., 1e-8) << "solve " << k;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
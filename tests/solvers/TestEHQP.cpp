@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <utils/RandomStack.h>
+#include <chrono>
+
+namespace {
+
+class testeHQP: public ::testing::Test, public RandomStack
+{
+protected:
+
+    testeHQP()
+    {
+        //last level is a regularization on the whole variable
+        addPostural();
+    }
+};
+
+TEST_F(testeHQP, testNullSpaceBasis)
+{
+    OpenSoT::solvers::eHQP svd(_stack);
+    OpenSoT::solvers::eHQP nsb(_stack);
+    EXPECT_EQ(svd.getDecomposition(), OpenSoT::solvers::eHQP::SVD);
+    nsb.setDecomposition(OpenSoT::solvers::eHQP::NULL_SPACE_BASIS);
+    EXPECT_EQ(nsb.getDecomposition(), OpenSoT::solvers::eHQP::NULL_SPACE_BASIS);
+
+    Eigen::VectorXd x_svd(_x_size), x_nsb(_x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        //a full weight on the second level, changed every two ticks
+        if(k % 2 == 0)
+        {
+            Eigen::MatrixXd W(6,6);
+            W.setRandom(6,6);
+            W = W*W.transpose() + Eigen::MatrixXd::Identity(6,6);
+            _tasks[1]->setWeight(W);
+        }
+
+        Eigen::VectorXd b = _tasks[2]->getb();
+        b.setRandom(b.size());
+        _tasks[2]->setb(b);
+        for(unsigned int i = 0; i < _stack.size(); ++i)
+            _stack[i]->update(Eigen::VectorXd::Zero(_x_size));
+
+        EXPECT_TRUE(svd.solve(x_svd));
+        EXPECT_TRUE(nsb.solve(x_nsb));
+
+        for(unsigned int i = 0; i < _x_size; ++i)
+            EXPECT_NEAR(x_svd[i], x_nsb[i], 1e-8);
+
+        //the first three levels are compatible (3 + 6 + 4 < 20)
+        for(unsigned int i = 0; i < _tasks.size(); ++i)
+        {
+            Eigen::VectorXd e = _tasks[i]->getA()*x_nsb - _tasks[i]->getb();
+            EXPECT_NEAR(e.norm(), 0., 1e-9);
+        }
+    }
+}
+
+TEST_F(testeHQP, testNullSpaceBasisRankDeficient)
+{
+    //the second level repeats two rows of the first one, with a different reference
+    Eigen::MatrixXd A = _tasks[1]->getA();
+    A.topRows(2) = _tasks[0]->getA().topRows(2);
+    _tasks[1]->setA(A);
+    for(unsigned int i = 0; i < _stack.size(); ++i)
+        _stack[i]->update(Eigen::VectorXd::Zero(_x_size));
+
+    OpenSoT::solvers::eHQP nsb(_stack);
+    nsb.setDecomposition(OpenSoT::solvers::eHQP::NULL_SPACE_BASIS);
+
+    Eigen::VectorXd x(_x_size);
+    EXPECT_TRUE(nsb.solve(x));
+
+    //the first level is not perturbed by the conflicting rows of the second one
+    Eigen::VectorXd e0 = _tasks[0]->getA()*x - _tasks[0]->getb();
+    EXPECT_NEAR(e0.norm(), 0., 1e-9);
+
+    //the remaining rows of the second level and the third level are still achieved
+    Eigen::VectorXd e1 = _tasks[1]->getA()*x - _tasks[1]->getb();
+    EXPECT_NEAR(e1.tail(4).norm(), 0., 1e-9);
+    Eigen::VectorXd e2 = _tasks[2]->getA()*x - _tasks[2]->getb();
+    EXPECT_NEAR(e2.norm(), 0., 1e-9);
+
+    //the last level minimizes the norm in the remaining 20 - 3 - 4 - 4 dimensional null-space:
+    //the solution has no component in it
+    Eigen::MatrixXd J(11, _x_size);
+    J<<_tasks[0]->getA(), _tasks[1]->getA().bottomRows(4), _tasks[2]->getA();
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(J, Eigen::ComputeFullV);
+    EXPECT_NEAR((svd.matrixV().rightCols(_x_size - 11).transpose()*x).norm(), 0., 1e-9);
+}
+
+TEST_F(testeHQP, testSVDRankDeficient)
+{
+    //the second level repeats two rows of the first one: its projected Jacobian has rank 4
+    Eigen::MatrixXd A = _tasks[1]->getA();
+    A.topRows(2) = _tasks[0]->getA().topRows(2);
+    _tasks[1]->setA(A);
+    for(unsigned int i = 0; i < _stack.size(); ++i)
+        _stack[i]->update(Eigen::VectorXd::Zero(_x_size));
+
+    OpenSoT::solvers::eHQP svd(_stack);
+    OpenSoT::solvers::eHQP nsb(_stack);
+    nsb.setDecomposition(OpenSoT::solvers::eHQP::NULL_SPACE_BASIS);
+
+    Eigen::VectorXd x_svd(_x_size), x_nsb(_x_size);
+    EXPECT_TRUE(svd.solve(x_svd));
+    EXPECT_TRUE(nsb.solve(x_nsb));
+
+    //the projector of the second level removes only the 4 directions of its row space, the lower
+    //levels move in the true 20 - 3 - 4 dimensional null-space
+    for(unsigned int i = 0; i < _x_size; ++i)
+        EXPECT_NEAR(x_svd[i], x_nsb[i], 1e-8);
+
+    Eigen::MatrixXd J(11, _x_size);
+    J<<_tasks[0]->getA(), _tasks[1]->getA().bottomRows(4), _tasks[2]->getA();
+    Eigen::JacobiSVD<Eigen::MatrixXd> J_svd(J, Eigen::ComputeFullV);
+    EXPECT_NEAR((J_svd.matrixV().rightCols(_x_size - 11).transpose()*x_svd).norm(), 0., 1e-9);
+}
+
+TEST_F(testeHQP, testPinvLDLT)
+{
+    OpenSoT::solvers::eHQP svd(_stack);
+    OpenSoT::solvers::eHQP ldlt(_stack);
+    EXPECT_EQ(svd.getPinvStrategy(), OpenSoT::solvers::eHQP::PINV_SVD);
+    ldlt.setPinvStrategy(OpenSoT::solvers::eHQP::PINV_LDLT);
+    EXPECT_EQ(ldlt.getPinvStrategy(), OpenSoT::solvers::eHQP::PINV_LDLT);
+
+    //the second level has two rows of the first one: JP is singular and falls back to the SVD
+    Eigen::MatrixXd A = _tasks[1]->getA();
+    Eigen::VectorXd x_svd(_x_size), x_ldlt(_x_size);
+    for(unsigned int k = 0; k < 2; ++k)
+    {
+        if(k == 1)
+        {
+            A.topRows(2) = _tasks[0]->getA().topRows(2);
+            _tasks[1]->setA(A);
+        }
+        for(unsigned int i = 0; i < _stack.size(); ++i)
+            _stack[i]->update(Eigen::VectorXd::Zero(_x_size));
+
+        EXPECT_TRUE(svd.solve(x_svd));
+        EXPECT_TRUE(ldlt.solve(x_ldlt));
+
+        for(unsigned int i = 0; i < _x_size; ++i)
+            EXPECT_NEAR(x_svd[i], x_ldlt[i], 1e-8);
+    }
+}
+
+TEST(testeHQPTimings, testPinvSVDvsLDLT)
+{
+    //four 6 x 30 Cartesian-like levels and a postural
+    const unsigned int x_size = 30;
+    const unsigned int iter = 1000;
+    std::srand(0);
+
+    OpenSoT::solvers::eHQP::Stack stack;
+    for(unsigned int i = 0; i < 4; ++i)
+    {
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i),
+                        Eigen::MatrixXd::Random(6, x_size), Eigen::VectorXd::Random(6)));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack.push_back(task);
+    }
+    OpenSoT::tasks::GenericTask::Ptr postural(
+                new OpenSoT::tasks::GenericTask("postural", Eigen::MatrixXd::Identity(x_size, x_size),
+                                                Eigen::VectorXd::Zero(x_size)));
+    postural->update(Eigen::VectorXd::Zero(x_size));
+    stack.push_back(postural);
+
+    OpenSoT::solvers::eHQP svd(stack);
+    OpenSoT::solvers::eHQP ldlt(stack);
+    ldlt.setPinvStrategy(OpenSoT::solvers::eHQP::PINV_LDLT);
+
+    Eigen::VectorXd x_svd(x_size), x_ldlt(x_size);
+    double t_svd = 0., t_ldlt = 0.;
+    for(unsigned int k = 0; k < iter; ++k)
+    {
+        auto tic = std::chrono::high_resolution_clock::now();
+        svd.solve(x_svd);
+        auto toc = std::chrono::high_resolution_clock::now();
+        t_svd += std::chrono::duration<double>(toc-tic).count();
+
+        tic = std::chrono::high_resolution_clock::now();
+        ldlt.solve(x_ldlt);
+        toc = std::chrono::high_resolution_clock::now();
+        t_ldlt += std::chrono::duration<double>(toc-tic).count();
+
+        EXPECT_NEAR((x_svd - x_ldlt).norm(), 0., 1e-8);
+    }
+
+    std::cout<<"PINV_SVD mean solve time: "<<1e6*t_svd/iter<<" [us]"<<std::endl;
+    std::cout<<"PINV_LDLT mean solve time: "<<1e6*t_ldlt/iter<<" [us]"<<std::endl;
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
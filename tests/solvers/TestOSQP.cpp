@@ -220,6 +220,141 @@ TEST_F(testOSQPProblem, testTask)
     std::cout<<"q_ref: "<<q_ref.transpose()<<std::endl;
 }
 
+TEST_F(testOSQPProblem, testSparsityPattern)
+{
+    int n = 12;
+    int m = 4;
+
+    //Task involving only the first half of the variables
+    Eigen::MatrixXd J(6, n); J.setZero(J.rows(), J.cols());
+    J.leftCols(n/2).setRandom(6, n/2);
+    Eigen::MatrixXd H = J.transpose()*J + Eigen::MatrixXd::Identity(n,n);
+    Eigen::VectorXd g(n); g.setRandom(n);
+
+    //Constraints with few nonzeros
+    Eigen::MatrixXd A(m, n); A.setZero(A.rows(), A.cols());
+    A(0,1) = 1.; A(1,7) = 1.; A(2,0) = 1.; A(2,2) = -1.;
+    Eigen::VectorXd lA(m), uA(m);
+    lA.setConstant(m, -0.1); uA.setConstant(m, 0.1);
+    Eigen::VectorXd l(n), u(n);
+    l.setConstant(n, -0.5); u.setConstant(n, 0.5);
+
+    OpenSoT::solvers::BackEnd::Ptr osqp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr qpoases = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, n, m, OpenSoT::HST_POSDEF, 0.);
+
+    boost::shared_ptr<OSQPSettings> settings = boost::any_cast<boost::shared_ptr<OSQPSettings> >(osqp->getOptions());
+    settings->eps_abs = 1e-9;
+    settings->eps_rel = 1e-9;
+    settings->max_iter = 100000;
+
+    EXPECT_TRUE(osqp->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(qpoases->initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        //new nonzeros outside the initial pattern, then back to the original one
+        J.rightCols(n/2).setConstant(k%2 ? 0.1 : 0.);
+        A(3,11) = k%2 ? 1. : 0.;
+        H = J.transpose()*J + Eigen::MatrixXd::Identity(n,n);
+        g.setRandom(n);
+
+        EXPECT_TRUE(osqp->updateTask(H, g));
+        EXPECT_TRUE(osqp->updateConstraints(A, lA, uA));
+        EXPECT_TRUE(osqp->solve());
+
+        EXPECT_TRUE(qpoases->updateTask(H, g));
+        EXPECT_TRUE(qpoases->updateConstraints(A, lA, uA));
+        EXPECT_TRUE(qpoases->solve());
+
+        for(unsigned int i = 0; i < n; ++i)
+            EXPECT_NEAR(osqp->getSolution()[i], qpoases->getSolution()[i], 1e-4);
+    }
+}
+
+TEST_F(testOSQPProblem, testWorkspaceReuse)
+{
+    int n = 10;
+    Eigen::MatrixXd H(n,n); H.setIdentity(n,n);
+    Eigen::VectorXd g(n); g.setRandom(n);
+    Eigen::MatrixXd A(1,n); A.setOnes(1,n);
+    Eigen::VectorXd lA(1), uA(1); lA[0] = -0.1; uA[0] = 0.1;
+    Eigen::VectorXd l(n), u(n); l.setConstant(n, -1.); u.setConstant(n, 1.);
+
+    OpenSoT::solvers::OSQPBackEnd osqp(n, 1);
+    EXPECT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_EQ(osqp.getNumberOfRefactorizations(), 0);
+
+    //only g and the bounds change: no factorizations
+    for(unsigned int i = 0; i < 10; ++i)
+    {
+        g.setRandom(n);
+        EXPECT_TRUE(osqp.updateTask(H, g));
+        EXPECT_TRUE(osqp.updateBounds(l*(1.+0.1*i), u*(1.+0.1*i)));
+        EXPECT_TRUE(osqp.solve());
+    }
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_EQ(osqp.getNumberOfRefactorizations(), 0);
+
+    //H changes
+    H *= 2.;
+    EXPECT_TRUE(osqp.updateTask(H, g));
+    EXPECT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_EQ(osqp.getNumberOfRefactorizations(), 1);
+
+    //same dimensions: the workspace is reused
+    A *= 2.;
+    EXPECT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_EQ(osqp.getNumberOfRefactorizations(), 2);
+
+    //different dimensions: new setup
+    Eigen::MatrixXd A2(0,n);
+    EXPECT_TRUE(osqp.initProblem(H, g, A2, Eigen::VectorXd(0), Eigen::VectorXd(0), l, u));
+    EXPECT_EQ(osqp.getNumberOfSetups(), 2);
+}
+
+TEST_F(testOSQPProblem, testSetOptions)
+{
+    int n = 10;
+    Eigen::MatrixXd H(n,n); H.setIdentity(n,n);
+    Eigen::VectorXd g(n); g.setRandom(n);
+    Eigen::MatrixXd A(1,n); A.setOnes(1,n);
+    Eigen::VectorXd lA(1), uA(1); lA[0] = -0.1; uA[0] = 0.1;
+    Eigen::VectorXd l(n), u(n); l.setConstant(n, -1.); u.setConstant(n, 1.);
+
+    OpenSoT::solvers::OSQPBackEnd osqp(n, 1);
+    EXPECT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    Eigen::VectorXd solution = osqp.getSolution();
+
+    //runtime settings and rho are updated in the workspace
+    OSQPSettings settings = *boost::any_cast<boost::shared_ptr<OSQPSettings> >(osqp.getOptions());
+    settings.eps_abs = 1e-6;
+    settings.eps_rel = 1e-6;
+    settings.max_iter = 8000;
+    settings.rho = 2.*settings.rho;
+    osqp.setOptions(settings);
+    EXPECT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_TRUE(solution.isApprox(osqp.getSolution(), 1e-3));
+
+    //settings used only by the setup: new workspace at the next solve
+    settings.sigma = 2.*settings.sigma;
+    osqp.setOptions(settings);
+    EXPECT_EQ(osqp.getNumberOfSetups(), 1);
+    EXPECT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.getNumberOfSetups(), 2);
+    EXPECT_EQ(osqp.getSolveInfo().path, OpenSoT::solvers::BackEnd::SOLVE_COLDSTART);
+    EXPECT_TRUE(solution.isApprox(osqp.getSolution(), 1e-3));
+
+    EXPECT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.getNumberOfSetups(), 2);
+}
+
 using namespace OpenSoT::constraints::velocity;
 TEST_F(testOSQPProblem, testProblemWithConstraint)
 {
@@ -16,6 +16,8 @@
 #include <OpenSoT/tasks/velocity/MinimumEffort.h>
 #include <XBotInterface/ModelInterface.h>
 #include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
 
 
 std::string robotology_root = std::getenv("ROBOTOLOGY_ROOT");
@@ -96,6 +98,42 @@ public:
 
 };
 
+/**
+ * @brief The variableConstraint class keeps the first rows of a constant set of constraints:
+ * -b <= A_all x <= b
+ */
+class variableConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    typedef boost::shared_ptr<variableConstraint> Ptr;
+
+    variableConstraint(const Eigen::MatrixXd& A_all, const double b):
+        Constraint("variable_constraint", A_all.cols()),
+        _A_all(A_all),
+        _b(b)
+    {
+        setRows(_A_all.rows());
+    }
+
+    void setRows(const int rows)
+    {
+        _Aineq = _A_all.topRows(rows);
+        _bUpperBound.setConstant(rows, _b);
+        _bLowerBound.setConstant(rows, -_b);
+        padInequalities();
+    }
+
+    bool setInequalityCapacity(const unsigned int capacity)
+    {
+        _inequality_capacity = capacity;
+        return true;
+    }
+
+private:
+    Eigen::MatrixXd _A_all;
+    double _b;
+};
+
 class simpleProblem
 {
 public:
@@ -280,6 +318,142 @@ TEST_F(testQPOasesProblem, test_update_constraint)
 //    EXPECT_NEAR(solution[2], 2.5714,1E-4);
 }
 
+TEST_F(testQPOasesProblem, test_reinit_time_budget)
+{
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 10, 0, OpenSoT::HST_POSDEF, 1.);
+
+    //all the upper bounds are active at the solution, each one is a working set change
+    Eigen::MatrixXd H(10,10);
+    H.setIdentity(10,10);
+    Eigen::VectorXd g(10);
+    g.setConstant(-100.);
+    Eigen::MatrixXd A(0,10);
+    Eigen::VectorXd lA, uA;
+    Eigen::VectorXd l(10), u(10);
+    l.setConstant(-1.);
+    u.setConstant(1.);
+    EXPECT_TRUE(qp->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(qp->solve());
+
+    //the initialization done by a change of size is bounded by the time budget
+    EXPECT_TRUE(qp->setTimeBudget(1e-12));
+    A.setOnes(1,10);
+    lA.setConstant(1, -100.);
+    uA.setConstant(1, 100.);
+    EXPECT_FALSE(qp->updateConstraints(A, lA, uA));
+    EXPECT_TRUE(qp->getSolveInfo().time_limit_reached);
+
+    EXPECT_TRUE(qp->setTimeBudget(1.));
+    EXPECT_TRUE(qp->solve());
+    EXPECT_FALSE(qp->getSolveInfo().time_limit_reached);
+    for(unsigned int i = 0; i < 10; ++i)
+        EXPECT_NEAR(qp->getSolution()[i], 1., 1e-6);
+}
+
+TEST_F(testQPOasesProblem, test_views)
+{
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 3, 2, OpenSoT::HST_POSDEF, 1.);
+    OpenSoT::solvers::BackEnd::Ptr qp_views = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 3, 2, OpenSoT::HST_POSDEF, 1.);
+
+    Eigen::MatrixXd H(3,3); H.setIdentity(3,3);
+    Eigen::VectorXd g(3); g<<-1., 2., 3.;
+    Eigen::MatrixXd A(2,3); A<<1., 1., 0.,
+                                0., 2., -1.;
+    Eigen::VectorXd lA(2); lA<<-0.5, -1.;
+    Eigen::VectorXd uA(2); uA<<0.5, 1.;
+    Eigen::VectorXd l(3); l.setConstant(3, -1.);
+    Eigen::VectorXd u(3); u.setConstant(3, 1.);
+
+    EXPECT_TRUE(qp->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(qp_views->initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        H(0,0) = 1. + 0.1*k;
+        g[1] = std::sin(0.1*k);
+        A(1,2) = std::cos(0.1*k);
+        uA[0] = 0.5 + 0.01*k;
+        u[2] = 1. - 0.01*k;
+
+        EXPECT_TRUE(qp->updateTask(H, g));
+        EXPECT_TRUE(qp->updateConstraints(A, lA, uA));
+        EXPECT_TRUE(qp->updateBounds(l, u));
+        EXPECT_TRUE(qp->solve());
+
+        qp_views->getHView() = H;
+        qp_views->getgView() = g;
+        EXPECT_TRUE(qp_views->commitTask());
+        qp_views->getAView() = A;
+        qp_views->getlAView() = lA;
+        qp_views->getuAView() = uA;
+        EXPECT_TRUE(qp_views->commitConstraints());
+        qp_views->getlView() = l;
+        qp_views->getuView() = u;
+        EXPECT_TRUE(qp_views->commitBounds());
+        EXPECT_TRUE(qp_views->solve());
+
+        EXPECT_TRUE(qp_views->getA() == A);
+        EXPECT_TRUE(qp_views->getSolution() == qp->getSolution());
+    }
+}
+
+TEST_F(testQPOasesProblem, test_working_set_guess)
+{
+    std::srand(0);
+    Eigen::MatrixXd H(10,10); H.setIdentity(10,10);
+    Eigen::VectorXd g(10); g.setRandom(10); g *= 10.;
+    Eigen::MatrixXd A(4,10); A.setRandom(4,10);
+    Eigen::VectorXd lA(4); lA.setConstant(4, -0.5);
+    Eigen::VectorXd uA(4); uA.setConstant(4, 0.5);
+    Eigen::VectorXd l(10); l.setConstant(10, -1.);
+    Eigen::VectorXd u(10); u.setConstant(10, 1.);
+
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 10, 4, OpenSoT::HST_POSDEF, 1.);
+    EXPECT_TRUE(qp->initProblem(H, g, A, lA, uA, l, u));
+
+    Eigen::VectorXd bounds_state, constraints_state;
+    EXPECT_TRUE(qp->getWorkingSet(bounds_state, constraints_state));
+    ASSERT_EQ(bounds_state.size(), 10);
+    ASSERT_EQ(constraints_state.size(), 4);
+    EXPECT_GT(bounds_state.cwiseAbs().sum() + constraints_state.cwiseAbs().sum(), 0.);
+    for(unsigned int i = 0; i < 10; ++i)
+    {
+        if(bounds_state[i] < 0.)
+            EXPECT_NEAR(qp->getSolution()[i], l[i], 1e-9);
+        else if(bounds_state[i] > 0.)
+            EXPECT_NEAR(qp->getSolution()[i], u[i], 1e-9);
+    }
+
+    //the same problem initialized from the optimal working set does not change it
+    OpenSoT::solvers::BackEnd::Ptr qp_guess = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 10, 4, OpenSoT::HST_POSDEF, 1.);
+    EXPECT_TRUE(qp_guess->setWorkingSetGuess(bounds_state, constraints_state));
+    EXPECT_TRUE(qp_guess->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_LT(qp_guess->getSolveInfo().iterations, qp->getSolveInfo().iterations);
+    EXPECT_NEAR((qp_guess->getSolution() - qp->getSolution()).norm(), 0., 1e-9);
+
+    //a guess which does not fit the size of the problem is not used
+    A.conservativeResize(5, 10); A.row(4).setRandom();
+    lA.conservativeResize(5); lA[4] = -0.5;
+    uA.conservativeResize(5); uA[4] = 0.5;
+    EXPECT_TRUE(qp_guess->setWorkingSetGuess(bounds_state, constraints_state));
+    EXPECT_TRUE(qp_guess->updateConstraints(A, lA, uA));
+    EXPECT_TRUE(qp_guess->solve());
+
+    //a wrong guess is not fatal
+    constraints_state.setConstant(5, -1.);
+    bounds_state.setConstant(10, 1.);
+    OpenSoT::solvers::BackEnd::Ptr qp_wrong = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 10, 5, OpenSoT::HST_POSDEF, 1.);
+    EXPECT_TRUE(qp_wrong->setWorkingSetGuess(bounds_state, constraints_state));
+    EXPECT_TRUE(qp_wrong->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_NEAR((qp_wrong->getSolution() - qp_guess->getSolution()).norm(), 0., 1e-6);
+}
+
 TEST_F(testQPOasesProblem, test_update_task)
 {
     //OpenSoT::solvers::QPOasesBackEnd qp(3,0);
@@ -1126,6 +1300,345 @@ TEST_F(testiHQP, testMinEffort)
 
 }
 
+TEST_F(testiHQP, testTimeBudget)
+{
+    const int x_size = 20;
+    std::srand(0);
+
+    OpenSoT::solvers::iHQP::Stack stack_of_tasks;
+    int rows[] = {3, 6, 20};
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        Eigen::MatrixXd A(rows[i], x_size);
+        A.setRandom(A.rows(), A.cols());
+        Eigen::VectorXd b(rows[i]);
+        b.setRandom(b.size());
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_of_tasks.push_back(task);
+    }
+
+    Eigen::VectorXd ub(x_size);
+    ub.setConstant(x_size, 0.3);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+                new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+
+    //constraint on the sum of the variables of the last level, not active
+    Eigen::VectorXd sum_upper(1), sum_lower(1);
+    sum_upper<<100.;
+    sum_lower<<-100.;
+    OpenSoT::constraints::GenericConstraint::Ptr sum(
+                new OpenSoT::constraints::GenericConstraint("sum",
+                    OpenSoT::AffineHelper(Eigen::MatrixXd::Ones(1, x_size), Eigen::VectorXd::Zero(1)),
+                    sum_upper, sum_lower, OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT));
+    stack_of_tasks[2]->getConstraints().push_back(sum);
+    stack_of_tasks[2]->update(Eigen::VectorXd::Zero(x_size));
+
+    OpenSoT::solvers::iHQP sot(stack_of_tasks, bounds, 1.);
+    OpenSoT::solvers::iHQP sot_budget(stack_of_tasks, bounds, 1.);
+    EXPECT_TRUE(sot_budget.setTimeBudget(1.));
+    EXPECT_DOUBLE_EQ(sot_budget.getTimeBudget(), 1.);
+    for(unsigned int i = 0; i < 3; ++i)
+        EXPECT_TRUE(sot_budget.isTimeBounded(i));
+
+    Eigen::VectorXd x(x_size), x_budget(x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        EXPECT_TRUE(sot.solve(x));
+        EXPECT_TRUE(sot_budget.solve(x_budget));
+        EXPECT_FALSE(sot_budget.deadlineMissed());
+        EXPECT_EQ(sot_budget.getLastSolvedLevel(), 2);
+
+        for(unsigned int i = 0; i < x_size; ++i)
+            EXPECT_NEAR(x[i], x_budget[i], 1e-9);
+    }
+
+    //the budget is over before the first level
+    EXPECT_TRUE(sot_budget.setTimeBudget(1e-12));
+    EXPECT_FALSE(sot_budget.solve(x_budget));
+    EXPECT_TRUE(sot_budget.deadlineMissed());
+    EXPECT_EQ(sot_budget.getLastSolvedLevel(), -1);
+
+    EXPECT_TRUE(sot_budget.setTimeBudget(0.));
+    EXPECT_TRUE(sot_budget.solve(x_budget));
+    EXPECT_FALSE(sot_budget.deadlineMissed());
+    for(unsigned int i = 0; i < x_size; ++i)
+        EXPECT_NEAR(x[i], x_budget[i], 1e-9);
+
+    //an infeasible level is not a missed deadline: solve() fails as without budget
+    EXPECT_TRUE(sot_budget.setTimeBudget(1.));
+    sum_upper<<11.;
+    sum_lower<<10.;
+    EXPECT_TRUE(sum->setBounds(sum_upper, sum_lower));
+    stack_of_tasks[2]->update(Eigen::VectorXd::Zero(x_size));
+    EXPECT_FALSE(sot_budget.solve(x_budget));
+    EXPECT_FALSE(sot_budget.deadlineMissed());
+    EXPECT_EQ(sot_budget.getLastSolvedLevel(), 1);
+}
+
+TEST_F(testiHQP, testTelemetry)
+{
+    const int x_size = 20;
+    std::srand(0);
+
+    OpenSoT::solvers::iHQP::Stack stack_of_tasks;
+    int rows[] = {3, 6, 20};
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        Eigen::MatrixXd A(rows[i], x_size);
+        A.setRandom(A.rows(), A.cols());
+        Eigen::VectorXd b(rows[i]);
+        b.setRandom(b.size());
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_of_tasks.push_back(task);
+    }
+
+    Eigen::VectorXd ub(x_size);
+    ub.setConstant(x_size, 0.3);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+                new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+
+    OpenSoT::solvers::iHQP sot(stack_of_tasks, bounds, 1.);
+    EXPECT_FALSE(sot.getTelemetry());
+
+    sot.enableTelemetry(4);
+    OpenSoT::solvers::iHQP::TelemetryBuffer::Ptr telemetry = sot.getTelemetry();
+    EXPECT_TRUE(bool(telemetry));
+    EXPECT_EQ(telemetry->getCapacity(), 4);
+
+    Eigen::VectorXd x(x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+        EXPECT_TRUE(sot.solve(x));
+    sot.setActiveStack(2, false);
+    EXPECT_TRUE(sot.solve(x));
+
+    EXPECT_EQ(telemetry->getNumberOfWrites(), 11);
+
+    OpenSoT::solvers::iHQP::Telemetry tick;
+    EXPECT_FALSE(telemetry->read(0, tick));
+    EXPECT_TRUE(telemetry->read(9, tick));
+    EXPECT_EQ(tick.tick, 9);
+    EXPECT_TRUE(tick.solved);
+    EXPECT_FALSE(tick.deadline_missed);
+    ASSERT_EQ(tick.levels.size(), 3);
+
+    double levels_time = 0.;
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        const OpenSoT::solvers::iHQP::LevelTelemetry& level = tick.levels[i];
+        EXPECT_TRUE(level.active);
+        EXPECT_TRUE(level.solved);
+        EXPECT_GT(level.assembly_time, 0.);
+        EXPECT_GT(level.solve_time, 0.);
+        EXPECT_EQ(level.solve_info.path, OpenSoT::solvers::BackEnd::SOLVE_HOTSTART);
+        EXPECT_GE(level.solve_info.iterations, 0);
+        EXPECT_EQ(level.number_of_variables, x_size);
+        levels_time += level.assembly_time + level.solve_time;
+    }
+    EXPECT_LE(levels_time, tick.solve_time);
+    EXPECT_EQ(tick.levels[0].number_of_constraints, 0);
+    EXPECT_EQ(tick.levels[1].number_of_constraints, 3);
+    EXPECT_EQ(tick.levels[2].number_of_constraints, 9);
+
+    //the last level is disabled
+    EXPECT_TRUE(telemetry->readLatest(tick));
+    EXPECT_EQ(tick.tick, 10);
+    EXPECT_FALSE(tick.levels[2].active);
+    EXPECT_FALSE(tick.levels[2].solved);
+
+    sot.enableTelemetry(0);
+    EXPECT_FALSE(sot.getTelemetry());
+}
+
+TEST_F(testiHQP, testWorkingSetTransfer)
+{
+    const int x_size = 20;
+    std::srand(0);
+
+    OpenSoT::solvers::iHQP::Stack stack_of_tasks;
+    int rows[] = {3, 6, 20};
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        Eigen::MatrixXd A(rows[i], x_size);
+        A.setRandom(A.rows(), A.cols());
+        Eigen::VectorXd b(rows[i]);
+        b.setRandom(b.size());
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_of_tasks.push_back(task);
+    }
+
+    Eigen::VectorXd ub(x_size);
+    ub.setConstant(x_size, 0.3);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+                new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+    variableConstraint::Ptr constraint(new variableConstraint(Eigen::MatrixXd::Random(8, x_size), 0.1));
+
+    OpenSoT::solvers::iHQP sot(stack_of_tasks, bounds, constraint, 1.);
+    OpenSoT::solvers::iHQP sot_transfer(stack_of_tasks, bounds, constraint, 1.);
+    EXPECT_FALSE(sot_transfer.getWorkingSetTransfer());
+    sot_transfer.setWorkingSetTransfer(true);
+    EXPECT_TRUE(sot_transfer.getWorkingSetTransfer());
+
+    int iterations = 0, iterations_transfer = 0;
+    Eigen::VectorXd x(x_size), x_transfer(x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        //the number of constraints changes at every solve, all the back-ends are initialized again
+        constraint->setRows(8 - k%3);
+
+        EXPECT_TRUE(sot.solve(x));
+        EXPECT_TRUE(sot_transfer.solve(x_transfer));
+        for(unsigned int i = 0; i < x_size; ++i)
+            EXPECT_NEAR(x[i], x_transfer[i], 1e-6);
+
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            OpenSoT::solvers::BackEnd::Ptr back_end;
+            EXPECT_TRUE(sot.getBackEnd(i, back_end));
+            iterations += back_end->getSolveInfo().iterations;
+            EXPECT_TRUE(sot_transfer.getBackEnd(i, back_end));
+            iterations_transfer += back_end->getSolveInfo().iterations;
+        }
+    }
+    EXPECT_LT(iterations_transfer, iterations);
+}
+
+TEST_F(testQPOasesProblem, testInequalityCapacity)
+{
+    const int x_size = 20;
+    std::srand(0);
+
+    OpenSoT::solvers::iHQP::Stack stack_of_tasks;
+    int rows[] = {3, 6, 20};
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        Eigen::MatrixXd A(rows[i], x_size);
+        A.setRandom(A.rows(), A.cols());
+        Eigen::VectorXd b(rows[i]);
+        b.setRandom(b.size());
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_of_tasks.push_back(task);
+    }
+
+    Eigen::VectorXd ub(x_size);
+    ub.setConstant(x_size, 0.3);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+                new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+    Eigen::MatrixXd A_all(8, x_size);
+    A_all.setRandom(A_all.rows(), A_all.cols());
+    variableConstraint::Ptr constraint(new variableConstraint(A_all, 0.1));
+    variableConstraint::Ptr padded(new variableConstraint(A_all, 0.1));
+    EXPECT_TRUE(padded->setInequalityCapacity(8));
+    EXPECT_EQ(padded->getInequalityCapacity(), 8);
+
+    OpenSoT::solvers::iHQP sot(stack_of_tasks, bounds, constraint, 1.);
+    OpenSoT::solvers::iHQP sot_padded(stack_of_tasks, bounds, padded, 1.);
+
+    std::vector<int> constraints_rows;
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        OpenSoT::solvers::BackEnd::Ptr back_end;
+        EXPECT_TRUE(sot_padded.getBackEnd(i, back_end));
+        constraints_rows.push_back(back_end->getNumConstraints());
+    }
+
+    Eigen::VectorXd x(x_size), x_padded(x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        constraint->setRows(8 - k%3);
+        padded->setRows(8 - k%3);
+        EXPECT_EQ(padded->getAineq().rows(), 8);
+        EXPECT_EQ(padded->getActiveInequalities(), 8 - k%3);
+
+        EXPECT_TRUE(sot.solve(x));
+        EXPECT_TRUE(sot_padded.solve(x_padded));
+        for(unsigned int i = 0; i < x_size; ++i)
+            EXPECT_NEAR(x[i], x_padded[i], 1e-6);
+
+        //the size of the problems does not change: the back-ends are never initialized again
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            OpenSoT::solvers::BackEnd::Ptr back_end;
+            EXPECT_TRUE(sot_padded.getBackEnd(i, back_end));
+            EXPECT_EQ(back_end->getNumConstraints(), constraints_rows[i]);
+            EXPECT_NE(back_end->getSolveInfo().path, OpenSoT::solvers::BackEnd::SOLVE_COLDSTART);
+        }
+    }
+
+    //more inequalities than the capacity: the constraint grows as usual
+    EXPECT_TRUE(padded->setInequalityCapacity(4));
+    padded->setRows(6);
+    EXPECT_EQ(padded->getAineq().rows(), 6);
+    EXPECT_EQ(padded->getActiveInequalities(), 6);
+}
+
+TEST_F(testQPOasesProblem, testSharedConstraints)
+{
+    const int x_size = 20;
+    std::srand(0);
+
+    Eigen::VectorXd ub(x_size);
+    ub.setConstant(x_size, 0.3);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+                new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, x_size));
+    Eigen::MatrixXd A_all(8, x_size);
+    A_all.setRandom(A_all.rows(), A_all.cols());
+    variableConstraint::Ptr constraint(new variableConstraint(A_all, 0.1));
+
+    //the same stack with the global constraint added to each task
+    OpenSoT::solvers::iHQP::Stack stack_of_tasks, stack_with_constraints;
+    int rows[] = {3, 6, 20};
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        Eigen::MatrixXd A(rows[i], x_size);
+        A.setRandom(A.rows(), A.cols());
+        Eigen::VectorXd b(rows[i]);
+        b.setRandom(b.size());
+        OpenSoT::tasks::GenericTask::Ptr task(
+                    new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_of_tasks.push_back(task);
+
+        task.reset(new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+        task->getConstraints().push_back(constraint);
+        task->update(Eigen::VectorXd::Zero(x_size));
+        stack_with_constraints.push_back(task);
+    }
+
+    OpenSoT::solvers::iHQP sot(stack_of_tasks, bounds, constraint, 1.);
+    OpenSoT::solvers::iHQP sot_with_constraints(stack_with_constraints, bounds, 1.);
+
+    Eigen::VectorXd x(x_size), x_with_constraints(x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        //the global constraint changes every other solve, the other times nothing changes
+        constraint->setRows(8 - (k/2)%3);
+
+        EXPECT_TRUE(sot.solve(x));
+        EXPECT_TRUE(sot_with_constraints.solve(x_with_constraints));
+        for(unsigned int i = 0; i < x_size; ++i)
+            EXPECT_NEAR(x[i], x_with_constraints[i], 1e-6);
+
+        //all the levels have the rows of the global constraint
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            OpenSoT::solvers::BackEnd::Ptr back_end;
+            EXPECT_TRUE(sot.getBackEnd(i, back_end));
+            EXPECT_EQ(back_end->getNumConstraints(), constraint->getAineq().rows() + (i > 0 ? rows[i-1] : 0) +
+                                                     (i > 1 ? rows[i-2] : 0));
+            EXPECT_TRUE(back_end->getlA().head(constraint->getAineq().rows()) == constraint->getbLowerBound());
+            EXPECT_TRUE(back_end->getl() == -ub);
+        }
+    }
+}
+
 TEST_F(testQPOasesProblem, testNullHessian)
 {
     //OpenSoT::solvers::QPOasesBackEnd qp(30, 0, OpenSoT::HessianType::HST_ZERO, 1e10);
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/QPRecorder.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <utils/RandomStack.h>
+#include <qpOASES.hpp>
+#include <cstdio>
+#include <unistd.h>
+
+namespace {
+
+class testQPRecorder: public ::testing::Test, public RandomStack
+{
+protected:
+    testQPRecorder():
+        RandomStack(10),
+        _file_name("/tmp/testQPRecorder_" + std::to_string(::getpid()) + ".qpr")
+    {
+
+    }
+
+    virtual ~testQPRecorder()
+    {
+        std::remove(_file_name.c_str());
+    }
+
+    void perturb()
+    {
+        for(unsigned int i = 0; i < _tasks.size(); ++i)
+        {
+            Eigen::VectorXd b = _tasks[i]->getb();
+            b.array() += 1e-2;
+            _tasks[i]->setb(b);
+            _tasks[i]->update(Eigen::VectorXd::Zero(_x_size));
+        }
+    }
+
+    std::string _file_name;
+};
+
+TEST_F(testQPRecorder, testRecordAndReplay)
+{
+    OpenSoT::solvers::iHQP solver(_stack, _bounds, 1.);
+
+    std::vector<Eigen::VectorXd> solutions;
+    {
+        OpenSoT::solvers::QPRecorder::Ptr recorder(
+                    new OpenSoT::solvers::QPRecorder(_file_name, 1024*1024));
+        solver.setRecorder(recorder);
+
+        Eigen::VectorXd x(_x_size);
+        for(unsigned int k = 0; k < 5; ++k)
+        {
+            perturb();
+            ASSERT_TRUE(solver.solve(x));
+            solutions.push_back(x);
+        }
+
+        EXPECT_EQ(recorder->getNumberOfRecords(), 5*_stack.size());
+        EXPECT_EQ(recorder->getNumberOfDroppedRecords(), 0);
+
+        solver.setRecorder(OpenSoT::solvers::QPRecorder::Ptr());
+    }
+
+    OpenSoT::solvers::QPRecording recording(_file_name);
+    ASSERT_EQ(recording.getNumberOfProblems(), 5*_stack.size());
+
+    OpenSoT::solvers::QPRecording::Problem problem;
+    for(unsigned long k = 0; k < recording.getNumberOfProblems(); ++k)
+    {
+        ASSERT_TRUE(recording.read(k, problem));
+        EXPECT_EQ(problem.tick, k/_stack.size());
+        EXPECT_EQ(problem.level_info.level, k%_stack.size());
+        EXPECT_TRUE(problem.level_info.back_end == OpenSoT::solvers::solver_back_ends::qpOASES);
+        EXPECT_DOUBLE_EQ(problem.level_info.eps_regularisation, 1.);
+        EXPECT_TRUE(problem.solved);
+        EXPECT_GE(problem.solve_time, 0.);
+        EXPECT_FALSE(problem.options.empty());
+
+        EXPECT_EQ(problem.H.rows(), _x_size);
+        EXPECT_EQ(problem.l.size(), _x_size);
+        //each level has the optimality constraints of the previous ones
+        int constraints = 0;
+        for(unsigned int i = 0; i < problem.level_info.level; ++i)
+            constraints += _tasks[i]->getA().rows();
+        EXPECT_EQ(problem.A.rows(), constraints);
+
+        if(problem.level_info.level == _stack.size()-1)
+        {
+            EXPECT_TRUE(problem.solution.isApprox(solutions[problem.tick]));
+        }
+
+        //the recorded problem can be solved again from scratch, the cold start of qpOASES regularises
+        //the underdetermined levels slightly differently from the hotstarts done by iHQP
+        OpenSoT::solvers::BackEnd::Ptr back_end = OpenSoT::solvers::BackEndFactory(
+                    problem.level_info.back_end, problem.H.rows(), problem.A.rows(),
+                    problem.level_info.hessian_type, problem.level_info.eps_regularisation);
+        EXPECT_TRUE(back_end->readOptions(problem.options.data(), problem.options.size()));
+        ASSERT_TRUE(back_end->initProblem(problem.H, problem.g, problem.A, problem.lA, problem.uA,
+                                          problem.l, problem.u));
+        EXPECT_NEAR((back_end->getSolution() - problem.solution).lpNorm<Eigen::Infinity>(), 0., 1e-3);
+    }
+    EXPECT_FALSE(recording.read(recording.getNumberOfProblems(), problem));
+}
+
+TEST_F(testQPRecorder, testFullRecording)
+{
+    OpenSoT::solvers::iHQP solver(_stack, _bounds, 1.);
+
+    //room for a few problems only
+    OpenSoT::solvers::QPRecorder::Ptr recorder(
+                new OpenSoT::solvers::QPRecorder(_file_name, 4096));
+    solver.setRecorder(recorder);
+
+    Eigen::VectorXd x(_x_size);
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        perturb();
+        EXPECT_TRUE(solver.solve(x));
+    }
+
+    EXPECT_GT(recorder->getNumberOfRecords(), 0);
+    EXPECT_LT(recorder->getNumberOfRecords(), 10*_stack.size());
+    EXPECT_EQ(recorder->getNumberOfRecords() + recorder->getNumberOfDroppedRecords(), 10*_stack.size());
+    EXPECT_LE(recorder->getSize(), recorder->getCapacity());
+
+    //the recording can be read while it is written
+    OpenSoT::solvers::QPRecording recording(_file_name);
+    EXPECT_EQ(recording.getNumberOfProblems(), recorder->getNumberOfRecords());
+}
+
+TEST_F(testQPRecorder, testQPOasesOptions)
+{
+    OpenSoT::solvers::BackEnd::Ptr back_end = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, _x_size, 0, OpenSoT::HST_SEMIDEF, 1.);
+    qpOASES::Options opt = boost::any_cast<qpOASES::Options>(back_end->getOptions());
+    opt.printLevel = qpOASES::PL_NONE;
+    opt.enableFarBounds = qpOASES::BT_FALSE;
+    opt.initialStatusBounds = qpOASES::ST_LOWER;
+    opt.numRefinementSteps = 3;
+    opt.epsRegularisation = 1e-3;
+    opt.terminationTolerance = 1e-7;
+    back_end->setOptions(opt);
+
+    std::vector<char> buffer(1024);
+    const std::size_t size = back_end->writeOptions(buffer.data(), buffer.size());
+    ASSERT_GT(size, 0);
+    EXPECT_EQ(back_end->writeOptions(buffer.data(), size - 1), 0);
+
+    //the options are rebuilt field by field
+    OpenSoT::solvers::BackEnd::Ptr replay = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, _x_size, 0, OpenSoT::HST_SEMIDEF, 1.);
+    ASSERT_TRUE(replay->readOptions(buffer.data(), size));
+    qpOASES::Options replayed = boost::any_cast<qpOASES::Options>(replay->getOptions());
+    EXPECT_EQ(replayed.printLevel, qpOASES::PL_NONE);
+    EXPECT_EQ(replayed.enableFarBounds, qpOASES::BT_FALSE);
+    EXPECT_EQ(replayed.initialStatusBounds, qpOASES::ST_LOWER);
+    EXPECT_EQ(replayed.numRefinementSteps, 3);
+    EXPECT_EQ(replayed.epsRegularisation, 1e-3);
+    EXPECT_EQ(replayed.terminationTolerance, 1e-7);
+    EXPECT_EQ(replayed.enableRamping, opt.enableRamping);
+    EXPECT_EQ(replayed.epsNZCTests, opt.epsNZCTests);
+
+    //wrong size or version
+    EXPECT_FALSE(replay->readOptions(buffer.data(), size - 1));
+    buffer[0]++;
+    EXPECT_FALSE(replay->readOptions(buffer.data(), size));
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/nHQP.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <utils/RandomStack.h>
+
+namespace {
+
+class testnHQP: public ::testing::Test, public RandomStack
+{
+protected:
+
+    testnHQP()
+    {
+        //last level is a regularization on the whole variable
+        addPostural();
+    }
+};
+
+TEST_F(testnHQP, testNullSpaceBasis)
+{
+    OpenSoT::solvers::nHQP solver(_stack, _bounds, 1.);
+
+    Eigen::VectorXd x(_x_size);
+    EXPECT_TRUE(solver.solve(x));
+
+    Eigen::MatrixXd N;
+    EXPECT_TRUE(solver.getNullSpaceBasis(0, N));
+    EXPECT_TRUE(N.isIdentity());
+
+    unsigned int rows = 0;
+    for(unsigned int i = 1; i < _stack.size(); ++i)
+    {
+        rows += _stack[i-1]->getA().rows();
+        EXPECT_TRUE(solver.getNullSpaceBasis(i, N));
+        EXPECT_EQ(N.cols(), _x_size - rows);
+        EXPECT_TRUE((N.transpose()*N).isIdentity(1e-9));
+        for(unsigned int j = 0; j < i; ++j)
+            EXPECT_TRUE((_stack[j]->getA()*N).isZero(1e-9));
+    }
+
+    EXPECT_FALSE(solver.getNullSpaceBasis(_stack.size(), N));
+}
+
+TEST_F(testnHQP, testSameSolutionOfiHQP)
+{
+    OpenSoT::solvers::nHQP nhqp(_stack, _bounds, 1.);
+    OpenSoT::solvers::iHQP ihqp(_stack, _bounds, 1.);
+
+    Eigen::VectorXd x_nhqp(_x_size), x_ihqp(_x_size);
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        for(unsigned int i = 0; i < _stack.size()-1; ++i)
+        {
+            OpenSoT::tasks::GenericTask::Ptr task =
+                    boost::dynamic_pointer_cast<OpenSoT::tasks::GenericTask>(_stack[i]);
+            Eigen::VectorXd b = task->getb();
+            b += 0.01*Eigen::VectorXd::Ones(b.size())*std::sin(0.1*k + i);
+            EXPECT_TRUE(task->setb(b));
+            task->update(Eigen::VectorXd::Zero(_x_size));
+        }
+
+        EXPECT_TRUE(nhqp.solve(x_nhqp));
+        EXPECT_TRUE(ihqp.solve(x_ihqp));
+
+        for(unsigned int i = 0; i < _x_size; ++i)
+            EXPECT_NEAR(x_nhqp[i], x_ihqp[i], 1e-6);
+
+        EXPECT_TRUE(((x_nhqp.array() - 0.3) <= 1e-9).all());
+        EXPECT_TRUE(((x_nhqp.array() + 0.3) >= -1e-9).all());
+    }
+}
+
+TEST_F(testnHQP, testSetActiveStack)
+{
+    OpenSoT::solvers::nHQP nhqp(_stack, _bounds, 1.);
+    OpenSoT::solvers::iHQP ihqp(_stack, _bounds, 1.);
+
+    nhqp.setActiveStack(1, false);
+    ihqp.setActiveStack(1, false);
+
+    Eigen::VectorXd x_nhqp(_x_size), x_ihqp(_x_size);
+    EXPECT_TRUE(nhqp.solve(x_nhqp));
+    EXPECT_TRUE(ihqp.solve(x_ihqp));
+
+    for(unsigned int i = 0; i < _x_size; ++i)
+        EXPECT_NEAR(x_nhqp[i], x_ihqp[i], 1e-6);
+
+    Eigen::MatrixXd N1, N2;
+    nhqp.getNullSpaceBasis(1, N1);
+    nhqp.getNullSpaceBasis(2, N2);
+    EXPECT_TRUE(N1 == N2);
+
+    nhqp.activateAllStacks();
+    EXPECT_TRUE(nhqp.solve(x_nhqp));
+    nhqp.getNullSpaceBasis(2, N2);
+    EXPECT_EQ(N2.cols(), N1.cols() - _stack[1]->getA().rows());
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/wHQP.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <utils/RandomStack.h>
+
+namespace {
+
+class testwHQP: public ::testing::Test, public RandomStack
+{
+protected:
+
+    testwHQP()
+    {
+        //last level is a regularization on the whole variable
+        addPostural();
+    }
+
+    void perturb(const unsigned int k)
+    {
+        for(unsigned int i = 0; i < _tasks.size(); ++i)
+        {
+            Eigen::VectorXd b = _tasks[i]->getb();
+            b += 0.01*Eigen::VectorXd::Ones(b.size())*std::sin(0.1*k + i);
+            EXPECT_TRUE(_tasks[i]->setb(b));
+            _tasks[i]->update(Eigen::VectorXd::Zero(_x_size));
+        }
+    }
+};
+
+TEST_F(testwHQP, testSingleQP)
+{
+    std::vector<double> weights = {1e4, 1e2, 1., 1e-2};
+    OpenSoT::solvers::wHQP solver(_stack, _bounds, weights, 0, 1.);
+    EXPECT_EQ(solver.getStrictLevels(), 0);
+    EXPECT_EQ(solver.getiHQP()->getNumberOfTasks(), 1);
+
+    double w;
+    EXPECT_TRUE(solver.getWeight(2, w));
+    EXPECT_DOUBLE_EQ(w, 1.);
+    EXPECT_FALSE(solver.getWeight(4, w));
+    EXPECT_FALSE(solver.setWeight(1, -1.));
+
+    //the flattened QP solved directly by a back-end
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, _x_size, 0, OpenSoT::HST_SEMIDEF, 1.);
+    Eigen::MatrixXd H(_x_size, _x_size), A(0, _x_size);
+    Eigen::VectorXd g(_x_size), lA(0), uA(0);
+
+    Eigen::VectorXd x(_x_size);
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        perturb(k);
+        if(k == 10)
+        {
+            EXPECT_TRUE(solver.setWeight(3, 1.));
+            weights[3] = 1.;
+        }
+
+        EXPECT_TRUE(solver.solve(x));
+
+        H.setZero();
+        g.setZero();
+        for(unsigned int i = 0; i < _stack.size(); ++i)
+        {
+            H += weights[i]*_stack[i]->getA().transpose()*_stack[i]->getA();
+            g -= weights[i]*_stack[i]->getA().transpose()*_stack[i]->getb();
+        }
+        if(k == 0)
+            EXPECT_TRUE(qp->initProblem(H, g, A, lA, uA, _bounds->getLowerBound(), _bounds->getUpperBound()));
+        else
+            EXPECT_TRUE(qp->updateTask(H, g) && qp->solve());
+
+        for(unsigned int i = 0; i < _x_size; ++i)
+            EXPECT_NEAR(x[i], qp->getSolution()[i], 1e-6);
+    }
+}
+
+TEST_F(testwHQP, testStrictLevels)
+{
+    std::vector<double> weights = {1., 1e-2};
+    OpenSoT::solvers::wHQP whqp(_stack, _bounds, weights, 2, 1.);
+    OpenSoT::solvers::iHQP ihqp(_stack, _bounds, 1.);
+    EXPECT_EQ(whqp.getiHQP()->getNumberOfTasks(), 3);
+
+    double w;
+    EXPECT_FALSE(whqp.getWeight(1, w));
+    EXPECT_FALSE(whqp.setWeight(1, 1.));
+
+    Eigen::VectorXd x_whqp(_x_size), x_ihqp(_x_size);
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        perturb(k);
+
+        EXPECT_TRUE(whqp.solve(x_whqp));
+        EXPECT_TRUE(ihqp.solve(x_ihqp));
+
+        //the strict levels reach the same optimum of iHQP
+        for(unsigned int i = 0; i < 2; ++i)
+            EXPECT_NEAR((_stack[i]->getA()*x_whqp - _stack[i]->getb()).norm(),
+                        (_stack[i]->getA()*x_ihqp - _stack[i]->getb()).norm(), 1e-6);
+
+        EXPECT_TRUE(((x_whqp.array() - 0.3) <= 1e-9).all());
+        EXPECT_TRUE(((x_whqp.array() + 0.3) >= -1e-9).all());
+    }
+
+    //all the levels strict: same solution of iHQP
+    OpenSoT::solvers::wHQP strict(_stack, _bounds, std::vector<double>(), _stack.size(), 1.);
+    EXPECT_TRUE(strict.solve(x_whqp));
+    EXPECT_TRUE(ihqp.solve(x_ihqp));
+    for(unsigned int i = 0; i < _x_size; ++i)
+        EXPECT_NEAR(x_whqp[i], x_ihqp[i], 1e-6);
+}
+
+TEST_F(testwHQP, testWrongWeights)
+{
+    EXPECT_THROW(OpenSoT::solvers::wHQP(_stack, _bounds, std::vector<double>(3, 1.), 0, 1.), std::runtime_error);
+    EXPECT_THROW(OpenSoT::solvers::wHQP(_stack, _bounds, std::vector<double>(2, 0.), 2, 1.), std::runtime_error);
+    EXPECT_THROW(OpenSoT::solvers::wHQP(_stack, _bounds, std::vector<double>(), 5, 1.), std::runtime_error);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
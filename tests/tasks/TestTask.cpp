@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <OpenSoT/Task.h>
 #include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
 #include <chrono>
 
 namespace {
@@ -145,6 +146,82 @@ TEST_F(testTask, testDiagonalWeight)
 
 }
 
+TEST_F(testTask, testVersion)
+{
+    Eigen::MatrixXd A(5, 20);
+    A.setRandom();
+    Eigen::VectorXd b(5);
+    b.setRandom();
+
+    fooTask::Ptr footask(new fooTask(A, b));
+    footask->setW(Eigen::MatrixXd::Identity(5,5));
+    footask->update(Eigen::VectorXd::Zero(20));
+
+    unsigned long version = footask->getVersion();
+    unsigned long matrix_version = footask->getMatrixVersion();
+
+    //nothing changed
+    footask->update(Eigen::VectorXd::Zero(20));
+    EXPECT_EQ(footask->getVersion(), version);
+    EXPECT_EQ(footask->getMatrixVersion(), matrix_version);
+
+    //same values
+    footask->setA(A);
+    footask->setb(b);
+    EXPECT_EQ(footask->getVersion(), version);
+    EXPECT_EQ(footask->getMatrixVersion(), matrix_version);
+
+    //b changes the task but not its Hessian
+    b[2] += 1.;
+    footask->setb(b);
+    EXPECT_GT(footask->getVersion(), version);
+    EXPECT_EQ(footask->getMatrixVersion(), matrix_version);
+    version = footask->getVersion();
+
+    //A and W change both
+    A(3,4) += 1.;
+    footask->setA(A);
+    EXPECT_GT(footask->getMatrixVersion(), matrix_version);
+    EXPECT_GT(footask->getVersion(), version);
+    matrix_version = footask->getMatrixVersion();
+    version = footask->getVersion();
+
+    footask->setWeight(2.*Eigen::MatrixXd::Identity(5,5));
+    EXPECT_GT(footask->getMatrixVersion(), matrix_version);
+    matrix_version = footask->getMatrixVersion();
+
+    //masking joints changes A
+    std::vector<bool> mask(20, true);
+    mask[0] = false;
+    footask->setActiveJointsMask(mask);
+    EXPECT_GT(footask->getMatrixVersion(), matrix_version);
+    matrix_version = footask->getMatrixVersion();
+
+    //the mask is applied again by update() but A does not change
+    footask->update(Eigen::VectorXd::Zero(20));
+    EXPECT_EQ(footask->getMatrixVersion(), matrix_version);
+}
+
+TEST_F(testTask, testConstraintVersion)
+{
+    Eigen::VectorXd u(10);
+    u.setConstant(1.);
+
+    //velocity limits are constant: the version changes only when they are set
+    OpenSoT::constraints::GenericConstraint::Ptr bounds(
+        new OpenSoT::constraints::GenericConstraint("bounds", u, -u, 10));
+    unsigned long version = bounds->getVersion();
+    unsigned long matrix_version = bounds->getMatrixVersion();
+    bounds->update(Eigen::VectorXd::Zero(10));
+    EXPECT_EQ(bounds->getVersion(), version);
+
+    u[3] = 2.;
+    bounds->setBounds(u, -u);
+    bounds->update(Eigen::VectorXd::Zero(10));
+    EXPECT_GT(bounds->getVersion(), version);
+    EXPECT_EQ(bounds->getMatrixVersion(), matrix_version);
+}
+
 }
 
 int main(int argc, char **argv) {
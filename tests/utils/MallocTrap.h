@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _OPENSOT_TESTS_MALLOC_TRAP_H_
+#define _OPENSOT_TESTS_MALLOC_TRAP_H_
+
+/**
+ * MallocTrap replaces malloc, calloc and realloc (and therefore new) of the test executable:
+ * when the trap is armed every allocation is counted and the backtrace of the offending call
+ * site is printed on stderr.
+ *
+ * Usage:
+ *
+ *      MallocTrap::arm();
+ *      auto_stack->update(q);
+ *      solver->solve(dq);
+ *      EXPECT_EQ(MallocTrap::disarm(), 0);
+ *
+ * Allocations done inside a function whose (mangled) name contains one of the strings passed
+ * to ignore() are not counted: this permits to check OpenSoT code when a back-end other than
+ * the internal qpOASES is not allocation free.
+ *
+ * NOTE: this header defines the allocation functions, it has to be included in only one
+ * translation unit of the test executable. It relies on glibc (__libc_malloc) and on dladdr,
+ * hence the ignored functions have to be exported (e.g. from a shared library).
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <unistd.h>
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t nmemb, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+class MallocTrap
+{
+public:
+    /**
+     * @brief arm starts to trap allocations
+     */
+    static void arm()
+    {
+        //backtrace() allocates the first time it is called
+        void* buffer[1];
+        backtrace(buffer, 1);
+
+        count() = 0;
+        armed() = true;
+    }
+
+    /**
+     * @brief disarm stops to trap allocations
+     * @return number of allocations since arm()
+     */
+    static unsigned int disarm()
+    {
+        armed() = false;
+        return count();
+    }
+
+    /**
+     * @brief ignore do not count allocations done inside functions whose name contains symbol
+     * @param symbol a string literal (it is not copied)
+     * @return false if too many symbols are ignored
+     */
+    static bool ignore(const char* symbol)
+    {
+        if(ignored_size() >= MAX_IGNORED)
+            return false;
+        ignored()[ignored_size()++] = symbol;
+        return true;
+    }
+
+    static void trap()
+    {
+        if(!armed() || inside())
+            return;
+
+        inside() = true;
+
+        void* buffer[MAX_FRAMES];
+        int size = backtrace(buffer, MAX_FRAMES);
+        if(!isIgnored(buffer, size))
+        {
+            count()++;
+
+            static const char msg[] = "\n[MallocTrap] allocation in real-time section, call site:\n";
+            ssize_t written = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+            (void)written;
+            backtrace_symbols_fd(buffer, size, STDERR_FILENO);
+        }
+
+        inside() = false;
+    }
+
+private:
+    static const int MAX_FRAMES = 64;
+    static const int MAX_IGNORED = 8;
+
+    static bool isIgnored(void** buffer, const int size)
+    {
+        for(int i = 0; i < size; ++i)
+        {
+            Dl_info info;
+            if(dladdr(buffer[i], &info) == 0 || info.dli_sname == NULL)
+                continue;
+            for(int j = 0; j < ignored_size(); ++j)
+            {
+                if(std::strstr(info.dli_sname, ignored()[j]) != NULL)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    static const char** ignored(){static const char* ignored[MAX_IGNORED]; return ignored;}
+    static int& ignored_size(){static int size = 0; return size;}
+    static bool& armed(){static bool armed = false; return armed;}
+    static bool& inside(){static bool inside = false; return inside;}
+    static unsigned int& count(){static unsigned int count = 0; return count;}
+};
+
+extern "C" void* malloc(size_t size) __THROW
+{
+    MallocTrap::trap();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t nmemb, size_t size) __THROW
+{
+    MallocTrap::trap();
+    return __libc_calloc(nmemb, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) __THROW
+{
+    MallocTrap::trap();
+    return __libc_realloc(ptr, size);
+}
+
+#endif
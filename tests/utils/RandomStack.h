@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef _OPENSOT_TESTS_RANDOM_STACK_H_
+#define _OPENSOT_TESTS_RANDOM_STACK_H_
+
+/**
+ * RandomStack builds the stack of GenericTasks with random A and b shared by the solver tests,
+ * bounded by -0.3 <= x <= 0.3. The random numbers are seeded by the constructor: two RandomStacks
+ * with the same sizes have the same tasks.
+ *
+ * Usage, as a base of a test fixture which only adds what the test needs:
+ *
+ *      class testSolver: public ::testing::Test, public RandomStack
+ *      {
+ *      protected:
+ *          testSolver(){ addPostural(); }
+ *      };
+ */
+
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+class RandomStack
+{
+public:
+    typedef OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::Stack Stack;
+
+    /**
+     * @brief RandomStack
+     * @param x_size size of the variable
+     * @param rows number of rows of each task, one task for each level
+     */
+    RandomStack(const unsigned int x_size = 20, const std::vector<int>& rows = std::vector<int>({3, 6, 4})):
+        _x_size(x_size)
+    {
+        std::srand(0);
+        for(unsigned int i = 0; i < rows.size(); ++i)
+        {
+            Eigen::MatrixXd A(rows[i], _x_size);
+            A.setRandom(A.rows(), A.cols());
+            Eigen::VectorXd b(rows[i]);
+            b.setRandom(b.size());
+            OpenSoT::tasks::GenericTask::Ptr task(
+                        new OpenSoT::tasks::GenericTask("task_"+std::to_string(i), A, b));
+            task->update(Eigen::VectorXd::Zero(_x_size));
+            _tasks.push_back(task);
+            _stack.push_back(task);
+        }
+
+        Eigen::VectorXd ub(_x_size);
+        ub.setConstant(_x_size, 0.3);
+        _bounds.reset(new OpenSoT::constraints::GenericConstraint("bounds", ub, -ub, _x_size));
+    }
+
+    /**
+     * @brief addPostural adds a last level which regularizes the whole variable, it is not in _tasks
+     */
+    void addPostural()
+    {
+        OpenSoT::tasks::GenericTask::Ptr postural(
+                    new OpenSoT::tasks::GenericTask("postural", Eigen::MatrixXd::Identity(_x_size, _x_size),
+                                                    Eigen::VectorXd::Zero(_x_size)));
+        postural->update(Eigen::VectorXd::Zero(_x_size));
+        _stack.push_back(postural);
+    }
+
+    unsigned int _x_size;
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> _tasks;
+    Stack _stack;
+    OpenSoT::constraints::GenericConstraint::Ptr _bounds;
+};
+
+#endif
@@ -0,0 +1,185 @@
+#include "MallocTrap.h"
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <utils/RandomStack.h>
+#include <XBotInterface/ModelInterface.h>
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/CoM.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/velocity/VelocityLimits.h>
+#if OPENSOT_TESTS_SELF_COLLISION
+#include <OpenSoT/constraints/velocity/SelfCollisionAvoidance.h>
+#endif
+
+std::string robotology_root = std::getenv("ROBOTOLOGY_ROOT");
+std::string relative_path = "/external/OpenSoT/tests/configs/coman/configs/config_coman_RBDL.yaml";
+std::string _path_to_cfg = robotology_root + relative_path;
+
+namespace {
+
+class testAllocationFree: public ::testing::Test, public RandomStack
+{
+protected:
+
+    testAllocationFree()
+    {
+        Eigen::MatrixXd C(2, _x_size);
+        C.setRandom(C.rows(), C.cols());
+        Eigen::VectorXd uc(2);
+        uc.setConstant(2, 1.);
+        _constraint.reset(new OpenSoT::constraints::GenericConstraint("constraint",
+                                OpenSoT::AffineHelper(C, Eigen::VectorXd::Zero(2)), uc, -uc,
+                                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT));
+
+        Eigen::VectorXd ub2(_x_size);
+        ub2.setConstant(_x_size, 0.5);
+        _bounds2.reset(new OpenSoT::constraints::GenericConstraint("bounds2", ub2, -ub2, _x_size));
+    }
+
+    OpenSoT::constraints::GenericConstraint::Ptr _constraint;
+    OpenSoT::constraints::GenericConstraint::Ptr _bounds2;
+};
+
+TEST_F(testAllocationFree, testSolveLoop)
+{
+    OpenSoT::AutoStack::Ptr auto_stack = (_tasks[0] / (_tasks[1] << _constraint) / _tasks[2]) << _bounds << _bounds2;
+
+    Eigen::VectorXd q(_x_size), dq(_x_size);
+    q.setZero(_x_size);
+    dq.setZero(_x_size);
+
+    auto_stack->update(q);
+    OpenSoT::solvers::iHQP solver(auto_stack->getStack(), auto_stack->getBounds(), 1.);
+    solver.enableTelemetry(10);
+
+    //warm-up tick
+    auto_stack->update(q);
+    EXPECT_TRUE(solver.solve(dq));
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        Eigen::VectorXd b = _tasks[0]->getb();
+        b.array() += 0.01*std::sin(0.1*k);
+        //a new matrix makes qpOASES set up the auxiliary QP again
+        Eigen::MatrixXd A = _tasks[1]->getA();
+        A.row(0).array() += 0.01*std::cos(0.1*k);
+
+        MallocTrap::arm();
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        //OPENSOT_ALLOCATION_FREE build: Eigen allocations fail an assertion at their call site
+        Eigen::internal::set_is_malloc_allowed(false);
+#endif
+        EXPECT_TRUE(_tasks[0]->setb(b));
+        EXPECT_TRUE(_tasks[1]->setA(A));
+        auto_stack->update(q);
+        EXPECT_TRUE(solver.solve(dq));
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        Eigen::internal::set_is_malloc_allowed(true);
+#endif
+        EXPECT_EQ(MallocTrap::disarm(), 0);
+
+        q += dq;
+    }
+}
+
+class testAllocationFreeComan: public ::testing::Test
+{
+protected:
+
+    testAllocationFreeComan()
+    {
+        _model = XBot::ModelInterface::getModel(_path_to_cfg);
+
+        _q.setZero(_model->getJointNum());
+        _model->setJointPosition(_q);
+        _model->update();
+
+        _postural.reset(new OpenSoT::tasks::velocity::Postural(_q));
+        _com.reset(new OpenSoT::tasks::velocity::CoM(_q, *_model));
+        _l_arm.reset(new OpenSoT::tasks::velocity::Cartesian("cartesian::l_arm", _q, *_model,
+                                                             "LSoftHand", "Waist"));
+        _r_arm.reset(new OpenSoT::tasks::velocity::Cartesian("cartesian::r_arm", _q, *_model,
+                                                             "RSoftHand", "Waist"));
+
+        Eigen::VectorXd q_min, q_max;
+        _model->getJointLimits(q_min, q_max);
+        _joint_limits.reset(new OpenSoT::constraints::velocity::JointLimits(_q, q_max, q_min));
+        _velocity_limits.reset(new OpenSoT::constraints::velocity::VelocityLimits(0.5, 1e-3, _q.size()));
+
+#if OPENSOT_TESTS_SELF_COLLISION
+        std::string base_link = "Waist";
+        _self_collision.reset(new OpenSoT::constraints::velocity::SelfCollisionAvoidance(_q, *_model, base_link));
+#endif
+    }
+
+    XBot::ModelInterface::Ptr _model;
+    Eigen::VectorXd _q;
+    OpenSoT::tasks::velocity::Postural::Ptr _postural;
+    OpenSoT::tasks::velocity::CoM::Ptr _com;
+    OpenSoT::tasks::velocity::Cartesian::Ptr _l_arm;
+    OpenSoT::tasks::velocity::Cartesian::Ptr _r_arm;
+    OpenSoT::constraints::velocity::JointLimits::Ptr _joint_limits;
+    OpenSoT::constraints::velocity::VelocityLimits::Ptr _velocity_limits;
+#if OPENSOT_TESTS_SELF_COLLISION
+    OpenSoT::constraints::velocity::SelfCollisionAvoidance::Ptr _self_collision;
+#endif
+};
+
+TEST_F(testAllocationFreeComan, testSolveLoop)
+{
+    OpenSoT::tasks::Aggregated::Ptr arms = _l_arm + _r_arm;
+#if OPENSOT_TESTS_SELF_COLLISION
+    arms = arms << _self_collision;
+#endif
+    OpenSoT::AutoStack::Ptr auto_stack = (_com / arms / _postural) << _joint_limits << _velocity_limits;
+
+    Eigen::VectorXd dq(_q.size());
+    dq.setZero(dq.size());
+
+    auto_stack->update(_q);
+    OpenSoT::solvers::iHQP solver(auto_stack->getStack(), auto_stack->getBounds());
+
+    //warm-up tick
+    auto_stack->update(_q);
+    EXPECT_TRUE(solver.solve(dq));
+
+    //references are moved through preallocated variables, as a real-time loop does
+    Eigen::MatrixXd l_arm_ref = _l_arm->getActualPose();
+    Eigen::MatrixXd r_arm_ref = _r_arm->getActualPose();
+    Eigen::Vector3d com_ref = _com->getActualPosition();
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        //the model is updated by the user before the stack
+        _model->setJointPosition(_q);
+        _model->update();
+
+        MallocTrap::arm();
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        Eigen::internal::set_is_malloc_allowed(false);
+#endif
+        l_arm_ref(2,3) += 1e-4;
+        r_arm_ref(2,3) += 1e-4;
+        com_ref(0) += 1e-5;
+        _l_arm->setReference(l_arm_ref);
+        _r_arm->setReference(r_arm_ref);
+        _com->setReference(com_ref);
+        auto_stack->update(_q);
+        EXPECT_TRUE(solver.solve(dq));
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        Eigen::internal::set_is_malloc_allowed(true);
+#endif
+        EXPECT_EQ(MallocTrap::disarm(), 0);
+
+        _q += dq;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/RingBuffer.h>
+#include <thread>
+
+namespace {
+
+struct Sample
+{
+    unsigned long index;
+    std::vector<double> values;
+};
+
+TEST(testRingBuffer, testReadWrite)
+{
+    Sample prototype;
+    prototype.index = 0;
+    prototype.values.assign(3, 0.);
+
+    OpenSoT::utils::RingBuffer<Sample> buffer(4, prototype);
+    EXPECT_EQ(buffer.getCapacity(), 4);
+    EXPECT_EQ(buffer.getNumberOfWrites(), 0);
+
+    Sample sample = prototype;
+    EXPECT_FALSE(buffer.readLatest(sample));
+    EXPECT_FALSE(buffer.read(0, sample));
+
+    for(unsigned long i = 0; i < 10; ++i)
+    {
+        Sample& data = buffer.beginWrite();
+        data.index = i;
+        data.values.assign(3, double(i));
+        buffer.endWrite();
+
+        EXPECT_EQ(buffer.getNumberOfWrites(), i+1);
+        EXPECT_TRUE(buffer.readLatest(sample));
+        EXPECT_EQ(sample.index, i);
+        EXPECT_DOUBLE_EQ(sample.values[2], double(i));
+    }
+
+    //only the last 4 elements are stored
+    for(unsigned long i = 0; i < 6; ++i)
+        EXPECT_FALSE(buffer.read(i, sample));
+    for(unsigned long i = 6; i < 10; ++i)
+    {
+        EXPECT_TRUE(buffer.read(i, sample));
+        EXPECT_EQ(sample.index, i);
+    }
+    EXPECT_FALSE(buffer.read(10, sample));
+}
+
+TEST(testRingBuffer, testConcurrentReader)
+{
+    Sample prototype;
+    prototype.index = 0;
+    prototype.values.assign(64, 0.);
+
+    OpenSoT::utils::RingBuffer<Sample> buffer(2, prototype);
+
+    const unsigned long writes = 100000;
+    std::atomic<bool> done(false);
+    unsigned long successful_reads = 0;
+    bool consistent = true;
+
+    //a successful read never returns a partially written element, the reader keeps reading
+    //after the last write in case it has not been scheduled while writing
+    std::thread reader([&](){
+        Sample sample = prototype;
+        while(!done || successful_reads == 0)
+        {
+            if(buffer.readLatest(sample))
+            {
+                successful_reads++;
+                for(unsigned int j = 0; j < sample.values.size(); ++j)
+                    consistent = consistent && sample.values[j] == double(sample.index);
+            }
+        }
+    });
+
+    for(unsigned long i = 0; i < writes; ++i)
+    {
+        Sample& data = buffer.beginWrite();
+        data.index = i;
+        for(unsigned int j = 0; j < data.values.size(); ++j)
+            data.values[j] = double(i);
+        buffer.endWrite();
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_GT(successful_reads, 0);
+    EXPECT_EQ(buffer.getNumberOfWrites(), writes);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/WorkerPool.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <utils/RandomStack.h>
+#include <atomic>
+
+namespace {
+
+TEST(testWorkerPool, testAllJobsAreExecutedOnce)
+{
+    for(unsigned int threads = 0; threads < 5; ++threads)
+    {
+        OpenSoT::utils::WorkerPool pool(threads);
+        EXPECT_EQ(pool.getNumberOfThreads(), std::max(threads, 1u));
+
+        for(unsigned int jobs = 0; jobs < 20; ++jobs)
+        {
+            std::vector<std::atomic<int>> counters(jobs);
+            for(auto& c : counters)
+                c = 0;
+
+            pool.run(jobs, [&counters](const unsigned int i){ counters[i]++; });
+
+            for(unsigned int i = 0; i < jobs; ++i)
+                EXPECT_EQ(counters[i], 1);
+        }
+    }
+}
+
+TEST(testWorkerPool, testParallelAssemblyiHQP)
+{
+    RandomStack random(20, {3, 6, 4, 20});
+    const unsigned int x_size = random._x_size;
+    OpenSoT::solvers::iHQP::Stack& stack = random._stack;
+    OpenSoT::constraints::GenericConstraint::Ptr bounds = random._bounds;
+
+    OpenSoT::solvers::iHQP serial(stack, bounds, 1.);
+    OpenSoT::solvers::iHQP parallel(stack, bounds, 1.);
+    EXPECT_EQ(parallel.getParallelAssembly(), 1);
+    parallel.setParallelAssembly(3);
+    EXPECT_EQ(parallel.getParallelAssembly(), 3);
+
+    Eigen::VectorXd x_serial(x_size), x_parallel(x_size);
+    for(unsigned int k = 0; k < 50; ++k)
+    {
+        for(unsigned int i = 0; i < random._tasks.size(); ++i)
+        {
+            OpenSoT::tasks::GenericTask::Ptr task = random._tasks[i];
+            Eigen::VectorXd b = task->getb();
+            b += 0.01*Eigen::VectorXd::Ones(b.size())*std::sin(0.1*k + i);
+            EXPECT_TRUE(task->setb(b));
+            task->update(Eigen::VectorXd::Zero(x_size));
+        }
+
+        parallel.setActiveStack(1, k%2);
+        serial.setActiveStack(1, k%2);
+
+        EXPECT_TRUE(serial.solve(x_serial));
+        EXPECT_TRUE(parallel.solve(x_parallel));
+
+        EXPECT_TRUE(x_serial == x_parallel);
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -5,6 +5,7 @@
 #include <fcl/shape/geometric_shapes.h>
 #include <XBotInterface/ModelInterface.h>
 #include <chrono>
+#include <vector>
 
 #define  s                1.0
 #define  dT               0.001* s
@@ -181,6 +182,12 @@ public:
         return _computeDistance.updateCollisionObjects();
     }
 
+    double boundingSpheresDistance(const fcl::CollisionObject& collObj_shapeA,
+                                   const fcl::CollisionObject& collObj_shapeB)
+    {
+        return ComputeLinksDistance::boundingSpheresDistance(collObj_shapeA, collObj_shapeB);
+    }
+
     bool globalToLinkCoordinates(const std::string& linkName,
                                  const fcl::Transform3f &fcl_w_T_f,
                                  KDL::Frame &link_T_f)
@@ -275,6 +282,131 @@ TEST_F(testCollisionUtils, testDistanceChecksAreInvariant) {
 
 }
 
+TEST_F(testCollisionUtils, testBroadPhase) {
+
+    getGoodInitialPosition(q,_model_ptr);
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    const double detectionThreshold = 0.05;
+
+    // the pairs discarded by the bounding spheres are farther than the threshold
+    std::list<LinkPairDistance> all_results = compute_distance->getLinkDistances();
+    std::list<LinkPairDistance> results = compute_distance->getLinkDistances(detectionThreshold);
+
+    std::list<LinkPairDistance> expected_results;
+    for(std::list<LinkPairDistance>::iterator it = all_results.begin(); it != all_results.end(); ++it)
+    {
+        if(it->getDistance() < detectionThreshold)
+            expected_results.push_back(*it);
+    }
+    EXPECT_LT(results.size(), all_results.size());
+    ASSERT_EQ(results.size(), expected_results.size());
+
+    std::list<LinkPairDistance>::iterator it_expected = expected_results.begin();
+    for(std::list<LinkPairDistance>::iterator it = results.begin(); it != results.end(); ++it, ++it_expected)
+    {
+        EXPECT_EQ(it->getLinkNames(), it_expected->getLinkNames());
+        EXPECT_EQ(it->getDistance(), it_expected->getDistance());
+    }
+
+    // the bounding spheres distance is a lower bound of the distance
+    TestCapsuleLinksDistance compute_distance_observer(*compute_distance);
+    std::map<std::string,boost::shared_ptr<fcl::CollisionObject> > collision_objects_test =
+        compute_distance_observer.getcollision_objects();
+    for(std::list<LinkPairDistance>::iterator it = all_results.begin(); it != all_results.end(); ++it)
+        EXPECT_LE(compute_distance_observer.boundingSpheresDistance(
+                      *collision_objects_test[it->getLinkNames().first],
+                      *collision_objects_test[it->getLinkNames().second]),
+                  it->getDistance() + 1E-8);
+}
+
+TEST_F(testCollisionUtils, testComputeLinkDistances) {
+
+    getGoodInitialPosition(q,_model_ptr);
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    const double detectionThreshold = 0.05;
+
+    // the distances updated in place are the ones of getLinkDistances, not sorted
+    std::list<LinkPairDistance> results = compute_distance->getLinkDistances(detectionThreshold);
+    const std::vector<LinkPairDistance>& distances = compute_distance->computeLinkDistances(detectionThreshold);
+    const LinkPairDistance* first_pair = &distances.front();
+
+    unsigned int close_pairs = 0;
+    for(unsigned int i = 0; i < distances.size(); ++i)
+    {
+        if(distances[i].getDistance() == std::numeric_limits<double>::infinity())
+            continue;
+        ++close_pairs;
+
+        bool found = false;
+        for(std::list<LinkPairDistance>::iterator it = results.begin(); it != results.end(); ++it)
+        {
+            if(it->getLinkNames() == distances[i].getLinkNames())
+            {
+                EXPECT_EQ(it->getDistance(), distances[i].getDistance());
+                EXPECT_EQ(it->getLink_T_closestPoint(), distances[i].getLink_T_closestPoint());
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found);
+    }
+    EXPECT_EQ(close_pairs, results.size());
+    EXPECT_LT(close_pairs, distances.size());
+
+    // the pairs are always the same
+    compute_distance->computeLinkDistances();
+    EXPECT_EQ(first_pair, &distances.front());
+    for(unsigned int i = 0; i < distances.size(); ++i)
+        EXPECT_LT(distances[i].getDistance(), std::numeric_limits<double>::infinity());
+}
+
+TEST_F(testCollisionUtils, testCapsulePairs) {
+
+    std::srand(0);
+    const unsigned int pairs = 100;
+
+    ComputeLinksDistance::CapsulePairs capsule_pairs;
+    capsule_pairs.resize(pairs);
+    EXPECT_EQ(capsule_pairs.size(), pairs);
+
+    std::vector<Eigen::Vector3d> epA1(pairs), epA2(pairs), epB1(pairs), epB2(pairs);
+    for(unsigned int k = 0; k < pairs; ++k)
+    {
+        epA1[k].setRandom(); epA2[k].setRandom();
+        epB1[k].setRandom(); epB2[k].setRandom();
+        // parallel segments and spheres
+        if(k % 5 == 0)
+            epB2[k] = epB1[k] + 0.5*(epA2[k] - epA1[k]);
+        if(k % 7 == 0)
+            epA2[k] = epA1[k];
+
+        capsule_pairs.ep1A.row(k) = epA1[k];
+        capsule_pairs.axisA.row(k) = epA2[k] - epA1[k];
+        capsule_pairs.ep1B.row(k) = epB1[k];
+        capsule_pairs.axisB.row(k) = epB2[k] - epB1[k];
+        capsule_pairs.radiusA[k] = 0.05;
+        capsule_pairs.radiusB[k] = 0.1;
+    }
+
+    capsule_pairs.computeDistances();
+
+    for(unsigned int k = 0; k < pairs; ++k)
+    {
+        Eigen::Vector3d closest_point_A, closest_point_B;
+        double reference_distance = dist3D_Segment_to_Segment(epA1[k], epA2[k], epB1[k], epB2[k],
+                                                              closest_point_A, closest_point_B);
+        EXPECT_NEAR(capsule_pairs.distance[k], reference_distance - 0.15, 1E-8);
+
+        Eigen::Vector3d closestPointA = capsule_pairs.closestPointA.row(k);
+        Eigen::Vector3d closestPointB = capsule_pairs.closestPointB.row(k);
+        if(capsule_pairs.distance[k] > 0.)
+            EXPECT_NEAR((closestPointA - closestPointB).norm(), capsule_pairs.distance[k], 1E-8);
+    }
+}
+
 TEST_F(testCollisionUtils, testCapsuleDistance) {
 
     getGoodInitialPosition(q,_model_ptr);
@@ -399,7 +531,8 @@ TEST_F(testCollisionUtils, testCapsuleDistance) {
         - capsuleB->getRadius();
 
     EXPECT_NEAR(actual_distance, actual_distance_check, 1E-8);
-    EXPECT_NEAR(actual_distance_check, actual_distance_check_original, 1E-8);
+    // the capsules distance is computed in closed form, fcl agrees up to the GJK tolerance
+    EXPECT_NEAR(actual_distance_check, actual_distance_check_original, 1E-4);
     EXPECT_NEAR(reference_distance, reference_distance_check, 1E-8);
     EXPECT_NEAR(actual_distance, reference_distance, 1E-4) << "estimate was " << hand_computed_distance_estimate;
 
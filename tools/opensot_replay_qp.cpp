@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 IIT-ADVR
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU Lesser General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * https://www.gnu.org/licenses/old-licenses/lgpl-2.1.html
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+/**
+ * opensot_replay_qp solves again the problems written by a QPRecorder and compares timing and
+ * solutions with the recorded ones, one line (CSV) for each problem followed by a summary.
+ *
+ * Usage:
+ *
+ *      opensot_replay_qp <recording> [--back-end qpOASES|OSQP|CBC] [--cold] [--tolerance <tol>]
+ *
+ *  --back-end   solves with a different back-end, by default the recorded one is used
+ *  --cold       initializes each problem from scratch, by default a back-end is kept for each level
+ *               and updated as iHQP does, so that hotstarts are replayed
+ *  --tolerance  largest difference with the recorded solution which is not reported as a mismatch
+ */
+
+#include <OpenSoT/solvers/QPRecorder.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <map>
+
+using namespace OpenSoT::solvers;
+
+namespace {
+
+bool parseBackEnd(const std::string& name, solver_back_ends& back_end)
+{
+    if(name == "qpOASES")
+        back_end = solver_back_ends::qpOASES;
+    else if(name == "OSQP")
+        back_end = solver_back_ends::OSQP;
+    else if(name == "CBC")
+        back_end = solver_back_ends::CBC;
+    else
+        return false;
+    return true;
+}
+
+void printUsage()
+{
+    std::printf("Usage: opensot_replay_qp <recording> [--back-end qpOASES|OSQP|CBC] [--cold] [--tolerance <tol>]\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string file_name = argv[1];
+    bool override_back_end = false;
+    solver_back_ends back_end_type = solver_back_ends::qpOASES;
+    bool cold = false;
+    double tolerance = 1e-6;
+    for(int i = 2; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--back-end") == 0 && i+1 < argc)
+        {
+            if(!parseBackEnd(argv[++i], back_end_type))
+            {
+                std::fprintf(stderr, "Unknown back-end %s\n", argv[i]);
+                return 1;
+            }
+            override_back_end = true;
+        }
+        else if(std::strcmp(argv[i], "--cold") == 0)
+            cold = true;
+        else if(std::strcmp(argv[i], "--tolerance") == 0 && i+1 < argc)
+            tolerance = std::atof(argv[++i]);
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    QPRecording::Ptr recording;
+    try{
+        recording.reset(new QPRecording(file_name));
+    }
+    catch(std::exception& e){
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    typedef std::chrono::steady_clock clock;
+
+    //one back-end for each level, as in iHQP
+    std::map<unsigned int, BackEnd::Ptr> back_ends;
+
+    unsigned long failures = 0, mismatches = 0, recorded_failures = 0;
+    double recorded_time = 0., replay_time = 0., max_recorded_time = 0., max_replay_time = 0.;
+
+    std::printf("tick,level,back_end,variables,constraints,recorded_solved,solved,recorded_time,time,solution_error\n");
+
+    QPRecording::Problem problem;
+    for(unsigned long k = 0; k < recording->getNumberOfProblems(); ++k)
+    {
+        recording->read(k, problem);
+
+        const solver_back_ends type = override_back_end ? back_end_type : problem.level_info.back_end;
+        const int n = problem.H.rows();
+        const int m = problem.A.rows();
+
+        BackEnd::Ptr& back_end = back_ends[problem.level_info.level];
+        bool init = cold || !back_end || back_end->getNumVariables() != n;
+
+        double time = 0.;
+        bool solved = false;
+        if(!init)
+        {
+            //same update sequence of iHQP, a change in the number of constraints is handled by the back-end
+            const clock::time_point start = clock::now();
+            solved = back_end->updateTask(problem.H, problem.g) &&
+                     back_end->updateConstraints(problem.A, problem.lA, problem.uA) &&
+                     (problem.l.size() == 0 || back_end->updateBounds(problem.l, problem.u)) &&
+                     back_end->solve();
+            time = std::chrono::duration<double>(clock::now() - start).count();
+        }
+        else
+        {
+            try{
+                back_end = BackEndFactory(type, n, m, problem.level_info.hessian_type,
+                                          problem.level_info.eps_regularisation);
+            }
+            catch(std::exception& e){
+                std::fprintf(stderr, "Can not create back-end %s: %s\n", whichBackEnd(type).c_str(), e.what());
+                return 1;
+            }
+            if(type == problem.level_info.back_end && !problem.options.empty())
+                back_end->readOptions(problem.options.data(), problem.options.size());
+
+            const clock::time_point start = clock::now();
+            solved = back_end->initProblem(problem.H, problem.g, problem.A, problem.lA, problem.uA,
+                                           problem.l, problem.u);
+            time = std::chrono::duration<double>(clock::now() - start).count();
+        }
+
+        double solution_error = -1.;
+        if(solved && problem.solved)
+            solution_error = (back_end->getSolution() - problem.solution).lpNorm<Eigen::Infinity>();
+
+        failures += !solved;
+        recorded_failures += !problem.solved;
+        mismatches += solution_error > tolerance;
+        recorded_time += problem.solve_time;
+        replay_time += time;
+        max_recorded_time = std::max(max_recorded_time, problem.solve_time);
+        max_replay_time = std::max(max_replay_time, time);
+
+        std::printf("%lu,%u,%s,%i,%i,%i,%i,%e,%e,%e\n", problem.tick, problem.level_info.level,
+                    whichBackEnd(type).c_str(), n, m, problem.solved, solved,
+                    problem.solve_time, time, solution_error);
+    }
+
+    const unsigned long problems = recording->getNumberOfProblems();
+    std::fprintf(stderr, "\n%lu problems replayed\n", problems);
+    if(problems > 0)
+    {
+        std::fprintf(stderr, "    failures: %lu (recorded: %lu)\n", failures, recorded_failures);
+        std::fprintf(stderr, "    solutions differing more than %e: %lu\n", tolerance, mismatches);
+        std::fprintf(stderr, "    mean time: %e s (recorded: %e s)\n", replay_time/problems, recorded_time/problems);
+        std::fprintf(stderr, "    max time: %e s (recorded: %e s)\n", max_replay_time, max_recorded_time);
+    }
+
+    return 0;
+}